@@ -109,6 +109,8 @@ namespace fc::api {
     API_METHOD(MpoolPending, std::vector<SignedMessage>, const TipsetKey &)
     API_METHOD(MpoolPushMessage, SignedMessage, const UnsignedMessage &)
 
+    API_METHOD(NetGraphsyncMetrics, std::string)
+
     API_METHOD(PaychVoucherAdd,
                TokenAmount,
                const Address &,
@@ -17,7 +17,8 @@ namespace fc::api {
   Api makeImpl(std::shared_ptr<ChainStore> chain_store,
                std::shared_ptr<WeightCalculator> weight_calculator,
                std::shared_ptr<IpfsDatastore> ipld,
-               std::shared_ptr<KeyStore> key_store) {
+               std::shared_ptr<KeyStore> key_store,
+               std::shared_ptr<Metrics> graphsync_metrics) {
     auto chain_randomness = chain_store->createRandomnessProvider();
     auto minerState = [&](auto &tipset_key,
                           auto &address) -> outcome::result<MinerActorState> {
@@ -48,6 +49,10 @@ namespace fc::api {
         .MpoolPending = {},
         // TODO(turuslan): FIL-165 implement method
         .MpoolPushMessage = {},
+        .NetGraphsyncMetrics = {[graphsync_metrics]()
+                                    -> outcome::result<std::string> {
+          return graphsync_metrics->toPrometheus();
+        }},
         // TODO(turuslan): FIL-165 implement method
         .PaychVoucherAdd = {},
         // TODO(turuslan): FIL-165 implement method
@@ -10,18 +10,21 @@
 #include "blockchain/weight_calculator.hpp"
 #include "storage/chain/chain_store.hpp"
 #include "storage/ipfs/datastore.hpp"
+#include "storage/ipfs/graphsync/metrics.hpp"
 #include "storage/keystore/keystore.hpp"
 
 namespace fc::api {
   using blockchain::weight::WeightCalculator;
   using storage::blockchain::ChainStore;
   using storage::ipfs::IpfsDatastore;
+  using storage::ipfs::graphsync::Metrics;
   using storage::keystore::KeyStore;
 
   Api makeImpl(std::shared_ptr<ChainStore> chain_store,
                std::shared_ptr<WeightCalculator> weight_calculator,
                std::shared_ptr<IpfsDatastore> ipld,
-               std::shared_ptr<KeyStore> key_store);
+               std::shared_ptr<KeyStore> key_store,
+               std::shared_ptr<Metrics> graphsync_metrics);
 }  // namespace fc::api
 
 #endif  // CPP_FILECOIN_CORE_API_MAKE_HPP
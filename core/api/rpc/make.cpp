@@ -38,6 +38,7 @@ namespace fc::api {
     setup(rpc, api.MinerCreateBlock);
     setup(rpc, api.MpoolPending);
     setup(rpc, api.MpoolPushMessage);
+    setup(rpc, api.NetGraphsyncMetrics);
     setup(rpc, api.PaychVoucherAdd);
     setup(rpc, api.StateCall);
     setup(rpc, api.StateGetActor);
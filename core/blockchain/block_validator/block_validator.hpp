@@ -6,6 +6,8 @@
 #ifndef CPP_FILECOIN_CORE_CHAIN_BLOCK_VALIDATOR_HPP
 #define CPP_FILECOIN_CORE_CHAIN_BLOCK_VALIDATOR_HPP
 
+#include <vector>
+
 #include "common/outcome.hpp"
 
 #include "blockchain/block_validator/block_validator_scenarios.hpp"
@@ -30,6 +32,16 @@ namespace fc::blockchain::block_validator {
      */
     virtual outcome::result<void> validateBlock(const BlockHeader &header,
                                                 scenarios::Scenario scenario) const = 0;
+
+    /**
+     * @brief Validate all blocks of tipset
+     * @param headers - blocks with common parents
+     * @param scenario - required validation stages
+     * @return validation result, error of first invalid block
+     */
+    virtual outcome::result<void> validateTipset(
+        const std::vector<BlockHeader> &headers,
+        scenarios::Scenario scenario) const = 0;
   };
 
 }  // namespace fc::blockchain::block_validator
@@ -34,6 +34,11 @@ namespace fc::blockchain::block_validator::scenarios {
                                  Stage::MESSAGE_SIGNATURE_BV4,
                                  Stage::STATE_TREE_BV5};
 
+  /**
+   * Checks of header alone, e.g. for headers downloaded during sync
+   */
+  const Scenario kSyntaxValidation{Stage::SYNTAX_BV0};
+
 }  // namespace fc::blockchain::block_validator::scenarios
 
 #endif
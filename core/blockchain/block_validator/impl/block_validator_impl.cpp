@@ -5,14 +5,24 @@
 
 #include "blockchain/block_validator/impl/block_validator_impl.hpp"
 
+#include <future>
+
+#include <boost/asio/post.hpp>
+
 #include "blockchain/block_validator/impl/consensus_rules.hpp"
 #include "blockchain/block_validator/impl/syntax_rules.hpp"
 #include "codec/cbor/cbor.hpp"
+#include "crypto/secp256k1/impl/secp256k1_recovery.hpp"
+#include "primitives/cid/cid_of_cbor.hpp"
 #include "storage/amt/amt.hpp"
+#include "vm/actor/builtin/account/account_actor.hpp"
+#include "vm/state/impl/state_tree_impl.hpp"
 
 namespace fc::blockchain::block_validator {
   using primitives::address::Protocol;
   using storage::amt::Amt;
+  using vm::actor::builtin::account::AccountActor;
+  using vm::state::StateTreeImpl;
   using MsgMeta = primitives::block::MsgMeta;
   using SignedMessage = vm::message::SignedMessage;
   using UnsignedMessage = vm::message::UnsignedMessage;
@@ -20,6 +30,8 @@ namespace fc::blockchain::block_validator {
   using BlsCryptoPubKey = crypto::bls::PublicKey;
   using SecpCryptoSignature = crypto::secp256k1::Signature;
   using SecpCryptoPubKey = crypto::secp256k1::PublicKey;
+  using SecpVerifyRequest =
+      crypto::secp256k1::CachingSecp256k1Provider::VerifyRequest;
 
   const std::map<scenarios::Stage, BlockValidatorImpl::StageExecutor>
       BlockValidatorImpl::stage_executors_{
@@ -46,6 +58,60 @@ namespace fc::blockchain::block_validator {
     return outcome::success();
   }
 
+  outcome::result<void> BlockValidatorImpl::validateTipset(
+      const std::vector<BlockHeader> &blocks,
+      scenarios::Scenario scenario) const {
+    bool state_tree{false};
+    std::vector<StageExecutor> executors;
+    for (const auto &stage : scenario) {
+      if (stage == Stage::STATE_TREE_BV5) {
+        state_tree = true;
+        continue;
+      }
+      auto executor = stage_executors_.find(stage);
+      if (executor == stage_executors_.end()) {
+        return ValidatorError::UNKNOWN_STAGE;
+      }
+      executors.push_back(executor->second);
+    }
+
+    std::vector<std::future<outcome::result<void>>> results;
+    results.reserve(blocks.size() * executors.size());
+    for (const auto &block : blocks) {
+      for (auto executor : executors) {
+        auto task =
+            std::make_shared<std::packaged_task<outcome::result<void>()>>(
+                [this, executor, &block] {
+                  return std::invoke(executor, this, block);
+                });
+        results.push_back(task->get_future());
+        boost::asio::post(*pool_, [task] { (*task)(); });
+      }
+    }
+    // all tasks must finish before blocks go out of scope
+    for (auto &result : results) {
+      result.wait();
+    }
+    for (auto &result : results) {
+      OUTCOME_TRY(result.get());
+    }
+
+    if (state_tree && !blocks.empty()) {
+      OUTCOME_TRY(parent_tipset, getParentTipset(blocks.front()));
+      OUTCOME_TRY(
+          result,
+          vm_interpreter_->interpret(datastore_, parent_tipset, vm_indices_));
+      for (const auto &block : blocks) {
+        if (!(block.parents == blocks.front().parents
+              && result.state_root == block.parent_state_root
+              && result.message_receipts == block.parent_message_receipts)) {
+          return ValidatorError::INVALID_PARENT_STATE;
+        }
+      }
+    }
+    return outcome::success();
+  }
+
   outcome::result<void> BlockValidatorImpl::syntax(
       const BlockHeader &block) const {
     OUTCOME_TRY(SyntaxRules::parentsCount(block));
@@ -62,8 +128,8 @@ namespace fc::blockchain::block_validator {
       const BlockHeader &block) const {
     OUTCOME_TRY(ConsensusRules::activeMiner(block, power_table_));
     OUTCOME_TRY(parent_tipset, getParentTipset(block));
-    OUTCOME_TRY(ConsensusRules::parentWeight(
-        block, parent_tipset.get(), weight_calculator_));
+    OUTCOME_TRY(
+        ConsensusRules::parentWeight(block, parent_tipset, weight_calculator_));
     OUTCOME_TRY(chain_epoch, epoch_clock_->epochAtTime(clock_->nowUTC()));
     OUTCOME_TRY(ConsensusRules::epoch(block, chain_epoch));
     return outcome::success();
@@ -74,8 +140,14 @@ namespace fc::blockchain::block_validator {
     using SecpPubKey = primitives::address::Secp256k1PublicKeyHash;
     using BlsPubKey = primitives::address::BLSPublicKeyHash;
     using ActorExecHash = primitives::address::ActorExecHash;
+    if (!block.block_sig) {
+      return ValidatorError::UNKNOWN_BLOCK_SIGNATURE;
+    }
     const auto &block_signature = block.block_sig.value();
-    OUTCOME_TRY(block_bytes, codec::cbor::encode(block));
+    // signature covers block encoded without signature
+    auto unsigned_block = block;
+    unsigned_block.block_sig = boost::none;
+    OUTCOME_TRY(block_bytes, codec::cbor::encode(unsigned_block));
     auto validation_result = visit_in_place(
         block.miner.data,
         [](uint64_t) -> outcome::result<void> {
@@ -84,7 +156,7 @@ namespace fc::blockchain::block_validator {
         [](const ActorExecHash &) -> outcome::result<void> {
           return ValidatorError::INVALID_MINER_PUBLIC_KEY;
         },
-        [&block_signature, &block_bytes, *this](
+        [&block_signature, &block_bytes, this](
             const SecpPubKey &public_key) -> outcome::result<void> {
           libp2p::crypto::secp256k1::PublicKey secp_public_key;
           auto secp_signature =
@@ -101,7 +173,7 @@ namespace fc::blockchain::block_validator {
           }
           return ValidatorError::INVALID_BLOCK_SIGNATURE;
         },
-        [&block_signature, &block_bytes, *this](
+        [&block_signature, &block_bytes, this](
             const BlsPubKey &public_key) -> outcome::result<void> {
           auto bls_signature =
               boost::get<crypto::bls::Signature>(block_signature);
@@ -133,6 +205,103 @@ namespace fc::blockchain::block_validator {
 
   outcome::result<void> BlockValidatorImpl::messageSign(
       const BlockHeader &block) const {
+    using BlsPubKey = primitives::address::BLSPublicKeyHash;
+    OUTCOME_TRY(meta, datastore_->getCbor<MsgMeta>(block.messages));
+    std::vector<CID> bls_cids;
+    OUTCOME_TRY(Amt(datastore_, meta.bls_messages)
+                    .visit([&](auto, auto &value) -> outcome::result<void> {
+                      OUTCOME_TRY(cid, codec::cbor::decode<CID>(value));
+                      bls_cids.push_back(std::move(cid));
+                      return outcome::success();
+                    }));
+
+    // BLS messages are signed by key of sender, resolved in parent state
+    auto state_tree =
+        std::make_shared<StateTreeImpl>(datastore_, block.parent_state_root);
+    std::vector<std::vector<uint8_t>> cids_bytes;
+    std::vector<BlsCryptoPubKey> public_keys;
+    cids_bytes.reserve(bls_cids.size());
+    public_keys.reserve(bls_cids.size());
+    for (const auto &cid : bls_cids) {
+      OUTCOME_TRY(message, datastore_->getCbor<UnsignedMessage>(cid));
+      OUTCOME_TRY(key_address,
+                  AccountActor::resolveToKeyAddress(state_tree, message.from));
+      const auto *public_key = boost::get<BlsPubKey>(&key_address.data);
+      if (public_key == nullptr) {
+        return ValidatorError::INVALID_MESSAGE_SIGNATURE;
+      }
+      BlsCryptoPubKey bls_public_key;
+      std::copy_n(
+          public_key->begin(), bls_public_key.size(), bls_public_key.begin());
+      public_keys.push_back(bls_public_key);
+      OUTCOME_TRY(cid_bytes, cid.toBytes());
+      cids_bytes.push_back(std::move(cid_bytes));
+    }
+
+    const auto *aggregate =
+        boost::get<BlsCryptoSignature>(&block.bls_aggregate);
+    if (aggregate == nullptr) {
+      return ValidatorError::INVALID_MESSAGE_SIGNATURE;
+    }
+    std::vector<gsl::span<const uint8_t>> messages(cids_bytes.begin(),
+                                                   cids_bytes.end());
+    OUTCOME_TRY(valid,
+                bls_provider_->verifyAggregateSignature(
+                    messages, public_keys, *aggregate));
+    if (!valid) {
+      return ValidatorError::INVALID_MESSAGE_SIGNATURE;
+    }
+
+    std::vector<SignedMessage> secp_messages;
+    OUTCOME_TRY(Amt(datastore_, meta.secpk_messages)
+                    .visit([&](auto, auto &value) -> outcome::result<void> {
+                      OUTCOME_TRY(cid, codec::cbor::decode<CID>(value));
+                      OUTCOME_TRY(message,
+                                  datastore_->getCbor<SignedMessage>(cid));
+                      secp_messages.push_back(std::move(message));
+                      return outcome::success();
+                    }));
+
+    // secp256k1 sender address is hash of key, key is recovered from
+    // signature and matched with address before signature is verified
+    std::vector<std::vector<uint8_t>> secp_cids_bytes;
+    std::vector<SecpVerifyRequest> requests;
+    secp_cids_bytes.reserve(secp_messages.size());
+    requests.reserve(secp_messages.size());
+    for (const auto &signed_message : secp_messages) {
+      OUTCOME_TRY(key_address,
+                  AccountActor::resolveToKeyAddress(
+                      state_tree, signed_message.message.from));
+      const auto *signature =
+          boost::get<SecpCryptoSignature>(&signed_message.signature);
+      if (key_address.getProtocol() != Protocol::SECP256K1
+          || signature == nullptr) {
+        return ValidatorError::INVALID_MESSAGE_SIGNATURE;
+      }
+      OUTCOME_TRY(cid, getCidOfCbor(signed_message.message));
+      OUTCOME_TRY(cid_bytes, cid.toBytes());
+      secp_cids_bytes.push_back(std::move(cid_bytes));
+      const auto &signed_bytes = secp_cids_bytes.back();
+      boost::optional<SecpCryptoPubKey> public_key;
+      for (const auto &candidate :
+           crypto::secp256k1::recoverPublicKeys(signed_bytes, *signature)) {
+        if (Address::makeSecp256k1(candidate, key_address.network)
+            == key_address) {
+          public_key = candidate;
+          break;
+        }
+      }
+      if (!public_key) {
+        return ValidatorError::INVALID_MESSAGE_SIGNATURE;
+      }
+      requests.push_back({signed_bytes, *signature, *public_key});
+    }
+    OUTCOME_TRY(statuses, secp_provider_->verifyBatch(requests));
+    for (bool status : statuses) {
+      if (!status) {
+        return ValidatorError::INVALID_MESSAGE_SIGNATURE;
+      }
+    }
     return outcome::success();
   }
 
@@ -149,11 +318,14 @@ namespace fc::blockchain::block_validator {
     return ValidatorError::INVALID_PARENT_STATE;
   }
 
-  outcome::result<std::reference_wrapper<BlockValidatorImpl::Tipset>>
+  outcome::result<BlockValidatorImpl::Tipset>
   BlockValidatorImpl::getParentTipset(const BlockHeader &block) const {
-    if (parent_tipset_cache_
-        && parent_tipset_cache_.value().first == block.getCID()) {
-      return parent_tipset_cache_.value().second;
+    {
+      std::lock_guard lock{parent_tipset_mutex_};
+      if (parent_tipset_cache_
+          && parent_tipset_cache_.value().first == block.parents) {
+        return parent_tipset_cache_.value().second;
+      }
     }
     std::vector<BlockHeader> parent_blocks;
     for (const CID &parent_block_cid : block.parents) {
@@ -171,8 +343,9 @@ namespace fc::blockchain::block_validator {
       }
     }
     OUTCOME_TRY(tipset, Tipset::create(parent_blocks));
-    parent_tipset_cache_ = std::make_pair(block.getCID(), std::move(tipset));
-    return parent_tipset_cache_.value().second;
+    std::lock_guard lock{parent_tipset_mutex_};
+    parent_tipset_cache_ = std::make_pair(block.parents, tipset);
+    return std::move(tipset);
   }
 
 }  // namespace fc::blockchain::block_validator
@@ -192,6 +365,8 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::blockchain::block_validator,
       return "Block validation: invalid miner public key";
     case ValidatorError::INVALID_PARENT_STATE:
       return "Block validation: invalid parent state";
+    case ValidatorError::INVALID_MESSAGE_SIGNATURE:
+      return "Block validation: invalid message signature";
   }
   return "Block validation: unknown error";
 }
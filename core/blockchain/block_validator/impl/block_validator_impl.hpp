@@ -9,14 +9,17 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 
+#include <boost/asio/thread_pool.hpp>
+#include <boost/assert.hpp>
 #include <boost/optional.hpp>
-#include <libp2p/crypto/secp256k1_provider.hpp>
 #include "blockchain/block_validator/block_validator.hpp"
 #include "blockchain/weight_calculator.hpp"
 #include "clock/chain_epoch_clock.hpp"
 #include "clock/utc_clock.hpp"
 #include "crypto/bls/bls_provider.hpp"
+#include "crypto/secp256k1/impl/caching_secp256k1_provider.hpp"
 #include "power/power_table.hpp"
 #include "storage/ipfs/datastore.hpp"
 #include "vm/indices/indices.hpp"
@@ -33,10 +36,11 @@ namespace fc::blockchain::block_validator {
     using WeightCalculator = blockchain::weight::WeightCalculator;
     using PowerTable = power::PowerTable;
     using BlsProvider = crypto::bls::BlsProvider;
-    using SecpProvider = libp2p::crypto::secp256k1::Secp256k1Provider;
+    using SecpProvider = crypto::secp256k1::CachingSecp256k1Provider;
     using Interpreter = vm::interpreter::Interpreter;
     using Tipset = primitives::tipset::Tipset;
     using Indices = vm::indices::Indices;
+    using ThreadPool = boost::asio::thread_pool;
 
    public:
     using StageExecutor = outcome::result<void> (BlockValidatorImpl::*)(
@@ -50,7 +54,8 @@ namespace fc::blockchain::block_validator {
                        std::shared_ptr<BlsProvider> bls_crypto_provider,
                        std::shared_ptr<SecpProvider> secp_crypto_provider,
                        std::shared_ptr<Interpreter> vm_interpreter,
-                       std::shared_ptr<Indices> indices)
+                       std::shared_ptr<Indices> indices,
+                       std::shared_ptr<ThreadPool> pool)
         : datastore_{std::move(ipfs_store)},
           clock_{std::move(utc_clock)},
           epoch_clock_{std::move(epoch_clock)},
@@ -59,11 +64,23 @@ namespace fc::blockchain::block_validator {
           bls_provider_{std::move(bls_crypto_provider)},
           secp_provider_{std::move(secp_crypto_provider)},
           vm_interpreter_{std::move(vm_interpreter)},
-          vm_indices_{std::move(indices)} {}
+          vm_indices_{std::move(indices)},
+          pool_{std::move(pool)} {
+      BOOST_ASSERT(pool_ != nullptr);
+    }
 
     outcome::result<void> validateBlock(
         const BlockHeader &header, scenarios::Scenario scenario) const override;
 
+    /**
+     * Stages of all blocks except state tree run concurrently on worker pool,
+     * state tree of common parent tipset is computed once afterwards.
+     * Must not be called from a task of the same pool
+     */
+    outcome::result<void> validateTipset(
+        const std::vector<BlockHeader> &headers,
+        scenarios::Scenario scenario) const override;
+
    private:
     const static std::map<scenarios::Stage, StageExecutor> stage_executors_;
 
@@ -76,13 +93,15 @@ namespace fc::blockchain::block_validator {
     std::shared_ptr<SecpProvider> secp_provider_;
     std::shared_ptr<Interpreter> vm_interpreter_;
     std::shared_ptr<Indices> vm_indices_;
+    std::shared_ptr<ThreadPool> pool_;
 
     /**
-     * BlockHeader CID -> Parent tipset
-     * Assuming that block validation executes sequentially,
-     * so for several blocks parent tipset will be the same
+     * Parent tipset key -> Parent tipset
+     * Blocks of one tipset share parents, so parent tipset will be the same
      */
-    mutable boost::optional<std::pair<CID, Tipset>> parent_tipset_cache_;
+    mutable boost::optional<std::pair<std::vector<CID>, Tipset>>
+        parent_tipset_cache_;
+    mutable std::mutex parent_tipset_mutex_;
 
     /**
      * @brief Check block syntax
@@ -138,8 +157,7 @@ namespace fc::blockchain::block_validator {
      * @param header - selected block
      * @return operation result
      */
-    outcome::result<std::reference_wrapper<Tipset>> getParentTipset(
-        const BlockHeader &header) const;
+    outcome::result<Tipset> getParentTipset(const BlockHeader &header) const;
   };
 
   enum class ValidatorError {
@@ -148,6 +166,7 @@ namespace fc::blockchain::block_validator {
     INVALID_BLOCK_SIGNATURE,
     INVALID_MINER_PUBLIC_KEY,
     INVALID_PARENT_STATE,
+    INVALID_MESSAGE_SIGNATURE,
   };
 
 }  // namespace fc::blockchain::block_validator
@@ -0,0 +1,37 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_BLOCKCHAIN_HEADER_FETCHER_HPP
+#define CPP_FILECOIN_CORE_BLOCKCHAIN_HEADER_FETCHER_HPP
+
+#include <vector>
+
+#include "common/outcome.hpp"
+#include "primitives/tipset/tipset.hpp"
+#include "primitives/tipset/tipset_key.hpp"
+
+namespace fc::blockchain {
+
+  /** @brief fetches chain headers from network peers */
+  class HeaderFetcher {
+   public:
+    using Tipset = primitives::tipset::Tipset;
+    using TipsetKey = primitives::tipset::TipsetKey;
+
+    virtual ~HeaderFetcher() = default;
+
+    /**
+     * @brief fetches tipset and its ancestors
+     * @param head key of newest tipset to fetch
+     * @param count max number of tipsets to fetch
+     * @return tipsets from head going back to parents, may be fewer than
+     * count
+     */
+    virtual outcome::result<std::vector<Tipset>> getTipsets(
+        const TipsetKey &head, size_t count) = 0;
+  };
+}  // namespace fc::blockchain
+
+#endif  // CPP_FILECOIN_CORE_BLOCKCHAIN_HEADER_FETCHER_HPP
@@ -0,0 +1,126 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/impl/header_syncer.hpp"
+
+#include <algorithm>
+#include <future>
+
+#include <boost/asio/post.hpp>
+
+namespace fc::blockchain::sync_manager {
+  using block_validator::scenarios::kSyntaxValidation;
+  using primitives::tipset::Tipset;
+
+  HeaderSyncer::HeaderSyncer(std::shared_ptr<HeaderFetcher> fetcher,
+                             std::shared_ptr<ChainStore> chain_store,
+                             std::shared_ptr<BlockValidator> validator,
+                             size_t batch_size,
+                             size_t workers)
+      : fetcher_{std::move(fetcher)},
+        chain_store_{std::move(chain_store)},
+        validator_{std::move(validator)},
+        batch_size_{std::max<size_t>(1, batch_size)},
+        pool_{std::make_unique<boost::asio::thread_pool>(
+            std::max<size_t>(1, workers))},
+        logger_{common::createLogger("HeaderSyncer")} {}
+
+  HeaderSyncer::~HeaderSyncer() {
+    pool_->join();
+  }
+
+  outcome::result<void> HeaderSyncer::syncHeaders(const Tipset &target) {
+    OUTCOME_TRY(chain, collectHeaders(target));
+    if (chain.empty()) {
+      return outcome::success();
+    }
+    OUTCOME_TRY(validateSyntax(chain));
+    logger_->info("Adding {} tipsets from height {} to {}",
+                  chain.size(),
+                  chain.front().height,
+                  chain.back().height);
+    return chain_store_->addTipsets(chain);
+  }
+
+  outcome::result<std::vector<Tipset>> HeaderSyncer::collectHeaders(
+      const Tipset &target) {
+    std::vector<Tipset> chain;
+    OUTCOME_TRY(target_key, target.makeKey());
+    if (isKnown(target_key)) {
+      return chain;
+    }
+    chain.push_back(target);
+    while (chain.back().height != 0) {
+      OUTCOME_TRY(parents, chain.back().getParents());
+      if (isKnown(parents)) {
+        break;
+      }
+      OUTCOME_TRY(batch, fetcher_->getTipsets(parents, batch_size_));
+      if (batch.empty()) {
+        return HeaderSyncerError::NO_HEADERS;
+      }
+      for (auto &tipset : batch) {
+        OUTCOME_TRY(key, tipset.makeKey());
+        if (key != parents) {
+          return HeaderSyncerError::UNLINKED_HEADERS;
+        }
+        chain.push_back(std::move(tipset));
+        if (chain.back().height == 0) {
+          break;
+        }
+        OUTCOME_TRY(next_parents, chain.back().getParents());
+        parents = std::move(next_parents);
+        // rest of batch may be already known after fork point
+        if (isKnown(parents)) {
+          break;
+        }
+      }
+    }
+    std::reverse(chain.begin(), chain.end());
+    return std::move(chain);
+  }
+
+  outcome::result<void> HeaderSyncer::validateSyntax(
+      const std::vector<Tipset> &chain) const {
+    std::vector<std::future<outcome::result<void>>> results;
+    for (const auto &tipset : chain) {
+      for (const auto &block : tipset.blks) {
+        auto task =
+            std::make_shared<std::packaged_task<outcome::result<void>()>>(
+                [this, &block] {
+                  return validator_->validateBlock(block, kSyntaxValidation);
+                });
+        results.push_back(task->get_future());
+        boost::asio::post(*pool_, [task] { (*task)(); });
+      }
+    }
+    // all tasks must finish before chain goes out of scope
+    for (auto &result : results) {
+      result.wait();
+    }
+    for (auto &result : results) {
+      OUTCOME_TRY(result.get());
+    }
+    return outcome::success();
+  }
+
+  bool HeaderSyncer::isKnown(const TipsetKey &key) const {
+    return chain_store_->loadTipset(key).has_value();
+  }
+
+}  // namespace fc::blockchain::sync_manager
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::blockchain::sync_manager,
+                            HeaderSyncerError,
+                            e) {
+  using Error = fc::blockchain::sync_manager::HeaderSyncerError;
+  switch (e) {
+    case Error::NO_HEADERS:
+      return "HeaderSyncer: peer returned no headers";
+    case Error::UNLINKED_HEADERS:
+      return "HeaderSyncer: fetched tipset is not parent of previous one";
+  }
+  return "HeaderSyncer: unknown error";
+}
@@ -0,0 +1,74 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_BLOCKCHAIN_IMPL_HEADER_SYNCER_HPP
+#define CPP_FILECOIN_CORE_BLOCKCHAIN_IMPL_HEADER_SYNCER_HPP
+
+#include <memory>
+#include <thread>
+
+#include <boost/asio/thread_pool.hpp>
+#include "blockchain/block_validator/block_validator.hpp"
+#include "blockchain/header_fetcher.hpp"
+#include "common/logger.hpp"
+#include "storage/chain/chain_store.hpp"
+
+namespace fc::blockchain::sync_manager {
+
+  enum class HeaderSyncerError { NO_HEADERS = 1, UNLINKED_HEADERS };
+
+  /**
+   * @class HeaderSyncer downloads headers from sync target back to known chain
+   * in large batches, validates their syntax in parallel and adds them to
+   * chain store at once
+   */
+  class HeaderSyncer {
+   public:
+    using BlockValidator = block_validator::BlockValidator;
+    using ChainStore = storage::blockchain::ChainStore;
+    using Tipset = primitives::tipset::Tipset;
+    using TipsetKey = primitives::tipset::TipsetKey;
+
+    /// Tipsets requested from fetcher at once
+    static constexpr size_t kDefaultBatchSize = 500;
+
+    HeaderSyncer(std::shared_ptr<HeaderFetcher> fetcher,
+                 std::shared_ptr<ChainStore> chain_store,
+                 std::shared_ptr<BlockValidator> validator,
+                 size_t batch_size = kDefaultBatchSize,
+                 size_t workers = std::thread::hardware_concurrency());
+
+    ~HeaderSyncer();
+
+    /**
+     * @brief adds headers of chain ending with target to chain store, can be
+     * used as sync function of sync manager
+     * @param target tipset to sync to
+     */
+    outcome::result<void> syncHeaders(const Tipset &target);
+
+   private:
+    /** @brief fetches tipsets missing in chain store, oldest first */
+    outcome::result<std::vector<Tipset>> collectHeaders(const Tipset &target);
+
+    /** @brief validates syntax of all headers of chain in parallel */
+    outcome::result<void> validateSyntax(
+        const std::vector<Tipset> &chain) const;
+
+    bool isKnown(const TipsetKey &key) const;
+
+    std::shared_ptr<HeaderFetcher> fetcher_;
+    std::shared_ptr<ChainStore> chain_store_;
+    std::shared_ptr<BlockValidator> validator_;
+    size_t batch_size_;
+    std::unique_ptr<boost::asio::thread_pool> pool_;
+    common::Logger logger_;
+  };
+
+}  // namespace fc::blockchain::sync_manager
+
+OUTCOME_HPP_DECLARE_ERROR(fc::blockchain::sync_manager, HeaderSyncerError);
+
+#endif  // CPP_FILECOIN_CORE_BLOCKCHAIN_IMPL_HEADER_SYNCER_HPP
@@ -8,54 +8,50 @@
 namespace fc::blockchain::sync_manager {
   using Tipset = primitives::tipset::Tipset;
 
-  SyncBucketSet::SyncBucketSet(gsl::span<const Tipset> tipsets) {
-    if (tipsets.empty()) {
-      return;
-    }
-
-    SyncTargetBucket b;
-    b.tipsets.resize(tipsets.size());
-    for (auto &t : tipsets) {
-      b.tipsets.push_back(t);
-    }
-    buckets_.push_back(std::move(b));
-  }
-
-  SyncBucketSet::SyncBucketSet(std::vector<Tipset> tipsets) {
+  outcome::result<SyncBucketSet> SyncBucketSet::create(
+      const std::vector<Tipset> &tipsets) {
+    SyncBucketSet set;
     if (!tipsets.empty()) {
-      buckets_.emplace_back(SyncTargetBucket{std::move(tipsets)});
+      OUTCOME_TRY(bucket, SyncTargetBucket::create(tipsets));
+      set.append(std::move(bucket));
     }
+    return std::move(set);
   }
 
   outcome::result<bool> SyncBucketSet::isRelatedToAny(const Tipset &ts) const {
-    for (auto &b : buckets_) {
-      OUTCOME_TRY(res, b.isSameChain(ts));
-      if (res) {
-        return true;
-      }
-    }
-
-    return false;
+    OUTCOME_TRY(related, findRelated(ts));
+    return related.has_value();
   }
 
-  void SyncBucketSet::insert(Tipset ts) {
-    for (auto &b : buckets_)
-      if (b.isSameChain(ts)) {
-        return b.addTipset(ts);
-      }
-
-    buckets_.emplace_back(SyncTargetBucket{{ts}});
+  outcome::result<void> SyncBucketSet::insert(const Tipset &ts) {
+    OUTCOME_TRY(related, findRelated(ts));
+    if (!related) {
+      OUTCOME_TRY(bucket, SyncTargetBucket::create({ts}));
+      append(std::move(bucket));
+      return outcome::success();
+    }
+    auto &bucket = buckets_[*related];
+    OUTCOME_TRY(key, ts.makeKey());
+    if (bucket.getKeys().count(key) != 0) {
+      return outcome::success();
+    }
+    OUTCOME_TRY(parents_key, ts.getParents());
+    OUTCOME_TRY(bucket.addTipset(ts));
+    keys_.emplace(std::move(key), *related);
+    parents_.emplace(std::move(parents_key), *related);
+    return outcome::success();
   }
 
   void SyncBucketSet::append(SyncTargetBucket bucket) {
     buckets_.push_back(std::move(bucket));
+    index(buckets_.size() - 1);
   }
 
   boost::optional<SyncTargetBucket> SyncBucketSet::pop() {
-    boost::optional<SyncTargetBucket> best_bucket;
+    boost::optional<size_t> best_bucket;
     boost::optional<Tipset> best_tipset;
-    for (auto &b : buckets_) {
-      auto heaviest = b.getHeaviestTipset();
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+      auto heaviest = buckets_[i].getHeaviestTipset();
       if (boost::none == heaviest) {
         continue;
       }
@@ -63,40 +59,78 @@ namespace fc::blockchain::sync_manager {
       if (!best_bucket.is_initialized()
           || best_tipset->getParentWeight()
                  < heaviest->getParentWeight()) {
-        best_bucket = b;
+        best_bucket = i;
         best_tipset = heaviest;
       }
     }
 
-    if (boost::none != best_bucket) {
-      removeBucket(*best_bucket);
+    if (boost::none == best_bucket) {
+      return boost::none;
     }
-
-    return best_bucket;
+    auto bucket = std::move(buckets_[*best_bucket]);
+    buckets_.erase(buckets_.begin() + *best_bucket);
+    reindex();
+    return bucket;
   }
 
   void SyncBucketSet::removeBucket(const SyncTargetBucket &b) {
     auto end = std::remove_if(buckets_.begin(),
                               buckets_.end(),
                               [&](const auto &item) { return item == b; });
+    if (end == buckets_.end()) {
+      return;
+    }
     buckets_.erase(end, buckets_.end());
+    reindex();
   }
 
   outcome::result<boost::optional<SyncTargetBucket>> SyncBucketSet::popRelated(
       const Tipset &ts) {
-    for (auto &b : buckets_) {
-      OUTCOME_TRY(res, b.isSameChain(ts));
-      if (!res) {
-        continue;
-      }
+    OUTCOME_TRY(related, findRelated(ts));
+    if (!related) {
+      return boost::none;
+    }
+    auto bucket = std::move(buckets_[*related]);
+    buckets_.erase(buckets_.begin() + *related);
+    reindex();
+    return std::move(bucket);
+  }
 
-      auto bucket = b;
-      removeBucket(b);
+  outcome::result<boost::optional<size_t>> SyncBucketSet::findRelated(
+      const Tipset &ts) const {
+    OUTCOME_TRY(key, ts.makeKey());
+    OUTCOME_TRY(parents_key, ts.getParents());
+    boost::optional<size_t> first;
+    auto find = [&first](const auto &index, const TipsetKey &key) {
+      auto range = index.equal_range(key);
+      for (auto it = range.first; it != range.second; ++it) {
+        if (!first || it->second < *first) {
+          first = it->second;
+        }
+      }
+    };
+    // same tipset, its child or its parent
+    find(keys_, key);
+    find(parents_, key);
+    find(keys_, parents_key);
+    return first;
+  }
 
-      return bucket;
+  void SyncBucketSet::index(size_t bucket) {
+    for (auto &key : buckets_[bucket].getKeys()) {
+      keys_.emplace(key, bucket);
     }
+    for (auto &key : buckets_[bucket].getParentKeys()) {
+      parents_.emplace(key, bucket);
+    }
+  }
 
-    return boost::none;
+  void SyncBucketSet::reindex() {
+    keys_.clear();
+    parents_.clear();
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+      index(i);
+    }
   }
 
   outcome::result<Tipset> SyncBucketSet::getHeaviestTipset() const {
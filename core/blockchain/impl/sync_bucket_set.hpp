@@ -6,6 +6,8 @@
 #ifndef CPP_FILECOIN_CORE_BLOCKCHAIN_IMPL_SYNC_BUCKET_SET_HPP
 #define CPP_FILECOIN_CORE_BLOCKCHAIN_IMPL_SYNC_BUCKET_SET_HPP
 
+#include <unordered_map>
+
 #include "blockchain/impl/sync_target_bucket.hpp"
 #include "common/outcome.hpp"
 
@@ -13,20 +15,29 @@ namespace fc::blockchain::sync_manager {
 
   enum class SyncBucketSetError { BUCKET_NOT_FOUND = 1 };
 
-  /** @brief keeps and updates set of chains */
+  /**
+   * @brief keeps and updates set of chains, buckets are indexed by keys and
+   * parent keys of their tipsets
+   */
   class SyncBucketSet {
    public:
     using Tipset = primitives::tipset::Tipset;
+    using TipsetKey = primitives::tipset::TipsetKey;
+
+    SyncBucketSet() = default;
 
-    /** @brief constructors */
-    explicit SyncBucketSet(gsl::span<const Tipset> tipsets);
-    explicit SyncBucketSet(std::vector<Tipset> tipsets);
+    /**
+     * @brief creates set with one bucket of tipsets, or empty set if there
+     * are no tipsets
+     */
+    static outcome::result<SyncBucketSet> create(
+        const std::vector<Tipset> &tipsets);
 
     /** @brief checks if tipset is related to one of chains */
     outcome::result<bool> isRelatedToAny(const Tipset &ts) const;
 
     /** @brief insert tipset */
-    void insert(Tipset ts);
+    outcome::result<void> insert(const Tipset &ts);
 
     /** @brief appends bucket */
     void append(SyncTargetBucket bucket);
@@ -51,7 +62,21 @@ namespace fc::blockchain::sync_manager {
     size_t getSize() const;
 
    protected:
+    /** @brief finds first bucket related to tipset */
+    outcome::result<boost::optional<size_t>> findRelated(
+        const Tipset &ts) const;
+
+    /** @brief adds keys of bucket tipsets to indexes */
+    void index(size_t bucket);
+
+    /** @brief rebuilds indexes after buckets were removed */
+    void reindex();
+
     std::vector<SyncTargetBucket> buckets_;
+    /// tipset key -> buckets containing tipset
+    std::unordered_multimap<TipsetKey, size_t> keys_;
+    /// parents key -> buckets containing child of parents
+    std::unordered_multimap<TipsetKey, size_t> parents_;
   };
 }  // namespace fc::blockchain::sync_manager
 
@@ -48,10 +48,11 @@ namespace fc::blockchain::sync_manager {
   }
 
   outcome::result<SyncManagerImpl::Tipset> SyncManagerImpl::selectSyncTarget() {
-    SyncBucketSet buckets(std::vector<Tipset>{});
-    std::vector<Tipset> peer_heads;
+    SyncBucketSet buckets;
+    std::vector<std::reference_wrapper<const Tipset>> peer_heads;
+    peer_heads.reserve(peer_heads_.size());
     for (auto &[_, ts] : peer_heads_) {
-      peer_heads.push_back(ts);
+      peer_heads.emplace_back(ts);
     }
 
     std::sort(peer_heads.begin(),
@@ -60,7 +61,7 @@ namespace fc::blockchain::sync_manager {
                 return l.height < r.height;
               });
     for (auto &ts : peer_heads) {
-      buckets.insert(ts);
+      OUTCOME_TRY(buckets.insert(ts));
     }
 
     if (buckets.getSize() > 1) {
@@ -127,33 +128,34 @@ namespace fc::blockchain::sync_manager {
       sync_targets_.push_back(tipset);
     }
 
-    bool is_related_to_active_sync = false;
-    for (auto &[_, acts] : active_syncs_) {
-      if (tipset == acts) break;
-      OUTCOME_TRY(parents, tipset.getParents());
-      OUTCOME_TRY(key, acts.makeKey());
-      if (parents == key) {
-        is_related_to_active_sync = true;
-        break;
-      }
+    // active syncs are keyed by tipset key, so child of active sync is found
+    // by its parents key
+    OUTCOME_TRY(key, tipset.makeKey());
+    OUTCOME_TRY(parents, tipset.getParents());
+    bool is_related_to_active_sync =
+        active_syncs_.find(key) == active_syncs_.end()
+        && active_syncs_.find(parents) != active_syncs_.end();
+    if (!is_related_to_active_sync) {
+      OUTCOME_TRY(is_related_to_ast, active_sync_tips_.isRelatedToAny(tipset));
+      is_related_to_active_sync = is_related_to_ast;
     }
-    OUTCOME_TRY(is_related_to_ast, active_sync_tips_.isRelatedToAny(tipset));
-    is_related_to_active_sync |= is_related_to_ast;
     if (is_related_to_active_sync) {
-      active_sync_tips_.insert(tipset);
-      return outcome::success();
+      return active_sync_tips_.insert(tipset);
     }
 
     if (getBootstrapState() == BootstrapState::STATE_SCHEDULED) {
-      sync_queue_.insert(tipset);
-      return outcome::success();
+      return sync_queue_.insert(tipset);
     }
 
-    if (boost::none != next_sync_target_
-        && next_sync_target_->isSameChain(tipset)) {
-      next_sync_target_->addTipset(tipset);
+    bool is_next_target_chain = false;
+    if (boost::none != next_sync_target_) {
+      OUTCOME_TRY(same_chain, next_sync_target_->isSameChain(tipset));
+      is_next_target_chain = same_chain;
+    }
+    if (is_next_target_chain) {
+      OUTCOME_TRY(next_sync_target_->addTipset(tipset));
     } else {
-      sync_queue_.insert(tipset);
+      OUTCOME_TRY(sync_queue_.insert(tipset));
       if (boost::none == next_sync_target_) {
         next_sync_target_ = sync_queue_.pop();
         auto heaviest_tipset = next_sync_target_->getHeaviestTipset();
@@ -71,8 +71,8 @@ namespace fc::blockchain::sync_manager {
     std::deque<Tipset> incoming_tipsets_;
     std::unordered_map<TipsetKey, Tipset> active_syncs_;
     boost::optional<SyncTargetBucket> next_sync_target_;
-    SyncBucketSet sync_queue_{gsl::span<Tipset>{}};
-    SyncBucketSet active_sync_tips_{gsl::span<Tipset>{}};
+    SyncBucketSet sync_queue_;
+    SyncBucketSet active_sync_tips_;
     SyncFunction sync_function_;
     common::Logger logger_;
   };
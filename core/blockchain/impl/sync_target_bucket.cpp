@@ -8,54 +8,48 @@
 namespace fc::blockchain::sync_manager {
   using Tipset = primitives::tipset::Tipset;
 
-  outcome::result<bool> SyncTargetBucket::isSameChain(const Tipset &ts) const {
-    for (auto &t : tipsets) {
-      OUTCOME_TRY(ts_key, ts.makeKey());
-      OUTCOME_TRY(t_key, t.makeKey());
-      OUTCOME_TRY(t_parents_key, t.getParents());
-      OUTCOME_TRY(ts_parents_key, t.getParents());
-
-      if (t == ts) {
-        return true;
-      }
-
-      if (ts_key == t_parents_key) {
-        return true;
-      }
+  outcome::result<SyncTargetBucket> SyncTargetBucket::create(
+      const std::vector<Tipset> &tipsets) {
+    SyncTargetBucket bucket;
+    for (const auto &ts : tipsets) {
+      OUTCOME_TRY(bucket.addTipset(ts));
+    }
+    return std::move(bucket);
+  }
 
-      if (ts_parents_key == t_key) {
-        return true;
-      }
+  outcome::result<bool> SyncTargetBucket::isSameChain(const Tipset &ts) const {
+    OUTCOME_TRY(ts_key, ts.makeKey());
+    if (keys_.count(ts_key) != 0 || parents_.count(ts_key) != 0) {
+      return true;
     }
-    return false;
+    OUTCOME_TRY(ts_parents_key, ts.getParents());
+    return keys_.count(ts_parents_key) != 0;
   }
 
-  void SyncTargetBucket::addTipset(const Tipset &ts) {
-    for (auto &t : tipsets) {
-      if (t == ts) return;
+  outcome::result<void> SyncTargetBucket::addTipset(const Tipset &ts) {
+    OUTCOME_TRY(key, ts.makeKey());
+    if (keys_.count(key) != 0) {
+      return outcome::success();
     }
-    tipsets.push_back(ts);
+    OUTCOME_TRY(parents_key, ts.getParents());
+    keys_.insert(std::move(key));
+    parents_.insert(std::move(parents_key));
+    tipsets_.push_back(ts);
+    if (tipsets_[heaviest_].getParentWeight() < ts.getParentWeight()) {
+      heaviest_ = tipsets_.size() - 1;
+    }
+    return outcome::success();
   }
 
   boost::optional<Tipset> SyncTargetBucket::getHeaviestTipset() const {
-    boost::optional<Tipset> best_tipset;
-
-    if (tipsets.empty()) {
+    if (tipsets_.empty()) {
       return boost::none;
     }
-
-    for (auto &ts : tipsets) {
-      if (best_tipset == boost::none
-          || ts.getParentWeight() > best_tipset->getParentWeight()) {
-        best_tipset = ts;
-      }
-    }
-
-    return *best_tipset;
+    return tipsets_[heaviest_];
   }
 
   bool operator==(const SyncTargetBucket &lhs, const SyncTargetBucket &rhs) {
-    return lhs.tipsets == rhs.tipsets;
+    return lhs.getTipsets() == rhs.getTipsets();
   }
 
 }  // namespace fc::blockchain::sync_manager
@@ -6,7 +6,7 @@
 #ifndef CPP_FILECOIN_CORE_BLOCKCHAIN_IMPL_SYNC_TARGET_BUCKET_HPP
 #define CPP_FILECOIN_CORE_BLOCKCHAIN_IMPL_SYNC_TARGET_BUCKET_HPP
 
-#include "blockchain/impl/sync_target_bucket.hpp"
+#include <unordered_set>
 
 #include "common/outcome.hpp"
 #include "primitives/block/block.hpp"
@@ -18,24 +18,62 @@ namespace fc::blockchain::sync_manager {
     BUCKET_IS_EMPTY = 1,
   };
 
-  /** @struct SyncTargetBucket stores bucket of tipsets for synchronization */
-  struct SyncTargetBucket {
+  /**
+   * @class SyncTargetBucket stores bucket of tipsets for synchronization,
+   * tipsets are indexed by own and parent keys, so relatedness checks do not
+   * depend on bucket size
+   */
+  class SyncTargetBucket {
+   public:
     using Tipset = primitives::tipset::Tipset;
-    std::vector<Tipset> tipsets;
+    using TipsetKey = primitives::tipset::TipsetKey;
+
+    SyncTargetBucket() = default;
+
+    /**
+     * @brief creates bucket of tipsets
+     * @return bucket or error if key of some tipset cannot be made
+     */
+    static outcome::result<SyncTargetBucket> create(
+        const std::vector<Tipset> &tipsets);
 
     /** @brief returns tipsets count */
     size_t getSize() const {
-      return tipsets.size();
+      return tipsets_.size();
+    }
+
+    /** @brief returns tipsets in order of addition */
+    const std::vector<Tipset> &getTipsets() const {
+      return tipsets_;
+    }
+
+    /** @brief returns keys of tipsets */
+    const std::unordered_set<TipsetKey> &getKeys() const {
+      return keys_;
+    }
+
+    /** @brief returns keys of tipsets parents */
+    const std::unordered_set<TipsetKey> &getParentKeys() const {
+      return parents_;
     }
 
     /** @brief checks if tipset `ts` belongs to same chain */
     outcome::result<bool> isSameChain(const Tipset &ts) const;
 
     /** @brief add tipset to the bucket */
-    void addTipset(const Tipset &ts);
+    outcome::result<void> addTipset(const Tipset &ts);
 
     /** @brief finds and returns heaviest tipset */
     boost::optional<Tipset> getHeaviestTipset() const;
+
+   private:
+    std::vector<Tipset> tipsets_;
+    /// keys of tipsets
+    std::unordered_set<TipsetKey> keys_;
+    /// keys of tipsets parents
+    std::unordered_set<TipsetKey> parents_;
+    /// position of tipset with greatest parent weight
+    size_t heaviest_{};
   };
 
   bool operator==(const SyncTargetBucket &lhs, const SyncTargetBucket &rhs);
@@ -5,6 +5,7 @@
 
 #include "blockchain/impl/weight_calculator_impl.hpp"
 
+#include "codec/cbor/cbor.hpp"
 #include "vm/actor/builtin/storage_power/storage_power_actor_state.hpp"
 #include "vm/state/impl/state_tree_impl.hpp"
 
@@ -19,30 +20,53 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::blockchain::weight, WeightCalculatorError, e) {
 namespace fc::blockchain::weight {
   using primitives::BigInt;
   using vm::actor::kStoragePowerAddress;
-  using vm::actor::builtin::storage_power::StoragePowerActorState;
   using vm::state::StateTreeImpl;
 
   constexpr uint64_t kWRatioNum{1};
   constexpr uint64_t kWRatioDen{2};
   constexpr uint64_t kBlocksPerEpoch{5};
 
+  /// Leading field of StoragePowerActorState, rest of tuple is not decoded
+  struct NetworkPowerPrefix {
+    Power total_network_power;
+  };
+
+  CBOR_DECODE(NetworkPowerPrefix, prefix) {
+    s.list() >> prefix.total_network_power;
+    return s;
+  }
+
   WeightCalculatorImpl::WeightCalculatorImpl(std::shared_ptr<Ipld> ipld)
       : ipld_{std::move(ipld)} {}
 
   outcome::result<BigInt> WeightCalculatorImpl::calculateWeight(
       const Tipset &tipset) {
-    OUTCOME_TRY(actor,
-                StateTreeImpl{ipld_, tipset.getParentStateRoot()}.get(
-                    kStoragePowerAddress));
-    OUTCOME_TRY(state, ipld_->getCbor<StoragePowerActorState>(actor.head));
-    auto network_power = state.total_network_power;
+    OUTCOME_TRY(key, tipset.makeKey());
+    if (auto weight = weight_cache_.get(key)) {
+      return *weight;
+    }
+    OUTCOME_TRY(network_power, getNetworkPower(tipset.getParentStateRoot()));
     if (network_power <= 0) {
       return outcome::failure(WeightCalculatorError::NO_NETWORK_POWER);
     }
     BigInt log{boost::multiprecision::msb(network_power) << 8};
-    return tipset.getParentWeight() + log
-           + (log * tipset.blks.size() * kWRatioNum)
-                 / (kBlocksPerEpoch * kWRatioDen);
+    BigInt weight = tipset.getParentWeight() + log
+                    + (log * tipset.blks.size() * kWRatioNum)
+                          / (kBlocksPerEpoch * kWRatioDen);
+    weight_cache_.put(key, weight);
+    return weight;
+  }
+
+  outcome::result<Power> WeightCalculatorImpl::getNetworkPower(
+      const CID &state_root) {
+    if (auto power = power_cache_.get(state_root)) {
+      return *power;
+    }
+    OUTCOME_TRY(actor,
+                StateTreeImpl{ipld_, state_root}.get(kStoragePowerAddress));
+    OUTCOME_TRY(prefix, ipld_->getCbor<NetworkPowerPrefix>(actor.head));
+    power_cache_.put(state_root, prefix.total_network_power);
+    return prefix.total_network_power;
   }
 
 }  // namespace fc::blockchain::weight
@@ -8,23 +8,45 @@
 
 #include "blockchain/weight_calculator.hpp"
 
+#include "common/lru_cache.hpp"
+#include "power/power_table.hpp"
 #include "storage/ipfs/datastore.hpp"
 
 namespace fc::blockchain::weight {
   using Ipld = storage::ipfs::IpfsDatastore;
+  using power::Power;
+  using primitives::tipset::TipsetKey;
 
   enum class WeightCalculatorError { NO_NETWORK_POWER = 1 };
 
+  /**
+   * @class WeightCalculatorImpl calculates tipset weight from network power of
+   * its parent state, weights are memoized by tipset key and network power by
+   * state root, so repeated fork choice comparisons are O(1)
+   */
   class WeightCalculatorImpl : public WeightCalculator {
    public:
+    static constexpr size_t kWeightCacheSize = 4096;
+    static constexpr size_t kPowerCacheSize = 1024;
+
     explicit WeightCalculatorImpl(std::shared_ptr<Ipld> ipld);
 
     ~WeightCalculatorImpl() override = default;
 
     outcome::result<BigInt> calculateWeight(const Tipset &tipset) override;
 
+    /**
+     * Get total network power of state, decodes only that field of storage
+     * power actor state
+     * @param state_root - state tree root
+     * @return total network power
+     */
+    outcome::result<Power> getNetworkPower(const CID &state_root);
+
    private:
     std::shared_ptr<Ipld> ipld_;
+    common::LruCache<TipsetKey, BigInt> weight_cache_{kWeightCacheSize};
+    common::LruCache<CID, Power> power_cache_{kPowerCacheSize};
   };
 
 }  // namespace fc::blockchain::weight
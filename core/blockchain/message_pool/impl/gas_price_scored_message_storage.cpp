@@ -5,28 +5,304 @@
 
 #include "blockchain/message_pool/impl/gas_price_scored_message_storage.hpp"
 
+#include <tuple>
+
 #include "blockchain/message_pool/message_pool_error.hpp"
+#include "codec/cbor/cbor.hpp"
+#include "primitives/block/block.hpp"
+#include "storage/amt/amt.hpp"
+#include "vm/message/message_util.hpp"
 
+using fc::CID;
 using fc::blockchain::message_pool::GasPriceScoredMessageStorage;
 using fc::blockchain::message_pool::MessagePoolError;
+using fc::blockchain::message_pool::MessagePreExecutor;
+using fc::blockchain::message_pool::NonceStatus;
+using fc::blockchain::message_pool::PreExecutionResult;
+using fc::blockchain::message_pool::ScoreKey;
+using fc::primitives::block::MsgMeta;
+using fc::primitives::tipset::HeadChange;
+using fc::primitives::tipset::HeadChangeType;
+using fc::storage::amt::Amt;
 using fc::vm::message::SignedMessage;
+using fc::vm::message::UnsignedMessage;
+using BlsSignature = fc::crypto::bls::Signature;
+
+namespace {
+  /// Messages waiting for preceding nonces are scored last
+  bool isDeprioritized(const boost::optional<PreExecutionResult> &result) {
+    return result && result->nonce_status == NonceStatus::FUTURE;
+  }
+}  // namespace
+
+GasPriceScoredMessageStorage::GasPriceScoredMessageStorage(
+    std::shared_ptr<MessagePreExecutor> pre_executor)
+    : pre_executor_{std::move(pre_executor)} {}
+
+GasPriceScoredMessageStorage::GasPriceScoredMessageStorage(
+    std::shared_ptr<MessagePreExecutor> pre_executor,
+    std::shared_ptr<IpfsDatastore> ipld,
+    size_t max_bytes)
+    : pre_executor_{std::move(pre_executor)},
+      ipld_{std::move(ipld)},
+      max_bytes_{max_bytes} {}
+
+bool fc::blockchain::message_pool::operator<(const ScoreKey &lhs,
+                                             const ScoreKey &rhs) {
+  if (lhs.deprioritized != rhs.deprioritized) {
+    return rhs.deprioritized;
+  }
+  if (lhs.gas_price != rhs.gas_price) {
+    return lhs.gas_price > rhs.gas_price;
+  }
+  if (lhs.from != rhs.from) {
+    return lhs.from < rhs.from;
+  }
+  return lhs.nonce < rhs.nonce;
+}
+
+ScoreKey GasPriceScoredMessageStorage::scoreKey(
+    const PendingMessage &pending) {
+  return {isDeprioritized(pending.pre_execution),
+          pending.message.message.gasPrice,
+          pending.message.message.from,
+          pending.message.message.nonce};
+}
 
 fc::outcome::result<void> GasPriceScoredMessageStorage::put(
     const SignedMessage &message) {
-  auto res = messages_.insert(message);
-  if (!res.second) return MessagePoolError::MESSAGE_ALREADY_IN_POOL;
+  auto queue = queues_.find(message.message.from);
+  if (queue != queues_.end()
+      && queue->second.find(message.message.nonce) != queue->second.end()) {
+    return MessagePoolError::MESSAGE_ALREADY_IN_POOL;
+  }
+  boost::optional<PreExecutionResult> pre_execution;
+  if (pre_executor_) {
+    auto result = pre_executor_->preExecute(message.message);
+    if (!result || result.value().nonce_status == NonceStatus::STALE
+        || result.value().exit_code != 0) {
+      return MessagePoolError::MESSAGE_WILL_FAIL;
+    }
+    pre_execution = result.value();
+  }
+
+  OUTCOME_TRY(size, vm::message::size(message));
+
+  auto &nonces = queues_[message.message.from];
+  auto it =
+      nonces
+          .emplace(message.message.nonce,
+                   PendingMessage{message, std::move(pre_execution), size})
+          .first;
+  bytes_ += size;
+  if (it == nonces.begin()) {
+    if (nonces.size() > 1) {
+      heads_.erase(scoreKey(std::next(it)->second));
+    }
+    heads_.insert(scoreKey(it->second));
+  }
+
+  // message that would be evicted itself is rejected before anything else is
+  // evicted, pool was within budget before
+  if (bytes_ > max_bytes_
+      && !fitsAfterEviction(message.message.from, message.message.nonce)) {
+    erase(queues_.find(message.message.from), it, std::next(it));
+    return MessagePoolError::POOL_FULL;
+  }
+  // evict tails of worst scored senders
+  while (bytes_ > max_bytes_) {
+    auto worst = queues_.find(heads_.rbegin()->from);
+    erase(worst, std::prev(worst->second.end()), worst->second.end());
+  }
+
+  if (const auto *signature = boost::get<BlsSignature>(&message.signature)) {
+    OUTCOME_TRY(cid, vm::message::cid(message.message));
+    bls_signatures_.put(cid, *signature);
+  }
   return fc::outcome::success();
 }
 
+bool GasPriceScoredMessageStorage::fitsAfterEviction(const Address &from,
+                                                     uint64_t nonce) const {
+  // same order as eviction: tails of worst scored senders first
+  auto excess = bytes_ - max_bytes_;
+  for (auto head = heads_.rbegin(); head != heads_.rend(); ++head) {
+    const auto &nonces = queues_.at(head->from);
+    for (auto tail = nonces.rbegin(); tail != nonces.rend(); ++tail) {
+      if (head->from == from && tail->first == nonce) {
+        return false;
+      }
+      if (tail->second.size >= excess) {
+        return true;
+      }
+      excess -= tail->second.size;
+    }
+  }
+  return false;
+}
+
 void GasPriceScoredMessageStorage::remove(const SignedMessage &message) {
-  messages_.erase(message);
+  auto queue = queues_.find(message.message.from);
+  if (queue == queues_.end()) {
+    return;
+  }
+  auto it = queue->second.find(message.message.nonce);
+  if (it != queue->second.end()) {
+    erase(queue, it, std::next(it));
+  }
+}
+
+void GasPriceScoredMessageStorage::removeUpTo(const Address &from,
+                                              uint64_t nonce) {
+  auto queue = queues_.find(from);
+  if (queue == queues_.end()) {
+    return;
+  }
+  auto end = queue->second.upper_bound(nonce);
+  if (end != queue->second.begin()) {
+    erase(queue, queue->second.begin(), end);
+  }
+}
+
+void GasPriceScoredMessageStorage::erase(Queues::iterator queue,
+                                         NonceQueue::iterator begin,
+                                         NonceQueue::iterator end) {
+  auto &nonces = queue->second;
+  const bool erases_head = begin == nonces.begin();
+  if (erases_head) {
+    heads_.erase(scoreKey(begin->second));
+  }
+  for (auto it = begin; it != end; ++it) {
+    bytes_ -= it->second.size;
+  }
+  nonces.erase(begin, end);
+  if (nonces.empty()) {
+    queues_.erase(queue);
+  } else if (erases_head) {
+    heads_.insert(scoreKey(nonces.begin()->second));
+  }
 }
 
 std::vector<SignedMessage> GasPriceScoredMessageStorage::getTopScored(
     size_t n) const {
-  std::set<SignedMessage, decltype(compareGasFunctor)> score(
-      messages_.begin(), messages_.end(), compareGasFunctor);
-  return std::vector<SignedMessage>(
-      score.begin(),
-      (n < score.size()) ? std::next(score.begin(), n) : score.end());
+  std::vector<SignedMessage> top;
+  // next nonces of senders whose heads are already taken
+  std::set<ScoreKey> successors;
+  auto head = heads_.begin();
+  while (top.size() < n) {
+    // heads waiting for preceding nonces are scored last and never taken
+    const bool take_head =
+        head != heads_.end() && !head->deprioritized
+        && (successors.empty() || *head < *successors.begin());
+    if (!take_head && successors.empty()) {
+      break;
+    }
+    ScoreKey key = take_head ? *head++
+                             : successors.extract(successors.begin()).value();
+
+    const auto &nonces = queues_.at(key.from);
+    auto it = nonces.find(key.nonce);
+    top.push_back(it->second.message);
+    auto next = std::next(it);
+    if (next != nonces.end() && next->first == key.nonce + 1) {
+      // pre-execution of successor ran before its predecessor was applied,
+      // so its future nonce status is stale
+      successors.insert({false,
+                         next->second.message.message.gasPrice,
+                         key.from,
+                         next->first});
+    }
+  }
+  return top;
+}
+
+fc::outcome::result<void> GasPriceScoredMessageStorage::onHeadChange(
+    const HeadChange &change) {
+  if (change.type == HeadChangeType::CURRENT) {
+    refreshPreExecution();
+    return fc::outcome::success();
+  }
+  if (!ipld_) {
+    return MessagePoolError::NO_IPLD_STORE;
+  }
+  const bool apply = change.type == HeadChangeType::APPLY;
+  for (const auto &block : change.value.blks) {
+    OUTCOME_TRY(meta, ipld_->getCbor<MsgMeta>(block.messages));
+    OUTCOME_TRY(Amt(ipld_, meta.bls_messages)
+                    .visit([&](auto, auto &value) -> outcome::result<void> {
+                      OUTCOME_TRY(cid, codec::cbor::decode<CID>(value));
+                      OUTCOME_TRY(message,
+                                  ipld_->getCbor<UnsignedMessage>(cid));
+                      if (apply) {
+                        removeUpTo(message.from, message.nonce);
+                      } else if (auto signature = bls_signatures_.get(cid)) {
+                        std::ignore = put({std::move(message), *signature});
+                      }
+                      return outcome::success();
+                    }));
+    OUTCOME_TRY(Amt(ipld_, meta.secpk_messages)
+                    .visit([&](auto, auto &value) -> outcome::result<void> {
+                      OUTCOME_TRY(cid, codec::cbor::decode<CID>(value));
+                      OUTCOME_TRY(message, ipld_->getCbor<SignedMessage>(cid));
+                      if (apply) {
+                        removeUpTo(message.message.from,
+                                   message.message.nonce);
+                      } else {
+                        std::ignore = put(message);
+                      }
+                      return outcome::success();
+                    }));
+  }
+  refreshPreExecution();
+  return fc::outcome::success();
+}
+
+void GasPriceScoredMessageStorage::refreshPreExecution() {
+  if (!pre_executor_) {
+    return;
+  }
+  heads_.clear();
+  for (auto queue = queues_.begin(); queue != queues_.end();) {
+    auto &nonces = queue->second;
+    for (auto &entry : nonces) {
+      entry.second.pre_execution = boost::none;
+    }
+    // only queue head can be valid on new head state, failing heads are
+    // dropped as on put
+    while (!nonces.empty()) {
+      auto &pending = nonces.begin()->second;
+      auto result = pre_executor_->preExecute(pending.message.message);
+      if (result && result.value().nonce_status != NonceStatus::STALE
+          && result.value().exit_code == 0) {
+        pending.pre_execution = result.value();
+        break;
+      }
+      bytes_ -= pending.size;
+      nonces.erase(nonces.begin());
+    }
+    if (nonces.empty()) {
+      queue = queues_.erase(queue);
+    } else {
+      heads_.insert(scoreKey(nonces.begin()->second));
+      ++queue;
+    }
+  }
+}
+
+size_t GasPriceScoredMessageStorage::bytes() const {
+  return bytes_;
+}
+
+boost::optional<PreExecutionResult>
+GasPriceScoredMessageStorage::getPreExecutionResult(
+    const SignedMessage &message) const {
+  auto queue = queues_.find(message.message.from);
+  if (queue == queues_.end()) {
+    return boost::none;
+  }
+  auto it = queue->second.find(message.message.nonce);
+  if (it == queue->second.end()) {
+    return boost::none;
+  }
+  return it->second.pre_execution;
 }
@@ -6,7 +6,15 @@
 #ifndef CPP_FILECOIN_BLOCKCHAIN_MESSAGE_POOL_GAS_PRICE_SCORED_MESSAGE_STORAGE_HPP
 #define CPP_FILECOIN_BLOCKCHAIN_MESSAGE_POOL_GAS_PRICE_SCORED_MESSAGE_STORAGE_HPP
 
+#include <map>
+#include <set>
+
+#include <boost/optional.hpp>
+
+#include "blockchain/message_pool/message_pre_executor.hpp"
 #include "blockchain/message_pool/message_storage.hpp"
+#include "common/lru_cache.hpp"
+#include "storage/ipfs/datastore.hpp"
 
 namespace fc::blockchain::message_pool {
 
@@ -14,30 +22,49 @@ namespace fc::blockchain::message_pool {
   using vm::message::SignedMessage;
 
   /**
-   * Compare messages by sender address and nonce
+   * Position of queue head in scoring, messages with nonce gaps are scored
+   * last, others by gas price descending
    */
-  auto compareMessagesFunctor = [](const SignedMessage &lhs,
-                                   const SignedMessage &rhs) {
-    return (lhs.message.from < rhs.message.from)
-           || ((lhs.message.from == rhs.message.from)
-               && (lhs.message.nonce < rhs.message.nonce));
+  struct ScoreKey {
+    bool deprioritized;
+    primitives::BigInt gas_price;
+    Address from;
+    uint64_t nonce;
   };
 
-  /**
-   * Comparator based on gas price for scoring
-   */
-  auto compareGasFunctor = [](const SignedMessage &lhs,
-                              const SignedMessage &rhs) {
-    return (lhs.message.gasPrice > rhs.message.gasPrice)
-           || ((lhs.message.gasPrice == rhs.message.gasPrice)
-               && (compareMessagesFunctor(lhs, rhs)));
-  };
+  bool operator<(const ScoreKey &lhs, const ScoreKey &rhs);
 
   /**
-   * Caches pending messages and order by gas price.
+   * Caches pending messages in per-sender nonce queues and scores queue heads
+   * by gas price, so selected messages never skip a nonce of their sender.
+   * If pre-executor is set, messages are applied on head state on put.
+   * Messages that would fail are dropped and messages waiting for preceding
+   * nonces are scored below messages that can be applied right now.
+   * When encoded size of pending messages exceeds budget, messages of the
+   * lowest scored sender are evicted starting from the highest nonce.
    */
   class GasPriceScoredMessageStorage : public MessageStorage {
    public:
+    using IpfsDatastore = storage::ipfs::IpfsDatastore;
+
+    /// Default budget for encoded size of pending messages
+    static constexpr size_t kDefaultMaxBytes = 64 << 20;
+
+    GasPriceScoredMessageStorage() = default;
+
+    explicit GasPriceScoredMessageStorage(
+        std::shared_ptr<MessagePreExecutor> pre_executor);
+
+    /**
+     * @param pre_executor - optional pre-executor
+     * @param ipld - store to load messages of head change blocks from
+     * @param max_bytes - budget for encoded size of pending messages
+     */
+    GasPriceScoredMessageStorage(
+        std::shared_ptr<MessagePreExecutor> pre_executor,
+        std::shared_ptr<IpfsDatastore> ipld,
+        size_t max_bytes = kDefaultMaxBytes);
+
     ~GasPriceScoredMessageStorage() override = default;
 
     /** \copydoc MessageStorage::put() */
@@ -46,12 +73,78 @@ namespace fc::blockchain::message_pool {
     /** \copydoc MessageStorage::remove() */
     void remove(const SignedMessage &message) override;
 
-    /** \copydoc MessageStorage::getTopScored() */
+    /**
+     * Get N top scored messages, takes best queue head each time, O(N log N)
+     * regardless of pool size. Senders whose head waits for preceding nonce
+     * are skipped
+     * @param n - how many messages return
+     * @return no more than N messages, nonces of each sender are consecutive
+     */
     std::vector<SignedMessage> getTopScored(size_t n) const override;
 
+    /**
+     * Messages included in applied tipset and preceding nonces of their
+     * senders are removed. Messages of reverted tipset are put again, BLS ones
+     * only if their signature was seen by this pool. Pre-execution results
+     * of previous head are dropped and queue heads are pre-executed again.
+     */
+    outcome::result<void> onHeadChange(const HeadChange &change) override;
+
+    /** @brief encoded size of pending messages */
+    size_t bytes() const;
+
+    /**
+     * Get cached pre-execution result, e.g. to pack block by gas used instead
+     * of gas limit
+     * @param message - pending message
+     * @return pre-execution result or none if message is not in pool or was
+     * not pre-executed
+     */
+    boost::optional<PreExecutionResult> getPreExecutionResult(
+        const SignedMessage &message) const;
+
    private:
-    std::set<SignedMessage, decltype(compareMessagesFunctor)> messages_{
-        compareMessagesFunctor};
+    struct PendingMessage {
+      SignedMessage message;
+      boost::optional<PreExecutionResult> pre_execution;
+      /// Encoded size of message
+      size_t size{};
+    };
+    /// Nonce -> message of one sender
+    using NonceQueue = std::map<uint64_t, PendingMessage>;
+    using Queues = std::map<Address, NonceQueue>;
+
+    static ScoreKey scoreKey(const PendingMessage &pending);
+
+    /**
+     * Checks whether evicting messages scored below given one brings pool
+     * within budget
+     * @param from - sender of put message
+     * @param nonce - nonce of put message
+     */
+    bool fitsAfterEviction(const Address &from, uint64_t nonce) const;
+
+    /// Removes messages of sender with nonce up to and including given
+    void removeUpTo(const Address &from, uint64_t nonce);
+
+    /// Drops pre-execution results and pre-executes queue heads on new head
+    void refreshPreExecution();
+
+    /// Removes [begin, end) range of sender queue
+    void erase(Queues::iterator queue,
+               NonceQueue::iterator begin,
+               NonceQueue::iterator end);
+
+    std::shared_ptr<MessagePreExecutor> pre_executor_;
+    std::shared_ptr<IpfsDatastore> ipld_;
+    size_t max_bytes_{kDefaultMaxBytes};
+    size_t bytes_{};
+    Queues queues_;
+    /// Lowest nonce message of each sender
+    std::set<ScoreKey> heads_;
+    /// BLS signatures of seen messages by message cid, to put messages of
+    /// reverted blocks again
+    common::LruCache<CID, crypto::bls::Signature> bls_signatures_{1 << 16};
   };
 
 }  // namespace fc::blockchain::message_pool
@@ -11,6 +11,12 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::blockchain::message_pool, MessagePoolError, e) {
   switch (e) {
     case MessagePoolError::MESSAGE_ALREADY_IN_POOL:
       return "MessagePoolError: message is already in pool";
+    case MessagePoolError::MESSAGE_WILL_FAIL:
+      return "MessagePoolError: message fails on current head state";
+    case MessagePoolError::POOL_FULL:
+      return "MessagePoolError: message is scored too low for full pool";
+    case MessagePoolError::NO_IPLD_STORE:
+      return "MessagePoolError: no ipld store to load block messages from";
   }
 
   return "unknown error";
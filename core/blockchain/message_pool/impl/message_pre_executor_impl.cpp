@@ -0,0 +1,90 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/message_pool/impl/message_pre_executor_impl.hpp"
+
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "storage/ipfs/impl/overlay_datastore.hpp"
+#include "vm/actor/impl/invoker_impl.hpp"
+#include "vm/runtime/env.hpp"
+#include "vm/state/impl/state_tree_impl.hpp"
+
+namespace fc::blockchain::message_pool {
+  using storage::ipfs::InMemoryDatastore;
+  using storage::ipfs::OverlayDatastore;
+  using vm::actor::InvokerImpl;
+  using vm::actor::kSystemActorAddress;
+  using vm::runtime::Env;
+  using vm::state::StateTreeImpl;
+
+  MessagePreExecutorImpl::MessagePreExecutorImpl(
+      std::shared_ptr<IpfsDatastore> store,
+      std::shared_ptr<ChainStore> chain_store,
+      std::shared_ptr<Interpreter> interpreter,
+      std::shared_ptr<RandomnessProvider> randomness_provider,
+      std::shared_ptr<Indices> indices)
+      : store_{std::move(store)},
+        chain_store_{std::move(chain_store)},
+        interpreter_{std::move(interpreter)},
+        randomness_provider_{std::move(randomness_provider)},
+        indices_{std::move(indices)} {
+    BOOST_ASSERT_MSG(store_ != nullptr, "store is nullptr");
+    BOOST_ASSERT_MSG(chain_store_ != nullptr, "chain store is nullptr");
+    BOOST_ASSERT_MSG(interpreter_ != nullptr, "interpreter is nullptr");
+    BOOST_ASSERT_MSG(randomness_provider_ != nullptr,
+                     "randomness provider is nullptr");
+    BOOST_ASSERT_MSG(indices_ != nullptr, "indices is nullptr");
+  }
+
+  outcome::result<MessagePreExecutorImpl::HeadState>
+  MessagePreExecutorImpl::headState(const Tipset &head) const {
+    OUTCOME_TRY(key, head.makeKey());
+    std::lock_guard lock{mutex_};
+    if (head_state_ && head_state_->key == key) {
+      return *head_state_;
+    }
+    head_state_ = boost::none;
+    auto store = std::make_shared<OverlayDatastore>(
+        store_, std::make_shared<InMemoryDatastore>());
+    OUTCOME_TRY(result, interpreter_->interpret(store, head, indices_));
+    head_state_ = HeadState{std::move(key), store, result.state_root};
+    return *head_state_;
+  }
+
+  outcome::result<PreExecutionResult> MessagePreExecutorImpl::preExecute(
+      const UnsignedMessage &message) const {
+    OUTCOME_TRY(head, chain_store_->heaviestTipset());
+    OUTCOME_TRY(head_state, headState(head));
+    auto state_tree = std::make_shared<StateTreeImpl>(
+        std::make_shared<OverlayDatastore>(
+            head_state.store, std::make_shared<InMemoryDatastore>()),
+        head_state.state_root);
+
+    OUTCOME_TRY(from_actor, state_tree->get(message.from));
+    if (message.nonce < from_actor.nonce) {
+      return PreExecutionResult{NonceStatus::STALE};
+    }
+    if (message.nonce > from_actor.nonce) {
+      return PreExecutionResult{NonceStatus::FUTURE};
+    }
+
+    // message would be included in block on top of head, gas reward receiver
+    // does not affect execution result, system actor is used as it always
+    // exists
+    auto env = std::make_shared<Env>(randomness_provider_,
+                                     state_tree,
+                                     indices_,
+                                     std::make_shared<InvokerImpl>(),
+                                     head.height + 1,
+                                     kSystemActorAddress);
+    OUTCOME_TRY(receipt, env->applyMessage(message));
+    return PreExecutionResult{
+        NonceStatus::VALID,
+        static_cast<GasAmount>(receipt.gas_used),
+        receipt.exit_code,
+    };
+  }
+
+}  // namespace fc::blockchain::message_pool
@@ -0,0 +1,72 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_BLOCKCHAIN_MESSAGE_POOL_MESSAGE_PRE_EXECUTOR_IMPL_HPP
+#define CPP_FILECOIN_BLOCKCHAIN_MESSAGE_POOL_MESSAGE_PRE_EXECUTOR_IMPL_HPP
+
+#include <mutex>
+
+#include <boost/optional.hpp>
+
+#include "blockchain/message_pool/message_pre_executor.hpp"
+#include "crypto/randomness/randomness_provider.hpp"
+#include "storage/chain/chain_store.hpp"
+#include "storage/ipfs/datastore.hpp"
+#include "vm/indices/indices.hpp"
+#include "vm/interpreter/interpreter.hpp"
+
+namespace fc::blockchain::message_pool {
+
+  /**
+   * Applies messages on state resulting from execution of the heaviest
+   * tipset. The state is computed once per head and kept in an in-memory
+   * overlay. Writes of messages go to another overlay which is dropped after
+   * every message, so the node state is never modified.
+   */
+  class MessagePreExecutorImpl : public MessagePreExecutor {
+   protected:
+    using ChainStore = storage::blockchain::ChainStore;
+    using IpfsDatastore = storage::ipfs::IpfsDatastore;
+    using Indices = vm::indices::Indices;
+    using Interpreter = vm::interpreter::Interpreter;
+    using RandomnessProvider = crypto::randomness::RandomnessProvider;
+    using Tipset = primitives::tipset::Tipset;
+    using TipsetKey = primitives::tipset::TipsetKey;
+
+   public:
+    MessagePreExecutorImpl(
+        std::shared_ptr<IpfsDatastore> store,
+        std::shared_ptr<ChainStore> chain_store,
+        std::shared_ptr<Interpreter> interpreter,
+        std::shared_ptr<RandomnessProvider> randomness_provider,
+        std::shared_ptr<Indices> indices);
+
+    outcome::result<PreExecutionResult> preExecute(
+        const UnsignedMessage &message) const override;
+
+   private:
+    /// State of executed head tipset with store holding its new blocks
+    struct HeadState {
+      TipsetKey key;
+      std::shared_ptr<IpfsDatastore> store;
+      CID state_root;
+    };
+
+    /// Returns cached state of head or executes head if it changed
+    outcome::result<HeadState> headState(const Tipset &head) const;
+
+    std::shared_ptr<IpfsDatastore> store_;
+    std::shared_ptr<ChainStore> chain_store_;
+    std::shared_ptr<Interpreter> interpreter_;
+    std::shared_ptr<RandomnessProvider> randomness_provider_;
+    std::shared_ptr<Indices> indices_;
+
+    mutable std::mutex mutex_;
+    mutable boost::optional<HeadState> head_state_;
+  };
+
+}  // namespace fc::blockchain::message_pool
+
+#endif  // CPP_FILECOIN_BLOCKCHAIN_MESSAGE_POOL_MESSAGE_PRE_EXECUTOR_IMPL_HPP
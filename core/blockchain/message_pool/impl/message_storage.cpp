@@ -0,0 +1,28 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/message_pool/message_storage.hpp"
+
+#include "common/logger.hpp"
+
+namespace fc::blockchain::message_pool {
+
+  void subscribeHeadChanges(storage::blockchain::ChainStore &chain_store,
+                            std::weak_ptr<MessageStorage> storage) {
+    chain_store.subscribeHeadChanges(
+        [storage{std::move(storage)},
+         logger{common::createLogger("message pool")}](
+            const HeadChange &change) {
+          if (auto locked = storage.lock()) {
+            auto result = locked->onHeadChange(change);
+            if (!result) {
+              logger->error("head change failed: {}",
+                            result.error().message());
+            }
+          }
+        });
+  }
+
+}  // namespace fc::blockchain::message_pool
@@ -15,6 +15,9 @@ namespace fc::blockchain::message_pool {
    */
   enum class MessagePoolError {
     MESSAGE_ALREADY_IN_POOL = 1,
+    MESSAGE_WILL_FAIL,
+    POOL_FULL,
+    NO_IPLD_STORE,
   };
 
 }  // namespace fc::blockchain::message_pool
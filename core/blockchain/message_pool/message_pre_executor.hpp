@@ -0,0 +1,57 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_BLOCKCHAIN_MESSAGE_POOL_MESSAGE_PRE_EXECUTOR_HPP
+#define CPP_FILECOIN_BLOCKCHAIN_MESSAGE_POOL_MESSAGE_PRE_EXECUTOR_HPP
+
+#include "common/outcome.hpp"
+#include "primitives/types.hpp"
+#include "vm/message/message.hpp"
+
+namespace fc::blockchain::message_pool {
+
+  using primitives::GasAmount;
+  using vm::message::UnsignedMessage;
+
+  /**
+   * Message nonce compared to sender actor nonce in head state
+   */
+  enum class NonceStatus {
+    VALID,  // message can be applied right now
+    STALE,  // nonce was already used, message can never be applied
+    FUTURE  // message waits for messages with preceding nonces
+  };
+
+  /**
+   * Result of speculative message application on head state
+   */
+  struct PreExecutionResult {
+    NonceStatus nonce_status{NonceStatus::VALID};
+    /// gas used and exit code are only known for messages with valid nonce
+    GasAmount gas_used{};
+    uint8_t exit_code{};
+  };
+
+  /**
+   * Applies pending messages on a copy of head state to find out whether they
+   * will fail
+   */
+  class MessagePreExecutor {
+   public:
+    virtual ~MessagePreExecutor() = default;
+
+    /**
+     * Apply message on copy-on-write view of current head state
+     * @param message - message to apply
+     * @return pre-execution result or error, if message can not be applied
+     * (e.g. sender does not exist or has not enough funds)
+     */
+    virtual outcome::result<PreExecutionResult> preExecute(
+        const UnsignedMessage &message) const = 0;
+  };
+
+}  // namespace fc::blockchain::message_pool
+
+#endif  // CPP_FILECOIN_BLOCKCHAIN_MESSAGE_POOL_MESSAGE_PRE_EXECUTOR_HPP
@@ -6,13 +6,18 @@
 #ifndef CPP_FILECOIN_BLOCKCHAIN_MESSAGE_POOL_MESSAGE_STORAGE_HPP
 #define CPP_FILECOIN_BLOCKCHAIN_MESSAGE_POOL_MESSAGE_STORAGE_HPP
 
+#include <memory>
+
 #include "common/outcome.hpp"
 #include "primitives/address/address.hpp"
+#include "primitives/tipset/tipset.hpp"
+#include "storage/chain/chain_store.hpp"
 #include "vm/message/message.hpp"
 
 namespace fc::blockchain::message_pool {
 
   using primitives::address::Address;
+  using primitives::tipset::HeadChange;
   using vm::message::SignedMessage;
 
   /**
@@ -42,8 +47,25 @@ namespace fc::blockchain::message_pool {
      * @return no more than N top scored messages present in cache
      */
     virtual std::vector<SignedMessage> getTopScored(size_t n) const = 0;
+
+    /**
+     * Update pending messages on chain head change
+     * @param change - applied tipset, its messages are pruned, or reverted
+     * tipset, its messages are pending again
+     * @return error code in case of error, or nothing otherwise
+     */
+    virtual outcome::result<void> onHeadChange(const HeadChange &change) = 0;
   };
 
+  /**
+   * Keeps pending messages in sync with heaviest chain of chain store, errors
+   * of onHeadChange are logged
+   * @param chain_store - chain store notifying about head changes
+   * @param storage - message storage, subscription does not keep it alive
+   */
+  void subscribeHeadChanges(storage::blockchain::ChainStore &chain_store,
+                            std::weak_ptr<MessageStorage> storage);
+
 }  // namespace fc::blockchain::message_pool
 
 #endif  // CPP_FILECOIN_BLOCKCHAIN_MESSAGE_POOL_MESSAGE_STORAGE_HPP
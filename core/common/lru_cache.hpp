@@ -0,0 +1,136 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_COMMON_LRU_CACHE_HPP
+#define CPP_FILECOIN_CORE_COMMON_LRU_CACHE_HPP
+
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/optional.hpp>
+
+namespace fc::common {
+
+  /**
+   * @class LruCache thread-safe bounded map, evicts least recently used entry
+   * when capacity is exceeded
+   */
+  template <typename Key, typename Value, typename Hash = std::hash<Key>>
+  class LruCache {
+   public:
+    explicit LruCache(size_t capacity) : capacity_{capacity} {
+      BOOST_ASSERT_MSG(capacity_ != 0, "LRU cache capacity must be positive");
+    }
+
+    /** @brief returns copy of cached value and marks it as recently used */
+    boost::optional<Value> get(const Key &key) {
+      std::lock_guard lock{mutex_};
+      auto it = index_.find(key);
+      if (it == index_.end()) {
+        return boost::none;
+      }
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return it->second->second;
+    }
+
+    /** @brief inserts or replaces value, evicts oldest entry if full */
+    void put(const Key &key, Value value) {
+      std::lock_guard lock{mutex_};
+      auto it = index_.find(key);
+      if (it != index_.end()) {
+        it->second->second = std::move(value);
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+      }
+      entries_.emplace_front(key, std::move(value));
+      index_.emplace(key, entries_.begin());
+      if (entries_.size() > capacity_) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+      }
+    }
+
+    /** @brief removes value if present */
+    void remove(const Key &key) {
+      std::lock_guard lock{mutex_};
+      auto it = index_.find(key);
+      if (it != index_.end()) {
+        entries_.erase(it->second);
+        index_.erase(it);
+      }
+    }
+
+    size_t size() const {
+      std::lock_guard lock{mutex_};
+      return entries_.size();
+    }
+
+   private:
+    using Entries = std::list<std::pair<Key, Value>>;
+
+    size_t capacity_;
+    Entries entries_;
+    std::unordered_map<Key, typename Entries::iterator, Hash> index_;
+    mutable std::mutex mutex_;
+  };
+
+  /**
+   * @class ShardedLruCache splits keys between several independently locked
+   * LruCache instances to reduce lock contention
+   */
+  template <typename Key, typename Value, typename Hash = std::hash<Key>>
+  class ShardedLruCache {
+   public:
+    using Shard = LruCache<Key, Value, Hash>;
+
+    /**
+     * @param capacity total number of entries, split evenly between shards
+     * @param shards number of shards
+     */
+    ShardedLruCache(size_t capacity, size_t shards) {
+      BOOST_ASSERT_MSG(shards != 0, "LRU cache must have at least one shard");
+      auto shard_capacity = std::max<size_t>(1, capacity / shards);
+      shards_.reserve(shards);
+      for (size_t i = 0; i < shards; ++i) {
+        shards_.push_back(std::make_unique<Shard>(shard_capacity));
+      }
+    }
+
+    boost::optional<Value> get(const Key &key) const {
+      return shardOf(key).get(key);
+    }
+
+    void put(const Key &key, Value value) const {
+      shardOf(key).put(key, std::move(value));
+    }
+
+    void remove(const Key &key) const {
+      shardOf(key).remove(key);
+    }
+
+    size_t size() const {
+      size_t total = 0;
+      for (auto &shard : shards_) {
+        total += shard->size();
+      }
+      return total;
+    }
+
+   private:
+    Shard &shardOf(const Key &key) const {
+      return *shards_[Hash{}(key) % shards_.size()];
+    }
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+  };
+
+}  // namespace fc::common
+
+#endif  // CPP_FILECOIN_CORE_COMMON_LRU_CACHE_HPP
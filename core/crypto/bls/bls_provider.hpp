@@ -53,6 +53,19 @@ namespace fc::crypto::bls {
         const Signature &signature,
         const PublicKey &key) const = 0;
 
+    /**
+     * @brief Verify aggregated BLS signature of several messages with one
+     * pairing product check
+     * @param messages - signed data, one message per public key
+     * @param public_keys - BLS public keys of signers
+     * @param signature - aggregated signature
+     * @return signature status or error code
+     */
+    virtual outcome::result<bool> verifyAggregateSignature(
+        const std::vector<gsl::span<const uint8_t>> &messages,
+        const std::vector<PublicKey> &public_keys,
+        const Signature &signature) const = 0;
+
     /**
      * @brief Aggregate BLS signatures
      * @param signatures - signatures to aggregate
@@ -73,6 +73,33 @@ namespace fc::crypto::bls {
     return false;
   }
 
+  outcome::result<bool> BlsProviderImpl::verifyAggregateSignature(
+      const std::vector<gsl::span<const uint8_t>> &messages,
+      const std::vector<PublicKey> &public_keys,
+      const Signature &signature) const {
+    if (messages.size() != public_keys.size()) {
+      return false;
+    }
+    if (messages.empty()) {
+      return true;
+    }
+    std::vector<uint8_t> flat_digests;
+    flat_digests.reserve(sizeof(Digest) * messages.size());
+    for (const auto &message : messages) {
+      OUTCOME_TRY(digest, generateHash(message));
+      flat_digests.insert(flat_digests.end(), digest.begin(), digest.end());
+    }
+    const uint8_t *flat_keys =
+        reinterpret_cast<const uint8_t *>(public_keys.data());
+    size_t flat_keys_size = sizeof(PublicKey) * public_keys.size();
+    return verify(signature.data(),
+                  flat_digests.data(),
+                  flat_digests.size(),
+                  flat_keys,
+                  flat_keys_size)
+           != 0;
+  }
+
   outcome::result<Digest> BlsProviderImpl::generateHash(
       gsl::span<const uint8_t> message) {
     Digest digest;
@@ -23,6 +23,11 @@ namespace fc::crypto::bls {
                                           const Signature &signature,
                                           const PublicKey &key) const override;
 
+    outcome::result<bool> verifyAggregateSignature(
+        const std::vector<gsl::span<const uint8_t>> &messages,
+        const std::vector<PublicKey> &public_keys,
+        const Signature &signature) const override;
+
     outcome::result<Signature> aggregateSignatures(
         const std::vector<Signature> &signatures) const override;
 
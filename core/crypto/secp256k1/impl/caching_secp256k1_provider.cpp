@@ -0,0 +1,107 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "crypto/secp256k1/impl/caching_secp256k1_provider.hpp"
+
+#include <future>
+
+#include <boost/asio/post.hpp>
+#include "common/buffer.hpp"
+
+namespace fc::crypto::secp256k1 {
+
+  namespace {
+    constexpr size_t kCacheShards = 16;
+
+    blake2b::Blake2b256Hash cacheKey(gsl::span<const uint8_t> message,
+                                     const Signature &signature,
+                                     const PublicKey &key) {
+      common::Buffer bytes;
+      bytes.reserve(message.size() + signature.size() + key.size());
+      bytes.put(message);
+      bytes.put(signature);
+      bytes.put(key);
+      return blake2b::blake2b_256(bytes);
+    }
+  }  // namespace
+
+  CachingSecp256k1Provider::CachingSecp256k1Provider(
+      std::shared_ptr<Secp256k1Provider> provider,
+      size_t cache_size,
+      std::shared_ptr<boost::asio::thread_pool> pool)
+      : provider_{std::move(provider)},
+        verified_{cache_size, kCacheShards},
+        pool_{std::move(pool)} {
+    BOOST_ASSERT_MSG(provider_ != nullptr, "provider is nullptr");
+  }
+
+  outcome::result<KeyPair> CachingSecp256k1Provider::generate() const {
+    return provider_->generate();
+  }
+
+  outcome::result<PublicKey> CachingSecp256k1Provider::derive(
+      const PrivateKey &key) const {
+    return provider_->derive(key);
+  }
+
+  outcome::result<Signature> CachingSecp256k1Provider::sign(
+      gsl::span<const uint8_t> message, const PrivateKey &key) const {
+    return provider_->sign(message, key);
+  }
+
+  outcome::result<bool> CachingSecp256k1Provider::verify(
+      gsl::span<const uint8_t> message,
+      const Signature &signature,
+      const PublicKey &key) const {
+    auto cache_key = cacheKey(message, signature, key);
+    if (verified_.get(cache_key)) {
+      return true;
+    }
+    OUTCOME_TRY(valid, provider_->verify(message, signature, key));
+    if (valid) {
+      verified_.put(cache_key, true);
+    }
+    return valid;
+  }
+
+  outcome::result<std::vector<bool>> CachingSecp256k1Provider::verifyBatch(
+      const std::vector<VerifyRequest> &requests) const {
+    std::vector<bool> statuses;
+    statuses.reserve(requests.size());
+    if (!pool_) {
+      for (const auto &request : requests) {
+        OUTCOME_TRY(
+            valid,
+            verify(request.message, request.signature, request.public_key));
+        statuses.push_back(valid);
+      }
+      return statuses;
+    }
+
+    std::vector<std::future<outcome::result<bool>>> results;
+    results.reserve(requests.size());
+    for (const auto &request : requests) {
+      auto task =
+          std::make_shared<std::packaged_task<outcome::result<bool>()>>(
+              [this, &request] {
+                return verify(
+                    request.message, request.signature, request.public_key);
+              });
+      results.push_back(task->get_future());
+      boost::asio::post(*pool_, [task] { (*task)(); });
+    }
+    // all tasks must finish before requests go out of scope
+    for (auto &result : results) {
+      result.wait();
+    }
+
+    for (auto &result : results) {
+      OUTCOME_TRY(valid, result.get());
+      statuses.push_back(valid);
+    }
+    return statuses;
+  }
+
+}  // namespace fc::crypto::secp256k1
@@ -0,0 +1,75 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_CRYPTO_SECP256K1_IMPL_CACHING_SECP256K1_PROVIDER_HPP
+#define CPP_FILECOIN_CORE_CRYPTO_SECP256K1_IMPL_CACHING_SECP256K1_PROVIDER_HPP
+
+#include <boost/asio/thread_pool.hpp>
+#include "common/lru_cache.hpp"
+#include "crypto/blake2/blake2b160.hpp"
+#include "crypto/secp256k1/secp256k1_provider.hpp"
+
+namespace fc::crypto::secp256k1 {
+
+  /**
+   * @class CachingSecp256k1Provider remembers successfully verified
+   * signatures, so message verified on receipt is not verified again on
+   * message pool insertion and block validation
+   */
+  class CachingSecp256k1Provider : public Secp256k1Provider {
+   public:
+    /// Number of verified signatures remembered by default
+    static constexpr size_t kDefaultCacheSize = 1 << 16;
+
+    /**
+     * @struct VerifyRequest signature to check in batch
+     */
+    struct VerifyRequest {
+      gsl::span<const uint8_t> message;
+      Signature signature;
+      PublicKey public_key;
+    };
+
+    /**
+     * @param provider - provider doing actual cryptography
+     * @param cache_size - number of verified signatures remembered
+     * @param pool - shared pool verifying batches, if null batches are
+     * verified on calling thread
+     */
+    explicit CachingSecp256k1Provider(
+        std::shared_ptr<Secp256k1Provider> provider,
+        size_t cache_size = kDefaultCacheSize,
+        std::shared_ptr<boost::asio::thread_pool> pool = nullptr);
+
+    outcome::result<KeyPair> generate() const override;
+
+    outcome::result<PublicKey> derive(const PrivateKey &key) const override;
+
+    outcome::result<Signature> sign(gsl::span<const uint8_t> message,
+                                    const PrivateKey &key) const override;
+
+    outcome::result<bool> verify(gsl::span<const uint8_t> message,
+                                 const Signature &signature,
+                                 const PublicKey &key) const override;
+
+    /**
+     * @brief Verify signatures concurrently on worker pool, must not be called
+     * from a task of the same pool
+     * @param requests - signatures to verify, message data must outlive call
+     * @return status of each signature or first error
+     */
+    outcome::result<std::vector<bool>> verifyBatch(
+        const std::vector<VerifyRequest> &requests) const;
+
+   private:
+    std::shared_ptr<Secp256k1Provider> provider_;
+    /// Hash of message, signature and public key of verified signatures
+    common::ShardedLruCache<blake2b::Blake2b256Hash, bool> verified_;
+    std::shared_ptr<boost::asio::thread_pool> pool_;
+  };
+
+}  // namespace fc::crypto::secp256k1
+
+#endif  // CPP_FILECOIN_CORE_CRYPTO_SECP256K1_IMPL_CACHING_SECP256K1_PROVIDER_HPP
@@ -0,0 +1,109 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "crypto/secp256k1/impl/secp256k1_recovery.hpp"
+
+#include <memory>
+
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/ecdsa.h>
+#include <openssl/err.h>
+#include <openssl/obj_mac.h>
+#include "crypto/hasher/hasher.hpp"
+
+namespace fc::crypto::secp256k1 {
+
+  namespace {
+    template <typename T, void (*free)(T *)>
+    struct Free {
+      void operator()(T *object) const {
+        free(object);
+      }
+    };
+
+    using BnPtr = std::unique_ptr<BIGNUM, Free<BIGNUM, BN_free>>;
+    using BnCtxPtr = std::unique_ptr<BN_CTX, Free<BN_CTX, BN_CTX_free>>;
+    using GroupPtr = std::unique_ptr<EC_GROUP, Free<EC_GROUP, EC_GROUP_free>>;
+    using PointPtr = std::unique_ptr<EC_POINT, Free<EC_POINT, EC_POINT_free>>;
+    using SigPtr = std::unique_ptr<ECDSA_SIG, Free<ECDSA_SIG, ECDSA_SIG_free>>;
+  }  // namespace
+
+  std::vector<PublicKey> recoverPublicKeys(gsl::span<const uint8_t> message,
+                                           const Signature &signature) {
+    std::vector<PublicKey> keys;
+    const auto *der = signature.data();
+    SigPtr sig{
+        d2i_ECDSA_SIG(nullptr, &der, static_cast<long>(signature.size()))};
+    GroupPtr group{EC_GROUP_new_by_curve_name(NID_secp256k1)};
+    BnCtxPtr ctx{BN_CTX_new()};
+    BnPtr p{BN_new()}, a{BN_new()}, b{BN_new()};
+    BnPtr u1{BN_new()}, u2{BN_new()}, x{BN_new()};
+    if (!sig || !group || !ctx || !p || !a || !b || !u1 || !u2 || !x
+        || EC_GROUP_get_curve_GFp(
+               group.get(), p.get(), a.get(), b.get(), ctx.get())
+               != 1) {
+      ERR_clear_error();
+      return keys;
+    }
+    const BIGNUM *r{}, *s{};
+    ECDSA_SIG_get0(sig.get(), &r, &s);
+    const BIGNUM *n = EC_GROUP_get0_order(group.get());
+    if (BN_is_zero(r) || BN_is_zero(s) || BN_cmp(r, n) >= 0
+        || BN_cmp(s, n) >= 0) {
+      return keys;
+    }
+
+    auto digest = Hasher::sha2_256(message).getHash();
+    BnPtr e{BN_bin2bn(
+        digest.data(), static_cast<int>(digest.size()), nullptr)};
+    BnPtr r_inv{BN_mod_inverse(nullptr, r, n, ctx.get())};
+    // key = u1 * G + u2 * R, where u1 = -e / r and u2 = s / r
+    if (!e || !r_inv || BN_mod_sub(u1.get(), n, e.get(), n, ctx.get()) != 1
+        || BN_mod_mul(u1.get(), u1.get(), r_inv.get(), n, ctx.get()) != 1
+        || BN_mod_mul(u2.get(), s, r_inv.get(), n, ctx.get()) != 1) {
+      ERR_clear_error();
+      return keys;
+    }
+
+    // R has x coordinate r or r + n, and either parity of y
+    for (int id = 0; id < 4; ++id) {
+      if (BN_copy(x.get(), r) == nullptr
+          || (id >= 2 && BN_add(x.get(), x.get(), n) != 1)
+          || BN_cmp(x.get(), p.get()) >= 0) {
+        continue;
+      }
+      PointPtr point{EC_POINT_new(group.get())};
+      PointPtr key{EC_POINT_new(group.get())};
+      if (!point || !key
+          || EC_POINT_set_compressed_coordinates_GFp(
+                 group.get(), point.get(), x.get(), id & 1, ctx.get())
+                 != 1
+          || EC_POINT_mul(group.get(),
+                          key.get(),
+                          u1.get(),
+                          point.get(),
+                          u2.get(),
+                          ctx.get())
+                 != 1
+          || EC_POINT_is_at_infinity(group.get(), key.get()) == 1) {
+        ERR_clear_error();
+        continue;
+      }
+      PublicKey public_key;
+      if (EC_POINT_point2oct(group.get(),
+                             key.get(),
+                             POINT_CONVERSION_COMPRESSED,
+                             public_key.data(),
+                             public_key.size(),
+                             ctx.get())
+          == public_key.size()) {
+        keys.push_back(public_key);
+      }
+    }
+    return keys;
+  }
+
+}  // namespace fc::crypto::secp256k1
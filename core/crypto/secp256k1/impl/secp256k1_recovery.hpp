@@ -0,0 +1,29 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_CRYPTO_SECP256K1_IMPL_SECP256K1_RECOVERY_HPP
+#define CPP_FILECOIN_CORE_CRYPTO_SECP256K1_IMPL_SECP256K1_RECOVERY_HPP
+
+#include <vector>
+
+#include "crypto/secp256k1/secp256k1_provider.hpp"
+
+namespace fc::crypto::secp256k1 {
+
+  /**
+   * @brief Recover public keys which may have produced signature, as made by
+   * Secp256k1Provider over SHA2-256 of message. Addresses name only hash of
+   * public key, so key of sender is recovered and matched with address
+   * before signature is verified
+   * @param message - signed data
+   * @param signature - DER encoded signature
+   * @return candidate keys, empty if signature is malformed
+   */
+  std::vector<PublicKey> recoverPublicKeys(gsl::span<const uint8_t> message,
+                                           const Signature &signature);
+
+}  // namespace fc::crypto::secp256k1
+
+#endif  // CPP_FILECOIN_CORE_CRYPTO_SECP256K1_IMPL_SECP256K1_RECOVERY_HPP
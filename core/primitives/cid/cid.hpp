@@ -6,6 +6,7 @@
 #ifndef CPP_FILECOIN_CORE_COMMON_CID_HPP
 #define CPP_FILECOIN_CORE_COMMON_CID_HPP
 
+#include <boost/container_hash/hash.hpp>
 #include <libp2p/multi/content_identifier.hpp>
 
 #include "common/outcome.hpp"
@@ -67,4 +68,16 @@ namespace fc::common {
 
 }  // namespace fc::common
 
+template <>
+struct std::hash<fc::CID> {
+  size_t operator()(const fc::CID &cid) const {
+    const auto &hash = cid.content_address.getHash();
+    auto seed = boost::hash_range(hash.begin(), hash.end());
+    boost::hash_combine(seed, cid.content_address.getType());
+    boost::hash_combine(seed, cid.content_type);
+    boost::hash_combine(seed, cid.version);
+    return seed;
+  }
+};
+
 #endif  // CPP_FILECOIN_CORE_COMMON_CID_HPP
@@ -84,15 +84,26 @@ namespace fc::primitives::tipset {
       ts.blks.push_back(std::move(b));
       ts.cids.push_back(std::move(c));
     }
+    OUTCOME_TRY(key, TipsetKey::create(ts.cids));
+    OUTCOME_TRY(parents_key, TipsetKey::create(ts.blks[0].parents));
+    ts.key = std::move(key);
+    ts.parents_key = std::move(parents_key);
 
     return ts;
   }
 
   outcome::result<TipsetKey> Tipset::getParents() const {
+    // comparing cids is much cheaper than encoding and hashing them
+    if (!blks[0].parents.empty() && parents_key.cids == blks[0].parents) {
+      return parents_key;
+    }
     return TipsetKey::create(blks[0].parents);
   }
 
   outcome::result<TipsetKey> Tipset::makeKey() const {
+    if (!cids.empty() && key.cids == cids) {
+      return key;
+    }
     return TipsetKey::create(cids);
   }
 
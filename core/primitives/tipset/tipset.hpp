@@ -39,12 +39,13 @@ namespace fc::primitives::tipset {
         std::vector<block::BlockHeader> blocks);
 
     /**
-     * @brief makes key of cids
+     * @brief makes key of cids, key cached by create() is reused while cids
+     * are unchanged
      */
     outcome::result<TipsetKey> makeKey() const;
 
     /**
-     * @return key made of parents
+     * @return key made of parents, cached by create() like key of cids
      */
     outcome::result<TipsetKey> getParents() const;
 
@@ -84,6 +85,8 @@ namespace fc::primitives::tipset {
     std::vector<CID> cids;                 ///< cids
     std::vector<block::BlockHeader> blks;  ///< block headers
     uint64_t height{};                     ///< height
+    TipsetKey key;                         ///< cached key of cids
+    TipsetKey parents_key;                 ///< cached key of parents
   };
 
   bool operator==(const Tipset &lhs, const Tipset &rhs);
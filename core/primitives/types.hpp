@@ -17,6 +17,12 @@ namespace fc::primitives {
 
   using TokenAmount = BigInt;
 
+  /**
+   * Amount of gas. Gas counters never leave int64 range, so they are kept as
+   * machine integers instead of heap-capable BigInt
+   */
+  using GasAmount = int64_t;
+
   using TipsetWeight = BigInt;
 
   using SectorSize = uint64_t;
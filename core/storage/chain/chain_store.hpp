@@ -6,6 +6,8 @@
 #ifndef CPP_FILECOIN_CORE_STORAGE_CHAIN_CHAIN_STORE_HPP
 #define CPP_FILECOIN_CORE_STORAGE_CHAIN_CHAIN_STORE_HPP
 
+#include <functional>
+
 #include "crypto/randomness/chain_randomness_provider.hpp"
 #include "primitives/block/block.hpp"
 #include "primitives/tipset/tipset.hpp"
@@ -20,6 +22,8 @@ namespace fc::storage::blockchain {
     using BlockHeader = primitives::block::BlockHeader;
     using ChainRandomnessProvider = crypto::randomness::ChainRandomnessProvider;
     using Randomness = crypto::randomness::Randomness;
+    using HeadChange = primitives::tipset::HeadChange;
+    using HeadChangeHandler = std::function<void(const HeadChange &)>;
     using Tipset = primitives::tipset::Tipset;
     using TipsetKey = primitives::tipset::TipsetKey;
 
@@ -31,6 +35,14 @@ namespace fc::storage::blockchain {
      */
     virtual outcome::result<Tipset> loadTipset(const TipsetKey &key) = 0;
 
+    /**
+     * @brief finds tipset at or before height in ancestry of tipset
+     * @param tipset tipset to look back from
+     * @param height epoch to look back to
+     */
+    virtual outcome::result<Tipset> loadTipsetByHeight(const Tipset &tipset,
+                                                       uint64_t height) = 0;
+
     /** @brief creates chain randomness provider */
     virtual std::shared_ptr<ChainRandomnessProvider>
     createRandomnessProvider() = 0;
@@ -38,10 +50,25 @@ namespace fc::storage::blockchain {
     /** @brief adds block to store */
     virtual outcome::result<void> addBlock(const BlockHeader &block) = 0;
 
+    /**
+     * @brief adds synced chain to store, headers are persisted at once
+     * @param chain complete tipsets, oldest first, each one is parent of next
+     */
+    virtual outcome::result<void> addTipsets(
+        const std::vector<Tipset> &chain) = 0;
+
     /** @brief finds block by its cid */
     virtual outcome::result<BlockHeader> getBlock(const CID &cid) const = 0;
 
     virtual outcome::result<Tipset> heaviestTipset() const = 0;
+
+    /**
+     * @brief subscribes to changes of heaviest chain, handler gets CURRENT
+     * head at once if there is one, then on each head change REVERT of each
+     * abandoned tipset, newest first, and APPLY of each new one, oldest first
+     * @param handler called on thread changing head
+     */
+    virtual void subscribeHeadChanges(HeadChangeHandler handler) = 0;
   };
 
 }  // namespace fc::storage::blockchain
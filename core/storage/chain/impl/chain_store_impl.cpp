@@ -17,10 +17,38 @@ namespace fc::storage::blockchain {
   using crypto::randomness::ChainRandomnessProviderImpl;
   using primitives::block::BlockHeader;
   using primitives::tipset::Tipset;
+  using primitives::tipset::TipsetKey;
 
   namespace {
     const DatastoreKey chain_head_key{DatastoreKey::makeFromString("head")};
     const DatastoreKey genesis_key{DatastoreKey::makeFromString("0")};
+    /// Lowest height from which height index is contiguous up to head
+    const DatastoreKey index_base_key{
+        DatastoreKey::makeFromString("height_base")};
+
+    /// Decoded headers kept in memory
+    constexpr size_t kHeaderCacheSize = 8192;
+    /// Tipsets kept in memory
+    constexpr size_t kTipsetCacheSize = 2048;
+    constexpr size_t kCacheShards = 16;
+    /// Missing height index entries scanned before walking parents instead
+    constexpr uint64_t kMaxIndexGap = 64;
+    /// Heights below highest remembered one whose headers are kept to expand
+    /// tipsets
+    constexpr uint64_t kRememberedHeights = 900;
+
+    DatastoreKey heightKey(uint64_t height) {
+      return DatastoreKey::makeFromString("height/" + std::to_string(height));
+    }
+
+    outcome::result<DatastoreKey> ancestorsKey(const TipsetKey &key) {
+      std::string value{"ancestors/"};
+      for (auto &cid : key.cids) {
+        OUTCOME_TRY(str, cid.toString());
+        value += str + ",";
+      }
+      return DatastoreKey::makeFromString(value);
+    }
   }  // namespace
 
   ChainStoreImpl::ChainStoreImpl(
@@ -31,7 +59,10 @@ namespace fc::storage::blockchain {
       : block_service_{std::move(block_service)},
         data_store_{std::move(data_store)},
         block_validator_{std::move(block_validator)},
-        weight_calculator_{std::move(weight_calculator)} {
+        weight_calculator_{std::move(weight_calculator)},
+        header_cache_{kHeaderCacheSize, kCacheShards},
+        tipset_cache_{kTipsetCacheSize, kCacheShards},
+        links_cache_{kTipsetCacheSize, kCacheShards} {
     logger_ = common::createLogger("chain store");
   }
 
@@ -46,30 +77,235 @@ namespace fc::storage::blockchain {
                        std::move(block_validator),
                        std::move(weight_calculator));
 
-    // TODO (yuraz): FIL-151 initialize notifications
-
     return std::make_shared<ChainStoreImpl>(std::move(tmp));
   }
 
   outcome::result<ChainStoreImpl::Tipset> ChainStoreImpl::loadTipset(
       const primitives::tipset::TipsetKey &key) {
+    if (auto cached = tipset_cache_.get(key)) {
+      return std::move(*cached);
+    }
+
     std::vector<BlockHeader> blocks;
     blocks.reserve(key.cids.size());
-    // TODO (yuraz): FIL-151 check cache
-
     for (auto &cid : key.cids) {
       OUTCOME_TRY(block, getBlock(cid));
       blocks.push_back(std::move(block));
     }
 
-    // TODO(yuraz): FIL-155 add tipset to cache before returning
+    OUTCOME_TRY(tipset, Tipset::create(std::move(blocks)));
+    tipset_cache_.put(key, tipset);
+    return std::move(tipset);
+  }
+
+  outcome::result<Tipset> ChainStoreImpl::loadTipsetByHeight(
+      const Tipset &tipset, uint64_t height) {
+    if (tipset.height <= height) {
+      return tipset;
+    }
+
+    // entries below base may be left from abandoned branch
+    if (index_base_ && height >= *index_base_) {
+      OUTCOME_TRY(tipset_key, tipset.makeKey());
+      OUTCOME_TRY(indexed, getHeightIndex(tipset.height));
+      if (indexed == tipset_key) {
+        // tipset is on the heaviest chain, heights without index entry are
+        // null rounds
+        for (uint64_t h = height, gap = 0;
+             gap < kMaxIndexGap && h >= *index_base_;
+             --h, ++gap) {
+          OUTCOME_TRY(key, getHeightIndex(h));
+          if (key) {
+            return loadTipset(*key);
+          }
+          if (h == 0) {
+            break;
+          }
+        }
+      }
+    }
+
+    return findAncestor(tipset, height);
+  }
+
+  outcome::result<Tipset> ChainStoreImpl::findAncestor(const Tipset &tipset,
+                                                       uint64_t height) {
+    auto current = tipset;
+    while (current.height > height) {
+      OUTCOME_TRY(links, getAncestorLinks(current));
+      // bounds are descending and first one is below current height, so
+      // the last bound not below height makes the longest jump
+      size_t i = 0;
+      while (i + 1 < links.heights.size() && links.heights[i + 1] >= height) {
+        ++i;
+      }
+      OUTCOME_TRY(key, TipsetKey::create(links.tipsets[i]));
+      // ancestor is the highest one at or before bound, so even if it is
+      // below height there are no tipsets between them
+      OUTCOME_TRY(ancestor, loadTipset(key));
+      current = std::move(ancestor);
+    }
+    return std::move(current);
+  }
+
+  outcome::result<boost::optional<AncestorLinks>>
+  ChainStoreImpl::findAncestorLinks(const TipsetKey &key) const {
+    if (auto cached = links_cache_.get(key)) {
+      return std::move(*cached);
+    }
+    OUTCOME_TRY(links_key, ancestorsKey(key));
+    OUTCOME_TRY(has, data_store_->contains(links_key));
+    if (!has) {
+      return boost::none;
+    }
+    OUTCOME_TRY(data, data_store_->get(links_key));
+    OUTCOME_TRY(links,
+                codec::cbor::decode<AncestorLinks>(common::Buffer{
+                    std::vector<uint8_t>{data.begin(), data.end()}}));
+    links_cache_.put(key, links);
+    return std::move(links);
+  }
+
+  outcome::result<AncestorLinks> ChainStoreImpl::getAncestorLinks(
+      const Tipset &tipset) {
+    OUTCOME_TRY(key, tipset.makeKey());
+    OUTCOME_TRY(found, findAncestorLinks(key));
+    if (found) {
+      return std::move(*found);
+    }
+
+    // links are computed from the oldest tipset without them
+    std::vector<TipsetKey> pending;
+    auto current = tipset;
+    while (current.height != 0) {
+      OUTCOME_TRY(parents, current.getParents());
+      OUTCOME_TRY(parent_links, findAncestorLinks(parents));
+      if (parent_links) {
+        break;
+      }
+      OUTCOME_TRY(parent, loadTipset(parents));
+      pending.push_back(std::move(parents));
+      current = std::move(parent);
+    }
+    for (auto it = pending.rbegin(); it != pending.rend(); ++it) {
+      OUTCOME_TRY(ancestor, loadTipset(*it));
+      OUTCOME_TRY(computeAncestorLinks(ancestor));
+    }
+    return computeAncestorLinks(tipset);
+  }
+
+  outcome::result<AncestorLinks> ChainStoreImpl::computeAncestorLinks(
+      const Tipset &tipset) {
+    AncestorLinks links;
+    if (tipset.height != 0) {
+      OUTCOME_TRY(parents, tipset.getParents());
+      OUTCOME_TRY(ancestor, loadTipset(parents));
+      for (uint64_t k = 0;; ++k) {
+        auto bound = ((tipset.height - 1) >> k) << k;
+        if (links.heights.empty() || links.heights.back() != bound) {
+          // bounds decrease, so search continues from previous ancestor
+          OUTCOME_TRY(next, findAncestor(ancestor, bound));
+          ancestor = std::move(next);
+          if (links.tipsets.empty() || links.tipsets.back() != ancestor.cids) {
+            links.heights.push_back(bound);
+            links.tipsets.push_back(ancestor.cids);
+          }
+        }
+        if (bound == 0) {
+          break;
+        }
+      }
+    }
 
-    return Tipset::create(std::move(blocks));
+    OUTCOME_TRY(key, tipset.makeKey());
+    OUTCOME_TRY(links_key, ancestorsKey(key));
+    OUTCOME_TRY(data, codec::cbor::encode(links));
+    OUTCOME_TRY(data_store_->set(
+        links_key,
+        std::string_view{reinterpret_cast<const char *>(data.data()),
+                         data.size()}));
+    links_cache_.put(key, links);
+    return std::move(links);
   }
 
   outcome::result<BlockHeader> ChainStoreImpl::getBlock(const CID &cid) const {
+    if (auto cached = header_cache_.get(cid)) {
+      return std::move(*cached);
+    }
     OUTCOME_TRY(bytes, block_service_->get(cid));
-    return codec::cbor::decode<BlockHeader>(bytes);
+    OUTCOME_TRY(header, codec::cbor::decode<BlockHeader>(bytes));
+    header_cache_.put(cid, header);
+    return std::move(header);
+  }
+
+  outcome::result<boost::optional<TipsetKey>> ChainStoreImpl::getHeightIndex(
+      uint64_t height) const {
+    auto key = heightKey(height);
+    OUTCOME_TRY(has, data_store_->contains(key));
+    if (!has) {
+      return boost::none;
+    }
+    OUTCOME_TRY(buffer, data_store_->get(key));
+    OUTCOME_TRY(cids, codec::json::decodeCidVector(buffer));
+    OUTCOME_TRY(tipset_key, TipsetKey::create(std::move(cids)));
+    return std::move(tipset_key);
+  }
+
+  outcome::result<void> ChainStoreImpl::updateHeightIndex(const Tipset &head,
+                                                          uint64_t old_height) {
+    // entries above new head belong to abandoned branch
+    for (auto h = head.height + 1; h <= old_height; ++h) {
+      OUTCOME_TRY(data_store_->remove(heightKey(h)));
+    }
+
+    // entries at or above base are trusted, below it they are rewritten
+    auto base = index_base_;
+    auto tipset = head;
+    auto lowest = head.height;
+    while (true) {
+      OUTCOME_TRY(tipset_key, tipset.makeKey());
+      OUTCOME_TRY(indexed, getHeightIndex(tipset.height));
+      if (base && tipset.height >= *base && indexed == tipset_key) {
+        // rest of chain is indexed down to base, continue below it
+        lowest = *base;
+        if (*base == 0) {
+          break;
+        }
+        OUTCOME_TRY(base_key, getHeightIndex(*base));
+        if (!base_key) {
+          break;
+        }
+        OUTCOME_TRY(base_tipset, loadTipset(*base_key));
+        tipset = std::move(base_tipset);
+        base = boost::none;
+      } else {
+        OUTCOME_TRY(data, codec::json::encodeCidVector(tipset.cids));
+        OUTCOME_TRY(data_store_->set(heightKey(tipset.height), data));
+        lowest = tipset.height;
+      }
+      if (tipset.height == 0) {
+        break;
+      }
+
+      OUTCOME_TRY(parents, tipset.getParents());
+      auto parent = loadTipset(parents);
+      if (!parent) {
+        // ancestors are not synced yet, lookback below lowest indexed height
+        // falls back to ancestor links
+        break;
+      }
+      // null rounds between parent and tipset
+      for (auto h = parent.value().height + 1; h < tipset.height; ++h) {
+        OUTCOME_TRY(data_store_->remove(heightKey(h)));
+      }
+      tipset = std::move(parent.value());
+    }
+
+    if (index_base_ != lowest) {
+      OUTCOME_TRY(data_store_->set(index_base_key, std::to_string(lowest)));
+      index_base_ = lowest;
+    }
+    return outcome::success();
   }
 
   outcome::result<void> ChainStoreImpl::load() {
@@ -82,6 +318,12 @@ namespace fc::storage::blockchain {
     OUTCOME_TRY(cids, codec::json::decodeCidVector(buffer.value()));
     OUTCOME_TRY(ts_key, primitives::tipset::TipsetKey::create(std::move(cids)));
     OUTCOME_TRY(tipset, loadTipset(ts_key));
+    auto base = data_store_->get(index_base_key);
+    if (base) {
+      index_base_ = std::stoull(base.value());
+    }
+    // builds index for chains stored before it was introduced
+    OUTCOME_TRY(updateHeightIndex(tipset, tipset.height));
     heaviest_tipset_ = std::move(tipset);
 
     return outcome::success();
@@ -103,44 +345,87 @@ namespace fc::storage::blockchain {
   }
 
   outcome::result<void> ChainStoreImpl::addBlock(const BlockHeader &block) {
-    OUTCOME_TRY(persistBlockHeaders({std::ref(block)}));
-    OUTCOME_TRY(tipset, expandTipset(block));
+    OUTCOME_TRY(cids, persistBlockHeaders({std::ref(block)}));
+    OUTCOME_TRY(tipset, expandTipset(block, cids[0]));
+    OUTCOME_TRY(extendAncestorLinks(tipset));
     OUTCOME_TRY(updateHeavierTipset(tipset));
 
     return outcome::success();
   }
 
-  outcome::result<void> ChainStoreImpl::persistBlockHeaders(
+  outcome::result<void> ChainStoreImpl::addTipsets(
+      const std::vector<Tipset> &chain) {
+    if (chain.empty()) {
+      return outcome::success();
+    }
+    std::vector<std::reference_wrapper<const BlockHeader>> headers;
+    for (auto &tipset : chain) {
+      headers.insert(headers.end(), tipset.blks.begin(), tipset.blks.end());
+    }
+    OUTCOME_TRY(persistBlockHeaders(headers));
+    for (auto &tipset : chain) {
+      OUTCOME_TRY(key, tipset.makeKey());
+      tipset_cache_.put(key, tipset);
+      OUTCOME_TRY(extendAncestorLinks(tipset));
+    }
+    // weight grows along chain, so only its head can be heavier
+    OUTCOME_TRY(updateHeavierTipset(chain.back()));
+
+    return outcome::success();
+  }
+
+  outcome::result<std::vector<CID>> ChainStoreImpl::persistBlockHeaders(
       const std::vector<std::reference_wrapper<const BlockHeader>>
           &block_headers) {
+    std::vector<CID> cids;
+    std::vector<std::pair<CID, ipfs::IpfsDatastore::Value>> values;
+    cids.reserve(block_headers.size());
+    values.reserve(block_headers.size());
     for (auto &b : block_headers) {
       OUTCOME_TRY(data, codec::cbor::encode(b));
       OUTCOME_TRY(cid, common::getCidOf(data));
-      OUTCOME_TRY(
-          block_service_->set(std::move(cid), common::Buffer{std::move(data)}));
+      cids.push_back(cid);
+      values.emplace_back(std::move(cid), common::Buffer{std::move(data)});
+    }
+    OUTCOME_TRY(block_service_->setMany(std::move(values)));
+    for (size_t i = 0; i < cids.size(); ++i) {
+      header_cache_.put(cids[i], block_headers[i]);
+      rememberHeader(cids[i], block_headers[i]);
     }
 
-    return outcome::success();
+    return std::move(cids);
+  }
+
+  void ChainStoreImpl::rememberHeader(const CID &cid,
+                                      const BlockHeader &header) {
+    auto &headers = tipsets_[header.height];
+    for (auto &remembered : headers) {
+      if (remembered.first == cid) {
+        return;
+      }
+    }
+    headers.emplace_back(cid, header);
+    while (tipsets_.begin()->first + kRememberedHeights
+           < tipsets_.rbegin()->first) {
+      tipsets_.erase(tipsets_.begin());
+    }
   }
 
   outcome::result<Tipset> ChainStoreImpl::expandTipset(
-      const BlockHeader &block_header) {
+      const BlockHeader &block_header, const CID &block_cid) const {
     std::vector<BlockHeader> all_headers{block_header};
-    if (tipsets_.find(block_header.height) == std::end(tipsets_)) {
+    auto tipsets = tipsets_.find(block_header.height);
+    if (tipsets == tipsets_.end()) {
       return Tipset::create(all_headers);
     }
-    auto &&tipsets = tipsets_[block_header.height];
 
     std::map<primitives::address::Address, bool> inclMiners;
     inclMiners[block_header.miner] = true;
-    OUTCOME_TRY(block_cid, primitives::cid::getCidOfCbor(block_header));
-    for (auto &&c : tipsets) {
+    for (auto &[c, h] : tipsets->second) {
       if (c == block_cid) {
         continue;
       }
 
-      OUTCOME_TRY(h, getBlock(c));
-
       if (inclMiners.find(h.miner) != std::end(inclMiners)) {
         auto &&miner_address = primitives::address::encodeToString(h.miner);
         logger_->warn(
@@ -153,12 +438,30 @@ namespace fc::storage::blockchain {
 
       if (h.parents == block_header.parents) {
         all_headers.push_back(h);
+        inclMiners[h.miner] = true;
       }
     }
 
     return Tipset::create(all_headers);
   }
 
+  outcome::result<void> ChainStoreImpl::extendAncestorLinks(
+      const Tipset &tipset) {
+    // links are cheap to extend while chain is added in order, otherwise
+    // they are computed on first lookback
+    if (tipset.height == 0) {
+      OUTCOME_TRY(computeAncestorLinks(tipset));
+    } else {
+      OUTCOME_TRY(parents, tipset.getParents());
+      OUTCOME_TRY(parent_links, findAncestorLinks(parents));
+      if (parent_links) {
+        OUTCOME_TRY(computeAncestorLinks(tipset));
+      }
+    }
+
+    return outcome::success();
+  }
+
   outcome::result<void> ChainStoreImpl::updateHeavierTipset(
       const Tipset &tipset) {
     OUTCOME_TRY(weight, weight_calculator_->calculateWeight(tipset));
@@ -179,23 +482,68 @@ namespace fc::storage::blockchain {
 
   outcome::result<void> ChainStoreImpl::takeHeaviestTipset(
       const Tipset &tipset) {
-    if (heaviest_tipset_.has_value()) {
-      // TODO(yuraz): FIL-151 notify head change
-      // use lotus implementation for reference
-      // https://github.com/filecoin-project/lotus/blob/955b755055ecf64ce7a9ff8749db4280c737406c/chain/store/store.go#L296
-    } else {
+    if (!heaviest_tipset_.has_value()) {
       logger_->warn("No heaviest tipset found, using provided tipset");
     }
 
     OUTCOME_TRY(cids_json, codec::json::encodeCidVector(tipset.cids));
     logger_->info(
         "New heaviest tipset {} (height={})", cids_json, tipset.height);
+    OUTCOME_TRY(updateHeightIndex(
+        tipset, heaviest_tipset_ ? heaviest_tipset_->height : tipset.height));
+    auto previous = std::move(heaviest_tipset_);
     heaviest_tipset_ = tipset;
     OUTCOME_TRY(writeHead(tipset));
 
+    // subscribers see new head as heaviest tipset
+    if (previous) {
+      OUTCOME_TRY(notifyHeadChange(*previous, tipset));
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> ChainStoreImpl::notifyHeadChange(const Tipset &from,
+                                                         const Tipset &to) {
+    if (head_change_handlers_.empty()) {
+      return outcome::success();
+    }
+    // walk both chains back to common ancestor, like lotus ReorgOps
+    std::vector<Tipset> reverted;
+    std::vector<Tipset> applied;
+    auto left = from;
+    auto right = to;
+    while (left.cids != right.cids) {
+      if (left.height > right.height) {
+        OUTCOME_TRY(parents, left.getParents());
+        reverted.push_back(std::move(left));
+        OUTCOME_TRY(parent, loadTipset(parents));
+        left = std::move(parent);
+      } else {
+        OUTCOME_TRY(parents, right.getParents());
+        applied.push_back(std::move(right));
+        OUTCOME_TRY(parent, loadTipset(parents));
+        right = std::move(parent);
+      }
+    }
+
+    for (const auto &handler : head_change_handlers_) {
+      for (const auto &tipset : reverted) {
+        handler({primitives::tipset::HeadChangeType::REVERT, tipset});
+      }
+      for (auto it = applied.rbegin(); it != applied.rend(); ++it) {
+        handler({primitives::tipset::HeadChangeType::APPLY, *it});
+      }
+    }
     return outcome::success();
   }
 
+  void ChainStoreImpl::subscribeHeadChanges(HeadChangeHandler handler) {
+    if (heaviest_tipset_) {
+      handler({primitives::tipset::HeadChangeType::CURRENT, *heaviest_tipset_});
+    }
+    head_change_handlers_.push_back(std::move(handler));
+  }
+
   std::shared_ptr<fc::crypto::randomness::ChainRandomnessProvider>
   ChainStoreImpl::createRandomnessProvider() {
     return std::make_shared<
@@ -10,7 +10,9 @@
 
 #include "blockchain/block_validator/block_validator.hpp"
 #include "blockchain/weight_calculator.hpp"
+#include "codec/cbor/streams_annotation.hpp"
 #include "common/logger.hpp"
+#include "common/lru_cache.hpp"
 #include "common/outcome.hpp"
 #include "crypto/randomness/chain_randomness_provider.hpp"
 #include "crypto/randomness/randomness_types.hpp"
@@ -29,6 +31,19 @@ namespace fc::storage::blockchain {
     std::vector<CID> secpk;
   };
 
+  /**
+   * @struct AncestorLinks jump pointers of tipset at height h, link k points
+   * to ancestor at or before height ((h - 1) >> k) << k, links with repeated
+   * bound or ancestor are omitted
+   */
+  struct AncestorLinks {
+    /// bounds in descending order
+    std::vector<uint64_t> heights;
+    /// cids of ancestor tipsets
+    std::vector<std::vector<CID>> tipsets;
+  };
+  CBOR_TUPLE(AncestorLinks, heights, tipsets)
+
   enum class ChainStoreError : int {
     NO_MIN_TICKET_BLOCK = 1,
     NO_HEAVIEST_TIPSET,
@@ -57,18 +72,27 @@ namespace fc::storage::blockchain {
 
     outcome::result<Tipset> loadTipset(const TipsetKey &key) override;
 
-    // TODO(yuraz): FIL-151 add notifications
-    // TODO(yuraz): FIL-151 implement items caching to avoid refetching them
+    /**
+     * Tipsets of the heaviest chain are found through persistent height
+     * index down to its contiguous base, others through ancestor links in
+     * O(log n) steps
+     */
+    outcome::result<Tipset> loadTipsetByHeight(const Tipset &tipset,
+                                               uint64_t height) override;
 
     std::shared_ptr<ChainRandomnessProvider> createRandomnessProvider()
         override;
 
     outcome::result<void> addBlock(const BlockHeader &block) override;
 
+    outcome::result<void> addTipsets(const std::vector<Tipset> &chain) override;
+
     outcome::result<BlockHeader> getBlock(const CID &cid) const override;
 
     outcome::result<Tipset> heaviestTipset() const override;
 
+    void subscribeHeadChanges(HeadChangeHandler handler) override;
+
    private:
     ChainStoreImpl(std::shared_ptr<ipfs::IpfsBlockService> block_service,
                    std::shared_ptr<ChainDataStore> data_store,
@@ -77,21 +101,81 @@ namespace fc::storage::blockchain {
 
     outcome::result<void> takeHeaviestTipset(const Tipset &tipset);
 
-    outcome::result<void> persistBlockHeaders(
+    /**
+     * @brief notifies subscribers about change of heaviest chain
+     * @param from previous heaviest tipset
+     * @param to new heaviest tipset
+     */
+    outcome::result<void> notifyHeadChange(const Tipset &from,
+                                           const Tipset &to);
+
+    /**
+     * @brief stores headers in single write, caches them and remembers them
+     * by height
+     * @return cids of headers
+     */
+    outcome::result<std::vector<CID>> persistBlockHeaders(
         const std::vector<std::reference_wrapper<const BlockHeader>>
             &block_headers);
 
-    outcome::result<Tipset> expandTipset(const BlockHeader &block_header);
+    /** @brief adds header to recent heights used to expand tipsets */
+    void rememberHeader(const CID &cid, const BlockHeader &header);
+
+    /** @brief builds tipset of block and its remembered siblings */
+    outcome::result<Tipset> expandTipset(const BlockHeader &block_header,
+                                         const CID &block_cid) const;
+
+    /** @brief computes ancestor links of tipset if its parent has them */
+    outcome::result<void> extendAncestorLinks(const Tipset &tipset);
 
     outcome::result<void> updateHeavierTipset(const Tipset &tipset);
 
+    /** @brief returns key of heaviest chain tipset at exactly height */
+    outcome::result<boost::optional<TipsetKey>> getHeightIndex(
+        uint64_t height) const;
+
+    /**
+     * @brief points height index to heaviest chain ending with head, stops at
+     * first ancestor indexed above base and then extends index below base as
+     * far as ancestors are stored
+     * @param head new heaviest tipset
+     * @param old_height height of previous heaviest tipset
+     */
+    outcome::result<void> updateHeightIndex(const Tipset &head,
+                                            uint64_t old_height);
+
+    /** @brief returns cached or persisted ancestor links of tipset */
+    outcome::result<boost::optional<AncestorLinks>> findAncestorLinks(
+        const TipsetKey &key) const;
+
+    /**
+     * @brief returns ancestor links of tipset, computes and persists them for
+     * tipset and its ancestors if missing
+     */
+    outcome::result<AncestorLinks> getAncestorLinks(const Tipset &tipset);
+
+    /** @brief computes and persists links of tipset whose parent has them */
+    outcome::result<AncestorLinks> computeAncestorLinks(const Tipset &tipset);
+
+    /** @brief follows ancestor links to tipset at or before height */
+    outcome::result<Tipset> findAncestor(const Tipset &tipset, uint64_t height);
+
     std::shared_ptr<ipfs::IpfsBlockService> block_service_;
     std::shared_ptr<ChainDataStore> data_store_;
     std::shared_ptr<BlockValidator> block_validator_;
     std::shared_ptr<WeightCalculator> weight_calculator_;
 
     boost::optional<Tipset> heaviest_tipset_;
-    std::map<uint64_t, std::vector<CID>> tipsets_;
+    /// Height index is contiguous from this height up to heaviest tipset
+    boost::optional<uint64_t> index_base_;
+    /// Headers of recent heights, so siblings are not read from storage
+    std::map<uint64_t, std::vector<std::pair<CID, BlockHeader>>> tipsets_;
+
+    common::ShardedLruCache<CID, BlockHeader> header_cache_;
+    common::ShardedLruCache<TipsetKey, Tipset> tipset_cache_;
+    common::ShardedLruCache<TipsetKey, AncestorLinks> links_cache_;
+
+    std::vector<HeadChangeHandler> head_change_handlers_;
 
     common::Logger logger_;
   };
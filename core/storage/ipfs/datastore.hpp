@@ -52,6 +52,20 @@ namespace fc::storage::ipfs {
      */
     virtual outcome::result<void> remove(const CID &key) = 0;
 
+    /**
+     * @brief associates keys with values, stores that support batches write
+     * them at once
+     * @param values key-value pairs to store
+     * @return success if all values were stored, error otherwise
+     */
+    virtual outcome::result<void> setMany(
+        std::vector<std::pair<CID, Value>> values) {
+      for (auto &value : values) {
+        OUTCOME_TRY(set(value.first, std::move(value.second)));
+      }
+      return outcome::success();
+    }
+
     /**
      * @brief CBOR-serialize value and store
      * @param value - data to serialize and store
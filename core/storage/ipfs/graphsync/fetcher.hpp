@@ -0,0 +1,185 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_GRAPHSYNC_FETCHER_HPP
+#define CPP_FILECOIN_GRAPHSYNC_FETCHER_HPP
+
+#include <deque>
+#include <map>
+
+#include "storage/ipfs/graphsync/graphsync.hpp"
+#include "storage/ipfs/graphsync/ingester.hpp"
+
+namespace fc::storage::ipfs::graphsync {
+
+  /// Fetches DAG from several peers in parallel. Upper levels of DAG are
+  /// fetched block by block and split into subtrees, subtrees are striped
+  /// across peers within per-peer windows of concurrent requests. Subtree
+  /// which fails on one peer is re-requested from another peer. Upper
+  /// level blocks are split after ingester writes them to datastore
+  class Fetcher : public std::enable_shared_from_this<Fetcher> {
+   public:
+    using PeerId = libp2p::peer::PeerId;
+
+    /// Fetch limits
+    struct Config {
+      /// Concurrent requests per peer
+      size_t window = 4;
+
+      /// Peers tried per request before fetch fails
+      size_t max_attempts = 3;
+    };
+
+    /// Returns links of block already received and stored locally
+    using SplitFn =
+        std::function<outcome::result<std::vector<CID>>(const CID &cid)>;
+
+    /// Called once when all subtrees are fetched or fetch fails
+    using DoneCallback = std::function<void(outcome::result<void>)>;
+
+    /// Ctor.
+    /// \param graphsync started graphsync instance, received blocks go
+    /// through its block callback
+    /// \param config fetch limits
+    /// \param ingester ingester of received blocks, optional. If set,
+    /// blocks are split when it is flushed
+    Fetcher(std::shared_ptr<Graphsync> graphsync,
+            Config config,
+            std::shared_ptr<Ingester> ingester = nullptr);
+
+    /// Adds peer to fetch from, may be called during fetch
+    /// \param peer peer ID
+    /// \param address optional network address
+    void addPeer(const PeerId &peer,
+                 boost::optional<libp2p::multi::Multiaddress> address);
+
+    /// Starts fetch, previous fetch is cancelled
+    /// \param root root CID of DAG
+    /// \param split_depth levels of DAG fetched block by block and split
+    /// into subtrees, 0 fetches whole DAG with one request
+    /// \param split returns links of upper level blocks
+    /// \param selector IPLD selector of subtree
+    /// \param callback called when fetch is finished
+    void fetch(const CID &root,
+               size_t split_depth,
+               SplitFn split,
+               std::vector<uint8_t> selector,
+               DoneCallback callback);
+
+    /// Cancels active requests, callback is not called
+    void cancel();
+
+    /// Returns count of requests in flight
+    size_t inFlight() const;
+
+    /// Pauses or resumes making new requests, requests in flight continue.
+    /// Used as backpressure, e.g. by Ingester
+    void setPaused(bool paused);
+
+   private:
+    /// Request of block or subtree
+    struct Task {
+      CID cid;
+
+      /// Level of DAG, subtree is requested when it reaches split depth
+      size_t level = 0;
+
+      /// Peers already tried
+      std::vector<PeerId> tried;
+    };
+
+    /// Peer state
+    struct Peer {
+      PeerId id;
+
+      boost::optional<libp2p::multi::Multiaddress> address;
+
+      /// Requests in flight
+      size_t in_flight = 0;
+
+      /// Peer failed with network error and is not used anymore
+      bool failed = false;
+    };
+
+    /// Request in flight
+    struct Request {
+      Task task;
+      PeerId peer;
+      Subscription subscription;
+    };
+
+    /// Sends queued tasks to peers with free window slots
+    void dispatch();
+
+    /// Picks peer with the least requests in flight not tried by task
+    /// \return peer or nullptr if all suitable peers are busy
+    Peer *pickPeer(const Task &task);
+
+    /// Returns true if task can be sent to some peer, now or later
+    bool hasCandidates(const Task &task) const;
+
+    /// Finds peer state
+    Peer *findPeer(const PeerId &peer);
+
+    /// Request progress callback
+    /// \param id request id
+    /// \param status response status
+    void onProgress(uint64_t id, ResponseStatusCode status);
+
+    /// Request finished with full content
+    void onFetched(Request request);
+
+    /// Queues subtrees of upper level block
+    void split(const Task &task);
+
+    /// Finishes fetch if nothing is left, dispatches queued tasks otherwise
+    void proceed();
+
+    /// Request failed, task is re-queued to another peer if possible
+    void onFailed(Request request, ResponseStatusCode status);
+
+    /// Finishes fetch and calls callback
+    void finish(outcome::result<void> result);
+
+    std::shared_ptr<Graphsync> graphsync_;
+    Config config_;
+    std::shared_ptr<Ingester> ingester_;
+
+    /// Peers in order of addition, ties are resolved in this order
+    std::vector<Peer> peers_;
+
+    /// Tasks waiting for peer
+    std::deque<Task> queue_;
+
+    /// Requests in flight by local id
+    std::map<uint64_t, Request> requests_;
+
+    uint64_t next_request_id_ = 0;
+
+    bool paused_ = false;
+
+    /// Upper level blocks waiting for ingester flush
+    size_t splitting_ = 0;
+
+    /// Incremented on cancel, so that flushes of cancelled fetch are ignored
+    uint64_t generation_ = 0;
+
+    size_t split_depth_ = 0;
+    SplitFn split_;
+    std::vector<uint8_t> selector_;
+    DoneCallback callback_;
+  };
+
+  /// Fetcher errors
+  enum class FetcherError {
+    NO_PEERS = 1,       // no peers to fetch subtree from
+    ATTEMPTS_EXCEEDED,  // subtree failed on max attempts peers
+  };
+
+}  // namespace fc::storage::ipfs::graphsync
+
+OUTCOME_HPP_DECLARE_ERROR(fc::storage::ipfs::graphsync, FetcherError);
+
+#endif  // CPP_FILECOIN_GRAPHSYNC_FETCHER_HPP
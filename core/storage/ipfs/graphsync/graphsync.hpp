@@ -36,7 +36,9 @@ namespace fc::storage::ipfs::graphsync {
 
     virtual ~MerkleDagBridge() = default;
 
-    /// Forwards select call to the service or other backend
+    /// Forwards select call to the service or other backend. Called from
+    /// graphsync worker threads, handler may block while response buffers
+    /// are full
     /// \param cid Root CID
     /// \param selector IPLD selector
     /// \param handler Data handler, returns false if further search is no
@@ -39,6 +39,11 @@ namespace fc::storage::ipfs::graphsync {
     return graphsync_logger;
   }
 
+  std::string cidToLog(const CID &cid) {
+    auto str = cid.toString();
+    return str ? std::move(str.value()) : "<unencodable cid>";
+  }
+
   bool isTerminal(ResponseStatusCode code) {
     return code < 10 || code >= 20;
   }
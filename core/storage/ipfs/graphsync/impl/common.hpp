@@ -33,11 +33,18 @@ namespace fc::storage::ipfs::graphsync {
   /// Using shared ptrs for outgoing raw messages
   using SharedData = std::shared_ptr<const ByteArray>;
 
+  /// Outgoing message as shared segments written one after another, so that
+  /// data blocks are sent without copying them into message buffer
+  using SharedSegments = std::vector<SharedData>;
+
   /// Using libp2p and its peer Ids
   using libp2p::peer::PeerId;
 
   /// Returns shared logger for graphsync modules
   common::Logger logger();
+
+  /// Formats CID for log messages, encoding errors are not fatal
+  std::string cidToLog(const CID &cid);
 }  // namespace fc::storage::ipfs::graphsync
 
 OUTCOME_HPP_DECLARE_ERROR(fc::storage::ipfs::graphsync, Error);
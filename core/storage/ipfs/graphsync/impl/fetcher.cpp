@@ -0,0 +1,280 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/graphsync/fetcher.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include "common.hpp"
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::ipfs::graphsync, FetcherError, e) {
+  using E = fc::storage::ipfs::graphsync::FetcherError;
+  switch (e) {
+    case E::NO_PEERS:
+      return "no peers to fetch from";
+    case E::ATTEMPTS_EXCEEDED:
+      return "fetch attempts exceeded";
+    default:
+      break;
+  }
+  return "unknown error";
+}
+
+namespace fc::storage::ipfs::graphsync {
+
+  namespace {
+    /// Peer is not requested anymore after these errors
+    bool isPeerFailure(ResponseStatusCode status) {
+      return status == RS_TIMEOUT || status == RS_SLOW_STREAM
+             || status == RS_CONNECTION_ERROR || status == RS_CANNOT_CONNECT;
+    }
+  }  // namespace
+
+  Fetcher::Fetcher(std::shared_ptr<Graphsync> graphsync,
+                   Config config,
+                   std::shared_ptr<Ingester> ingester)
+      : graphsync_(std::move(graphsync)),
+        config_(config),
+        ingester_(std::move(ingester)) {
+    assert(graphsync_);
+    assert(config_.window > 0);
+  }
+
+  void Fetcher::addPeer(const PeerId &peer,
+                        boost::optional<libp2p::multi::Multiaddress> address) {
+    if (auto *known = findPeer(peer)) {
+      if (address) {
+        known->address = std::move(address);
+      }
+      known->failed = false;
+    } else {
+      peers_.push_back(Peer{peer, std::move(address)});
+    }
+    if (callback_) {
+      dispatch();
+    }
+  }
+
+  void Fetcher::fetch(const CID &root,
+                      size_t split_depth,
+                      SplitFn split,
+                      std::vector<uint8_t> selector,
+                      DoneCallback callback) {
+    assert(split || split_depth == 0);
+    assert(callback);
+
+    cancel();
+    split_depth_ = split_depth;
+    split_ = std::move(split);
+    selector_ = std::move(selector);
+    callback_ = std::move(callback);
+    queue_.push_back(Task{root});
+    dispatch();
+  }
+
+  void Fetcher::cancel() {
+    queue_.clear();
+    requests_.clear();
+    for (auto &peer : peers_) {
+      peer.in_flight = 0;
+    }
+    splitting_ = 0;
+    ++generation_;
+    callback_ = DoneCallback{};
+  }
+
+  size_t Fetcher::inFlight() const {
+    return requests_.size();
+  }
+
+  void Fetcher::setPaused(bool paused) {
+    paused_ = paused;
+    if (!paused_ && callback_) {
+      dispatch();
+    }
+  }
+
+  Fetcher::Peer *Fetcher::findPeer(const PeerId &peer) {
+    auto it = std::find_if(peers_.begin(), peers_.end(), [&](const Peer &p) {
+      return p.id == peer;
+    });
+    return it == peers_.end() ? nullptr : &*it;
+  }
+
+  bool Fetcher::hasCandidates(const Task &task) const {
+    if (task.tried.size() >= config_.max_attempts) {
+      return false;
+    }
+    return std::any_of(peers_.begin(), peers_.end(), [&](const Peer &peer) {
+      return !peer.failed
+             && std::find(task.tried.begin(), task.tried.end(), peer.id)
+                    == task.tried.end();
+    });
+  }
+
+  Fetcher::Peer *Fetcher::pickPeer(const Task &task) {
+    Peer *best = nullptr;
+    for (auto &peer : peers_) {
+      if (peer.failed || peer.in_flight >= config_.window
+          || std::find(task.tried.begin(), task.tried.end(), peer.id)
+                 != task.tried.end()) {
+        continue;
+      }
+      if (!best || peer.in_flight < best->in_flight) {
+        best = &peer;
+      }
+    }
+    return best;
+  }
+
+  void Fetcher::dispatch() {
+    if (paused_) {
+      return;
+    }
+    // graphsync calls progress callbacks asynchronously, so queue is not
+    // modified while being iterated
+    auto it = queue_.begin();
+    while (it != queue_.end()) {
+      if (!hasCandidates(*it)) {
+        finish(it->tried.empty() ? FetcherError::NO_PEERS
+                                 : FetcherError::ATTEMPTS_EXCEEDED);
+        return;
+      }
+      auto *peer = pickPeer(*it);
+      if (!peer) {
+        ++it;
+        continue;
+      }
+
+      Task task = std::move(*it);
+      it = queue_.erase(it);
+      task.tried.push_back(peer->id);
+      ++peer->in_flight;
+
+      gsl::span<const uint8_t> selector;
+      if (task.level >= split_depth_) {
+        selector = selector_;
+      }
+      CID cid = task.cid;
+      auto id = ++next_request_id_;
+      requests_.emplace(id, Request{std::move(task), peer->id, {}});
+
+      if (logger()->should_log(spdlog::level::trace)) {
+        logger()->trace("fetcher: requesting {} from peer {}",
+                        cidToLog(cid),
+                        peer->id.toBase58().substr(46));
+      }
+
+      auto subscription = graphsync_->makeRequest(
+          peer->id,
+          peer->address,
+          cid,
+          selector,
+          {},
+          [wptr{weak_from_this()}, id](ResponseStatusCode status,
+                                       std::vector<Extension>) {
+            if (auto self = wptr.lock()) {
+              self->onProgress(id, status);
+            }
+          });
+
+      auto request = requests_.find(id);
+      if (request != requests_.end()) {
+        request->second.subscription = std::move(subscription);
+      }
+    }
+  }
+
+  void Fetcher::onProgress(uint64_t id, ResponseStatusCode status) {
+    if (!isTerminal(status)) {
+      return;
+    }
+    auto it = requests_.find(id);
+    if (it == requests_.end()) {
+      return;
+    }
+    Request request = std::move(it->second);
+    requests_.erase(it);
+    if (auto *peer = findPeer(request.peer)) {
+      --peer->in_flight;
+    }
+
+    if (status == RS_FULL_CONTENT) {
+      onFetched(std::move(request));
+    } else {
+      onFailed(std::move(request), status);
+    }
+  }
+
+  void Fetcher::onFetched(Request request) {
+    if (request.task.level >= split_depth_) {
+      proceed();
+      return;
+    }
+    if (!ingester_) {
+      split(request.task);
+      return;
+    }
+    // block may still be verified or batched by ingester workers. Flush
+    // error is not checked, split fails if the block was dropped
+    ++splitting_;
+    ingester_->flush([wptr{weak_from_this()},
+                      generation{generation_},
+                      task{std::move(request.task)}](outcome::result<void>) {
+      auto self = wptr.lock();
+      if (self && self->generation_ == generation) {
+        --self->splitting_;
+        self->split(task);
+      }
+    });
+  }
+
+  void Fetcher::split(const Task &task) {
+    auto links = split_(task.cid);
+    if (!links) {
+      finish(links.error());
+      return;
+    }
+    for (auto &cid : links.value()) {
+      queue_.push_back(Task{std::move(cid), task.level + 1});
+    }
+    proceed();
+  }
+
+  void Fetcher::proceed() {
+    if (queue_.empty() && requests_.empty() && splitting_ == 0) {
+      finish(outcome::success());
+      return;
+    }
+    dispatch();
+  }
+
+  void Fetcher::onFailed(Request request, ResponseStatusCode status) {
+    if (logger()->should_log(spdlog::level::debug)) {
+      logger()->debug("fetcher: {} failed on peer {}, status={}",
+                      cidToLog(request.task.cid),
+                      request.peer.toBase58().substr(46),
+                      statusCodeToString(status));
+    }
+    if (isPeerFailure(status)) {
+      if (auto *peer = findPeer(request.peer)) {
+        peer->failed = true;
+      }
+    }
+    // stragglers go first, they hold back completion
+    queue_.push_front(std::move(request.task));
+    dispatch();
+  }
+
+  void Fetcher::finish(outcome::result<void> result) {
+    auto callback = std::move(callback_);
+    cancel();
+    if (callback) {
+      callback(result);
+    }
+  }
+
+}  // namespace fc::storage::ipfs::graphsync
@@ -9,19 +9,29 @@
 
 #include "local_requests.hpp"
 #include "network/network.hpp"
+#include "remote_requests.hpp"
+#include "storage/ipfs/graphsync/metrics.hpp"
 
 namespace fc::storage::ipfs::graphsync {
 
   GraphsyncImpl::GraphsyncImpl(
       std::shared_ptr<libp2p::Host> host,
-      std::shared_ptr<libp2p::protocol::Scheduler> scheduler)
+      std::shared_ptr<libp2p::protocol::Scheduler> scheduler,
+      std::shared_ptr<Metrics> metrics)
       : scheduler_(scheduler),
-        network_(std::make_shared<Network>(std::move(host), scheduler)),
+        metrics_(metrics ? std::move(metrics) : std::make_shared<Metrics>()),
+        network_(std::make_shared<Network>(
+            std::move(host), scheduler, metrics_)),
         local_requests_(std::make_shared<LocalRequests>(
-            std::move(scheduler),
+            scheduler,
             [this](RequestId request_id, SharedData body) {
               cancelLocalRequest(request_id, std::move(body));
-            })) {}
+            })),
+        remote_requests_(std::make_shared<RemoteRequests>(
+            std::move(scheduler),
+            network_,
+            metrics_,
+            RemoteRequests::Config{})) {}
 
   GraphsyncImpl::~GraphsyncImpl() {
     doStop();
@@ -47,6 +57,7 @@ namespace fc::storage::ipfs::graphsync {
       started_ = false;
       block_cb_ = Graphsync::BlockCallback{};
       dag_.reset();
+      remote_requests_->cancelAll();
       network_->stop();
       local_requests_->cancelAll();
     }
@@ -66,7 +77,18 @@ namespace fc::storage::ipfs::graphsync {
     }
 
     auto newRequest = local_requests_->newRequest(
-        root_cid, selector, extensions, std::move(callback));
+        root_cid,
+        selector,
+        extensions,
+        [metrics{metrics_},
+         started{Metrics::Clock::now()},
+         callback{std::move(callback)}](ResponseStatusCode status,
+                                        std::vector<Extension> extensions) {
+          if (isTerminal(status)) {
+            metrics->observeLocalRequest(started);
+          }
+          callback(status, std::move(extensions));
+        });
 
     if (newRequest.request_id > 0) {
       assert(newRequest.body);
@@ -111,42 +133,11 @@ namespace fc::storage::ipfs::graphsync {
 
   void GraphsyncImpl::onRemoteRequest(const PeerId &from,
                                       Message::Request request) {
-    // TODO make this asynchronous
-
-    bool send_response = true;
-
-    auto data_handler = [&](const CID &cid,
-                            const common::Buffer &data) -> bool {
-      bool data_present = !data.empty();
-
-      if (data_present) {
-        if (!network_->addBlockToResponse(from, request.id, cid, data)) {
-          send_response = false;
-          return false;
-        }
-      }
-
-      return true;
-    };
-
-    auto select_res =
-        dag_->select(request.root_cid, request.selector, data_handler);
-
-    if (!send_response) {
-      // ignore response due to network side
+    if (!started_) {
       return;
     }
 
-    ResponseStatusCode status = RS_REQUEST_FAILED;
-    if (select_res) {
-      if (select_res.value() > 0) {
-        status = RS_FULL_CONTENT;
-      } else {
-        status = RS_NOT_FOUND;
-      }
-    }
-
-    network_->sendResponse(from, request.id, status, request.extensions);
+    remote_requests_->newRequest(dag_, from, std::move(request));
   }
 
   void GraphsyncImpl::cancelLocalRequest(RequestId request_id,
@@ -21,6 +21,7 @@ namespace fc::storage::ipfs::graphsync {
 
   class LocalRequests;
   class Network;
+  class RemoteRequests;
 
   /// Core graphsync component. The central module
   class GraphsyncImpl : public Graphsync,
@@ -30,8 +31,10 @@ namespace fc::storage::ipfs::graphsync {
     /// Ctor.
     /// \param host libp2p host object
     /// \param scheduler libp2p scheduler
+    /// \param metrics metrics to be updated, shared with their consumers
     GraphsyncImpl(std::shared_ptr<libp2p::Host> host,
-                  std::shared_ptr<libp2p::protocol::Scheduler> scheduler);
+                  std::shared_ptr<libp2p::protocol::Scheduler> scheduler,
+                  std::shared_ptr<Metrics> metrics = nullptr);
 
     ~GraphsyncImpl() override;
 
@@ -67,12 +70,18 @@ namespace fc::storage::ipfs::graphsync {
     /// Scheduler for libp2p
     std::shared_ptr<libp2p::protocol::Scheduler> scheduler_;
 
+    /// Graphsync metrics
+    std::shared_ptr<Metrics> metrics_;
+
     /// Network module
     std::shared_ptr<Network> network_;
 
     /// Local requests handling module
     std::shared_ptr<LocalRequests> local_requests_;
 
+    /// Remote requests serving module
+    std::shared_ptr<RemoteRequests> remote_requests_;
+
     /// Interface to MerkleDAG component
     std::shared_ptr<MerkleDagBridge> dag_;
 
@@ -0,0 +1,243 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/graphsync/ingester.hpp"
+
+#include <cassert>
+
+#include <boost/asio/post.hpp>
+
+#include "common.hpp"
+#include "crypto/hasher/hasher.hpp"
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::ipfs::graphsync, IngesterError, e) {
+  using E = fc::storage::ipfs::graphsync::IngesterError;
+  switch (e) {
+    case E::UNSUPPORTED_HASH:
+      return "hash type of CID is not supported";
+    case E::HASH_MISMATCH:
+      return "block data does not match CID";
+    default:
+      break;
+  }
+  return "unknown error";
+}
+
+namespace fc::storage::ipfs::graphsync {
+
+  outcome::result<void> verifyBlock(const CID &cid,
+                                    gsl::span<const uint8_t> data) {
+    using libp2p::multi::HashType;
+    using libp2p::multi::Multihash;
+
+    const auto &expected = cid.content_address;
+    switch (expected.getType()) {
+      case HashType::sha256:
+      case HashType::blake2b_256:
+        if (crypto::Hasher::calculate(expected.getType(), data) == expected) {
+          return outcome::success();
+        }
+        break;
+      case HashType::identity: {
+        auto inlined = Multihash::create(HashType::identity, data);
+        if (inlined && inlined.value() == expected) {
+          return outcome::success();
+        }
+        break;
+      }
+      default:
+        return IngesterError::UNSUPPORTED_HASH;
+    }
+    return IngesterError::HASH_MISMATCH;
+  }
+
+  Ingester::Ingester(std::shared_ptr<boost::asio::io_context> io,
+                     std::shared_ptr<IpfsDatastore> datastore,
+                     Config config,
+                     BackpressureCallback on_backpressure,
+                     ErrorCallback on_error)
+      : io_(std::move(io)),
+        datastore_(std::move(datastore)),
+        config_(config),
+        on_backpressure_(std::move(on_backpressure)),
+        on_error_(std::move(on_error)),
+        pool_(std::make_unique<boost::asio::thread_pool>(config.workers)) {
+    assert(io_);
+    assert(datastore_);
+    assert(on_backpressure_);
+    assert(config_.batch_blocks > 0);
+  }
+
+  Ingester::~Ingester() {
+    pool_->join();
+  }
+
+  Graphsync::BlockCallback Ingester::blockCallback() {
+    return [wptr{weak_from_this()}](CID cid, common::Buffer data) {
+      if (auto self = wptr.lock()) {
+        self->push(std::move(cid), std::move(data));
+      }
+    };
+  }
+
+  void Ingester::push(CID cid, common::Buffer data) {
+    size_t queued_bytes = 0;
+    {
+      std::lock_guard lock{mutex_};
+      ++queued_blocks_;
+      queued_bytes_ += data.size();
+      queued_bytes = queued_bytes_;
+    }
+    boost::asio::post(
+        *pool_, [this, cid{std::move(cid)}, data{std::move(data)}]() mutable {
+          verify(std::move(cid), std::move(data));
+        });
+    updateBackpressure(queued_bytes);
+  }
+
+  void Ingester::flush(FlushCallback callback) {
+    assert(callback);
+    flushes_.push_back(std::move(callback));
+    poll();
+  }
+
+  bool Ingester::full() const {
+    return full_;
+  }
+
+  size_t Ingester::queuedBytes() const {
+    std::lock_guard lock{mutex_};
+    return queued_bytes_;
+  }
+
+  void Ingester::verify(CID cid, common::Buffer data) {
+    auto verified = verifyBlock(cid, data);
+    Batch batch;
+    {
+      std::lock_guard lock{mutex_};
+      if (verified) {
+        batch_.emplace_back(std::move(cid), std::move(data));
+      } else {
+        --queued_blocks_;
+        queued_bytes_ -= data.size();
+        errors_.emplace_back(std::move(cid), verified.error());
+      }
+      batch = takeReadyBatch();
+    }
+    if (!batch.empty()) {
+      write(std::move(batch));
+    } else if (!verified) {
+      notify();
+    }
+  }
+
+  void Ingester::write(Batch batch) {
+    while (!batch.empty()) {
+      std::vector<CID> cids;
+      cids.reserve(batch.size());
+      size_t bytes = 0;
+      for (const auto &[cid, data] : batch) {
+        cids.push_back(cid);
+        bytes += data.size();
+      }
+      outcome::result<void> written = outcome::success();
+      {
+        std::lock_guard lock{write_mutex_};
+        written = datastore_->setMany(std::move(batch));
+      }
+      std::lock_guard lock{mutex_};
+      queued_blocks_ -= cids.size();
+      queued_bytes_ -= bytes;
+      if (!written) {
+        for (auto &cid : cids) {
+          errors_.emplace_back(std::move(cid), written.error());
+        }
+      }
+      // the rest of blocks may have been verified during the write
+      batch = takeReadyBatch();
+    }
+    notify();
+  }
+
+  Ingester::Batch Ingester::takeReadyBatch() {
+    Batch batch;
+    if (batch_.empty()
+        || (batch_.size() < config_.batch_blocks
+            && batch_.size() != queued_blocks_)) {
+      return batch;
+    }
+    batch.swap(batch_);
+    batch_.reserve(config_.batch_blocks);
+    return batch;
+  }
+
+  void Ingester::notify() {
+    {
+      std::lock_guard lock{mutex_};
+      if (poll_posted_) {
+        return;
+      }
+      poll_posted_ = true;
+    }
+    boost::asio::post(*io_, [wptr{weak_from_this()}]() {
+      if (auto self = wptr.lock()) {
+        self->poll();
+      }
+    });
+  }
+
+  void Ingester::poll() {
+    std::vector<std::pair<CID, std::error_code>> errors;
+    size_t queued_blocks = 0;
+    size_t queued_bytes = 0;
+    {
+      std::lock_guard lock{mutex_};
+      poll_posted_ = false;
+      errors.swap(errors_);
+      queued_blocks = queued_blocks_;
+      queued_bytes = queued_bytes_;
+    }
+
+    for (const auto &[cid, error] : errors) {
+      if (logger()->should_log(spdlog::level::warn)) {
+        logger()->warn("ingester: dropped block {}: {}",
+                       cidToLog(cid),
+                       error.message());
+      }
+      if (!flush_error_) {
+        flush_error_ = error;
+      }
+      if (on_error_) {
+        on_error_(cid, error);
+      }
+    }
+
+    if (queued_blocks == 0 && !flushes_.empty()) {
+      auto flushes = std::move(flushes_);
+      flushes_.clear();
+      outcome::result<void> result = outcome::success();
+      if (flush_error_) {
+        result = flush_error_;
+        flush_error_ = {};
+      }
+      for (auto &callback : flushes) {
+        callback(result);
+      }
+    }
+
+    updateBackpressure(queued_bytes);
+  }
+
+  void Ingester::updateBackpressure(size_t queued_bytes) {
+    if (!full_ && queued_bytes > config_.max_queue_bytes) {
+      full_ = true;
+      on_backpressure_(true);
+    } else if (full_ && queued_bytes <= config_.max_queue_bytes / 2) {
+      full_ = false;
+      on_backpressure_(false);
+    }
+  }
+
+}  // namespace fc::storage::ipfs::graphsync
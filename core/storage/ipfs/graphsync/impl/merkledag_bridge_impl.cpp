@@ -5,6 +5,7 @@
 
 #include "merkledag_bridge_impl.hpp"
 
+#include <array>
 #include <cassert>
 
 #include <libp2p/multi/content_identifier_codec.hpp>
@@ -12,6 +13,11 @@
 
 using libp2p::multi::ContentIdentifierCodec;
 
+namespace {
+  /// DAG-CBOR encoded {".": {}}
+  const std::array<uint8_t, 4> kMatcherSelector{0xA1, 0x61, 0x2E, 0xA0};
+}  // namespace
+
 namespace fc::storage::ipfs::graphsync {
 
   std::shared_ptr<MerkleDagBridge> MerkleDagBridge::create(
@@ -30,14 +36,13 @@ namespace fc::storage::ipfs::graphsync {
       gsl::span<const uint8_t> selector,
       std::function<bool(const CID &, const common::Buffer &)> handler) const {
     auto internal_handler =
-        [&handler](std::shared_ptr<const ipld::IPLDNode> node) -> bool {
-      return handler(node->getCID(), node->getRawBytes());
+        [&handler](std::shared_ptr<const ipld::IPLDBlock> block) -> bool {
+      return handler(block->getCID(), block->getRawBytes());
     };
 
+    // request without selector selects only the root, of any codec
     if (selector.empty()) {
-      OUTCOME_TRY(node, service_->getNode(root_cid));
-      internal_handler(node);
-      return 1;
+      selector = kMatcherSelector;
     }
 
     // TODO(???): change MerkleDAG service to accept CID instead of bytes
@@ -0,0 +1,148 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/graphsync/metrics.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+namespace fc::storage::ipfs::graphsync {
+
+  namespace {
+    /// Writes "# TYPE" line of metric
+    void type(std::ostream &out, const char *name, const char *type) {
+      out << "# TYPE " << name << " " << type << "\n";
+    }
+  }  // namespace
+
+  void Metrics::Histogram::observe(Clock::time_point started) {
+    auto seconds =
+        std::chrono::duration<double>(Clock::now() - started).count();
+    auto it = std::lower_bound(
+        kDurationBuckets.begin(), kDurationBuckets.end(), seconds);
+    if (it != kDurationBuckets.end()) {
+      ++buckets[it - kDurationBuckets.begin()];
+    }
+    ++count;
+    sum += seconds;
+  }
+
+  void Metrics::addBytesIn(const PeerId &peer, size_t bytes) {
+    std::lock_guard lock{mutex_};
+    peers_[peer].bytes_in += bytes;
+    total_.bytes_in += bytes;
+  }
+
+  void Metrics::addBytesOut(const PeerId &peer, size_t bytes) {
+    std::lock_guard lock{mutex_};
+    peers_[peer].bytes_out += bytes;
+    total_.bytes_out += bytes;
+  }
+
+  void Metrics::addBlocksIn(const PeerId &peer, size_t count) {
+    std::lock_guard lock{mutex_};
+    peers_[peer].blocks_in += count;
+    total_.blocks_in += count;
+  }
+
+  void Metrics::addBlocksOut(const PeerId &peer, size_t count) {
+    std::lock_guard lock{mutex_};
+    peers_[peer].blocks_out += count;
+    total_.blocks_out += count;
+  }
+
+  void Metrics::setQueueBytes(const PeerId &peer, size_t bytes) {
+    std::lock_guard lock{mutex_};
+    auto &stats = peers_[peer];
+    total_.queue_bytes = total_.queue_bytes - stats.queue_bytes + bytes;
+    stats.queue_bytes = bytes;
+  }
+
+  void Metrics::onPeerClosed(const PeerId &peer, ResponseStatusCode status) {
+    std::lock_guard lock{mutex_};
+    auto it = peers_.find(peer);
+    if (it != peers_.end()) {
+      total_.queue_bytes -= it->second.queue_bytes;
+      peers_.erase(it);
+    }
+    if (status == RS_SLOW_STREAM) {
+      ++slow_stream_disconnects_;
+    }
+  }
+
+  void Metrics::observeLocalRequest(Clock::time_point started) {
+    std::lock_guard lock{mutex_};
+    local_requests_.observe(started);
+  }
+
+  void Metrics::observeRemoteRequest(Clock::time_point started) {
+    std::lock_guard lock{mutex_};
+    remote_requests_.observe(started);
+  }
+
+  void Metrics::observeSelect(Clock::time_point started) {
+    std::lock_guard lock{mutex_};
+    selects_.observe(started);
+  }
+
+  std::string Metrics::toPrometheus() const {
+    std::lock_guard lock{mutex_};
+    std::ostringstream out;
+
+    auto counter = [&](const char *name, uint64_t PeerStats::*field) {
+      type(out, name, "counter");
+      out << name << " " << total_.*field << "\n";
+      for (const auto &[peer, stats] : peers_) {
+        out << name << "{peer=\"" << peer.toBase58() << "\"} "
+            << stats.*field << "\n";
+      }
+    };
+    counter("graphsync_received_bytes_total", &PeerStats::bytes_in);
+    counter("graphsync_sent_bytes_total", &PeerStats::bytes_out);
+    counter("graphsync_received_blocks_total", &PeerStats::blocks_in);
+    counter("graphsync_sent_blocks_total", &PeerStats::blocks_out);
+
+    type(out, "graphsync_queue_bytes", "gauge");
+    out << "graphsync_queue_bytes " << total_.queue_bytes << "\n";
+    for (const auto &[peer, stats] : peers_) {
+      out << "graphsync_queue_bytes{peer=\"" << peer.toBase58() << "\"} "
+          << stats.queue_bytes << "\n";
+    }
+
+    type(out, "graphsync_slow_stream_disconnects_total", "counter");
+    out << "graphsync_slow_stream_disconnects_total "
+        << slow_stream_disconnects_ << "\n";
+
+    // label is either empty or "name=\"value\","
+    auto histogram = [&](const char *name,
+                         const std::string &label,
+                         const Histogram &h) {
+      uint64_t cumulative = 0;
+      for (size_t i = 0; i < kDurationBuckets.size(); ++i) {
+        cumulative += h.buckets[i];
+        out << name << "_bucket{" << label << "le=\"" << kDurationBuckets[i]
+            << "\"} " << cumulative << "\n";
+      }
+      out << name << "_bucket{" << label << "le=\"+Inf\"} " << h.count
+          << "\n";
+      auto labels =
+          label.empty() ? "" : "{" + label.substr(0, label.size() - 1) + "}";
+      out << name << "_sum" << labels << " " << h.sum << "\n";
+      out << name << "_count" << labels << " " << h.count << "\n";
+    };
+    type(out, "graphsync_request_duration_seconds", "histogram");
+    histogram("graphsync_request_duration_seconds",
+              "side=\"local\",",
+              local_requests_);
+    histogram("graphsync_request_duration_seconds",
+              "side=\"remote\",",
+              remote_requests_);
+    type(out, "graphsync_select_duration_seconds", "histogram");
+    histogram("graphsync_select_duration_seconds", "", selects_);
+
+    return out.str();
+  }
+
+}  // namespace fc::storage::ipfs::graphsync
@@ -16,22 +16,22 @@ namespace fc::storage::ipfs::graphsync {
   }
 
   outcome::result<void> InboundEndpoint::addBlockToResponse(
-      int request_id, const CID &cid, const common::Buffer &data) {
+      int request_id, const CID &cid, SharedData data) {
     auto serialized_size = response_builder_.getSerializedSize();
 
-    if (queue_->getState().pending_bytes + serialized_size + data.size()
+    if (queue_->getState().pending_bytes + serialized_size + data->size()
         > max_pending_bytes_) {
       return Error::WRITE_QUEUE_OVERFLOW;
     }
 
-    if (serialized_size + data.size() > kMaxMessageSize) {
+    if (serialized_size + data->size() > kMaxMessageSize) {
       auto res = sendPartialResponse(request_id);
       if (!res) {
         return res;
       }
     }
 
-    response_builder_.addDataBlock(cid, data);
+    response_builder_.addDataBlock(cid, std::move(data));
     return outcome::success();
   }
 
@@ -56,7 +56,7 @@ namespace fc::storage::ipfs::graphsync {
 
   outcome::result<void> InboundEndpoint::sendPartialResponse(int request_id) {
     static const std::vector<Extension> dummy_extensions;
-    return sendResponse(request_id, RS_PARTIAL_CONTENT, dummy_extensions);
+    return sendResponse(request_id, RS_PARTIAL_RESPONSE, dummy_extensions);
   }
 
 }  // namespace fc::storage::ipfs::graphsync
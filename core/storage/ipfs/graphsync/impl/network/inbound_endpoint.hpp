@@ -26,10 +26,10 @@ namespace fc::storage::ipfs::graphsync {
     /// Adds data block to response. Doesn't send unless sending partial
     /// response is needed
     /// \param cid CID of data block
-    /// \param data Raw data
+    /// \param data Raw data, sent without copying
     outcome::result<void> addBlockToResponse(RequestId request_id,
                                              const CID &cid,
-                                             const common::Buffer &data);
+                                             SharedData data);
     /// Sends response via message queue
     /// \param request_id id of request
     /// \param status status code
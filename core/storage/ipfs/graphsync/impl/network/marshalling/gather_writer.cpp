@@ -0,0 +1,76 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "gather_writer.hpp"
+
+#include <cassert>
+
+namespace fc::storage::ipfs::graphsync {
+
+  void GatherWriter::copy(gsl::span<const uint8_t> bytes) {
+    current_.insert(current_.end(), bytes.begin(), bytes.end());
+    size_ += bytes.size();
+  }
+
+  uint8_t *GatherWriter::reserve(size_t size) {
+    auto offset = current_.size();
+    current_.resize(offset + size);
+    size_ += size;
+    return current_.data() + offset;
+  }
+
+  void GatherWriter::varint(uint64_t value) {
+    do {
+      uint8_t byte = value & 0x7F;
+      value >>= 7;
+      if (value != 0) {
+        byte |= 0x80;
+      }
+      current_.push_back(byte);
+      ++size_;
+    } while (value != 0);
+  }
+
+  void GatherWriter::payload(SharedData data) {
+    assert(data);
+    if (data->size() < kMinReferencedPayload) {
+      copy(*data);
+      return;
+    }
+    flush();
+    size_ += data->size();
+    segments_.push_back(std::move(data));
+  }
+
+  size_t GatherWriter::size() const {
+    return size_;
+  }
+
+  SharedSegments GatherWriter::finish() {
+    flush();
+    size_ = 0;
+    SharedSegments segments;
+    segments.swap(segments_);
+    return segments;
+  }
+
+  size_t GatherWriter::varintSize(uint64_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+      value >>= 7;
+      ++size;
+    }
+    return size;
+  }
+
+  void GatherWriter::flush() {
+    if (!current_.empty()) {
+      segments_.push_back(
+          std::make_shared<const ByteArray>(std::move(current_)));
+      current_.clear();
+    }
+  }
+
+}  // namespace fc::storage::ipfs::graphsync
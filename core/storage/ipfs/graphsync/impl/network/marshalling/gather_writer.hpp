@@ -0,0 +1,62 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_GRAPHSYNC_GATHER_WRITER_HPP
+#define CPP_FILECOIN_GRAPHSYNC_GATHER_WRITER_HPP
+
+#include "storage/ipfs/graphsync/impl/common.hpp"
+
+namespace fc::storage::ipfs::graphsync {
+
+  /// Writes message as a list of segments. Small pieces (length prefix,
+  /// protobuf framing, small payloads) are packed into shared buffers,
+  /// large payloads are referenced as they are
+  class GatherWriter {
+   public:
+    /// Payloads of this size and greater are referenced, not copied
+    static constexpr size_t kMinReferencedPayload = 4096;
+
+    /// Appends bytes, copying them
+    /// \param bytes bytes to append
+    void copy(gsl::span<const uint8_t> bytes);
+
+    /// Reserves space in the current segment to be filled by caller
+    /// \param size bytes to reserve
+    /// \return pointer to the reserved space, valid until the next call
+    uint8_t *reserve(size_t size);
+
+    /// Appends unsigned varint
+    void varint(uint64_t value);
+
+    /// Appends payload, references it if large enough
+    /// \param data payload bytes
+    void payload(SharedData data);
+
+    /// Returns bytes written
+    size_t size() const;
+
+    /// Returns segments written and resets the writer
+    SharedSegments finish();
+
+    /// Returns size of unsigned varint
+    static size_t varintSize(uint64_t value);
+
+   private:
+    /// Moves current buffer to segments
+    void flush();
+
+    /// Segments written
+    SharedSegments segments_;
+
+    /// Segment being filled
+    ByteArray current_;
+
+    /// Bytes written
+    size_t size_ = 0;
+  };
+
+}  // namespace fc::storage::ipfs::graphsync
+
+#endif  // CPP_FILECOIN_GRAPHSYNC_GATHER_WRITER_HPP
@@ -24,16 +24,16 @@ namespace fc::storage::ipfs::graphsync {
     /// Returns if there is nothing to send
     bool empty() const;
 
-    /// Returns serialized size of protobuf message
-    size_t getSerializedSize() const;
-
-    /// Serializes message to shared byte buffer
-    outcome::result<SharedData> serialize();
+    /// Returns serialized size of message
+    virtual size_t getSerializedSize() const;
 
     /// Clears all entries added
-    void clear();
+    virtual void clear();
 
    protected:
+    /// Serializes protobuf message to shared byte buffer
+    outcome::result<SharedData> serialize();
+
     /// Protobuf message, reused by derived classes
     std::unique_ptr<pb::Message> pb_msg_; //NOLINT
 
@@ -13,6 +13,8 @@ namespace fc::storage::ipfs::graphsync {
   /// Collects request entries and serializes them to wire protocol
   class RequestBuilder : public MessageBuilder {
    public:
+    using MessageBuilder::serialize;
+
     /// Adds request field to outgoing message
     /// \param request_id id of new or cancelled request
     /// \param root_cid root CID
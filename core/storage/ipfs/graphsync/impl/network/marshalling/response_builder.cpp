@@ -5,7 +5,10 @@
 
 #include "response_builder.hpp"
 
+#include <cassert>
+
 #include "codec/cbor/cbor_encode_stream.hpp"
+#include "gather_writer.hpp"
 
 #include "protobuf/message.pb.h"
 
@@ -13,6 +16,22 @@ namespace fc::storage::ipfs::graphsync {
 
   namespace {
     using codec::cbor::CborEncodeStream;
+
+    // Protobuf keys of length delimited fields: (field number << 3) | 2
+
+    /// Message.data
+    constexpr uint8_t kDataField = (4 << 3) | 2;
+
+    /// Block.prefix
+    constexpr uint8_t kPrefixField = (1 << 3) | 2;
+
+    /// Block.data
+    constexpr uint8_t kBlockDataField = (2 << 3) | 2;
+
+    /// Returns serialized size of length delimited field
+    size_t fieldSize(size_t size) {
+      return 1 + GatherWriter::varintSize(size) + size;
+    }
   }  // namespace
 
   void ResponseBuilder::addResponse(RequestId request_id,
@@ -22,7 +41,7 @@ namespace fc::storage::ipfs::graphsync {
     dst->set_id(request_id);
     dst->set_status(status);
 
-    for (auto extension : extensions) {
+    for (const auto &extension : extensions) {
       dst->mutable_extensions()->insert(
           {std::string(extension.name),
            std::string(extension.data.begin(), extension.data.end())});
@@ -31,16 +50,58 @@ namespace fc::storage::ipfs::graphsync {
     empty_ = false;
   }
 
-  void ResponseBuilder::addDataBlock(const CID &cid,
-                                     const common::Buffer &data) {
-    auto *dst = pb_msg_->add_data();
+  void ResponseBuilder::addDataBlock(const CID &cid, SharedData data) {
+    assert(data);
 
     CborEncodeStream encoder;
     encoder << cid;
     auto d = encoder.data();
-    dst->set_prefix(d.data(), d.size());
-    dst->set_data(data.data(), data.size());
+
+    Block block{ByteArray(d.begin(), d.end()), std::move(data)};
+    blocks_size_ += fieldSize(blockSize(block));
+    blocks_.push_back(std::move(block));
     empty_ = false;
   }
 
+  size_t ResponseBuilder::getSerializedSize() const {
+    return MessageBuilder::getSerializedSize() + blocks_size_;
+  }
+
+  outcome::result<SharedSegments> ResponseBuilder::serialize() {
+    size_t pb_size = pb_msg_->ByteSizeLong();
+
+    GatherWriter writer;
+    writer.varint(pb_size + blocks_size_);
+
+    // protobuf fields may go in any order, so blocks are appended to
+    // serialized message as repeated data field
+    if (!pb_msg_->SerializeToArray(writer.reserve(pb_size), pb_size)) {
+      logger()->error("cannot serialize protobuf message, size={}", pb_size);
+      return Error::MESSAGE_SERIALIZE_ERROR;
+    }
+
+    for (auto &block : blocks_) {
+      writer.varint(kDataField);
+      writer.varint(blockSize(block));
+      writer.varint(kPrefixField);
+      writer.varint(block.prefix.size());
+      writer.copy(block.prefix);
+      writer.varint(kBlockDataField);
+      writer.varint(block.data->size());
+      writer.payload(block.data);
+    }
+
+    return writer.finish();
+  }
+
+  void ResponseBuilder::clear() {
+    MessageBuilder::clear();
+    blocks_.clear();
+    blocks_size_ = 0;
+  }
+
+  size_t ResponseBuilder::blockSize(const Block &block) {
+    return fieldSize(block.prefix.size()) + fieldSize(block.data->size());
+  }
+
 }  // namespace fc::storage::ipfs::graphsync
@@ -10,7 +10,9 @@
 
 namespace fc::storage::ipfs::graphsync {
 
-  /// Collects response entries and serializes them to wire protocol
+  /// Collects response entries and serializes them to wire protocol. Data
+  /// blocks are not copied into protobuf message, they are framed by hand
+  /// and referenced by serialized segments
   class ResponseBuilder : public MessageBuilder {
    public:
     /// Adds response to protobuf message
@@ -21,10 +23,38 @@ namespace fc::storage::ipfs::graphsync {
                      ResponseStatusCode status,
                      const std::vector<Extension> &extensions);
 
-    /// Adds data block to protobuf message
+    /// Adds data block to message
     /// \param cid CID of data block
-    /// \param data Raw data
-    void addDataBlock(const CID &cid, const common::Buffer &data);
+    /// \param data Raw data, referenced until serialized
+    void addDataBlock(const CID &cid, SharedData data);
+
+    /// Returns serialized size of message including data blocks
+    size_t getSerializedSize() const override;
+
+    /// Serializes message to shared segments
+    outcome::result<SharedSegments> serialize();
+
+    /// Clears all entries added
+    void clear() override;
+
+   private:
+    /// Data block added
+    struct Block {
+      /// CBOR encoded CID
+      ByteArray prefix;
+
+      /// Raw data
+      SharedData data;
+    };
+
+    /// Returns serialized size of block message, without field framing
+    static size_t blockSize(const Block &block);
+
+    /// Data blocks, go after protobuf message on the wire
+    std::vector<Block> blocks_;
+
+    /// Serialized size of data block fields
+    size_t blocks_size_ = 0;
   };
 
 }  // namespace fc::storage::ipfs::graphsync
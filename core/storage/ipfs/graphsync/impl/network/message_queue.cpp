@@ -41,6 +41,14 @@ namespace fc::storage::ipfs::graphsync {
     }
   }
 
+  void MessageQueue::enqueue(SharedSegments segments) {
+    // stream is written sequentially, so segments of one message go to wire
+    // without gaps even if enqueued separately
+    for (auto &segment : segments) {
+      enqueue(std::move(segment));
+    }
+  }
+
   void MessageQueue::clear() {
     state_.pending_bytes = 0;
     pending_buffers_.clear();
@@ -49,6 +49,10 @@ namespace fc::storage::ipfs::graphsync {
     /// Enqueues an outgoing message
     void enqueue(SharedData msg);
 
+    /// Enqueues an outgoing message consisting of segments, they are written
+    /// one by one without being joined
+    void enqueue(SharedSegments segments);
+
     /// Clears buffers queue
     void clear();
 
@@ -38,12 +38,12 @@ namespace fc::storage::ipfs::graphsync {
   void MessageReader::onMessageRead(const StreamPtr &stream,
                                     outcome::result<ByteArray> res) {
     if (!res) {
-      return feedback_.onReaderEvent(stream, res.error());
+      return feedback_.onReaderEvent(stream, res.error(), 0);
     }
 
     auto msg_res = parseMessage(res.value());
 
-    feedback_.onReaderEvent(stream, std::move(msg_res));
+    feedback_.onReaderEvent(stream, std::move(msg_res), res.value().size());
   }
 
 }  // namespace fc::storage::ipfs::graphsync
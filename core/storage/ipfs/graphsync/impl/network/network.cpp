@@ -15,12 +15,15 @@
 namespace fc::storage::ipfs::graphsync {
 
   Network::Network(std::shared_ptr<libp2p::Host> host,
-                   std::shared_ptr<libp2p::protocol::Scheduler> scheduler)
+                   std::shared_ptr<libp2p::protocol::Scheduler> scheduler,
+                   std::shared_ptr<Metrics> metrics)
       : host_(std::move(host)),
         scheduler_(std::move(scheduler)),
+        metrics_(std::move(metrics)),
         protocol_id_(kProtocolVersion) {
     assert(host_);
     assert(scheduler_);
+    assert(metrics_);
   }
 
   Network::~Network() {
@@ -118,7 +121,7 @@ namespace fc::storage::ipfs::graphsync {
   bool Network::addBlockToResponse(const PeerId &peer,
                                    RequestId request_id,
                                    const CID &cid,
-                                   const common::Buffer &data) {
+                                   SharedData data) {
     if (!started_) {
       return false;
     }
@@ -128,7 +131,15 @@ namespace fc::storage::ipfs::graphsync {
       return false;
     }
 
-    return ctx->addBlockToResponse(request_id, cid, data);
+    return ctx->addBlockToResponse(request_id, cid, std::move(data));
+  }
+
+  size_t Network::getPendingBytes(const PeerId &peer) {
+    auto ctx = findContext(peer, false);
+    if (!ctx) {
+      return 0;
+    }
+    return ctx->getPendingBytes();
   }
 
   void Network::sendResponse(const PeerId &peer,
@@ -170,7 +181,8 @@ namespace fc::storage::ipfs::graphsync {
     }
 
     if (!ctx && create_if_not_found) {
-      ctx = std::make_shared<PeerContext>(peer, *feedback_, *this, *scheduler_);
+      ctx = std::make_shared<PeerContext>(
+          peer, *feedback_, *this, *scheduler_, metrics_);
       peers_.insert(ctx);
     }
 
@@ -18,13 +18,16 @@ namespace fc::storage::ipfs::graphsync {
 
   /// Network part of graphsync component
   class Network : public std::enable_shared_from_this<Network>,
-                  public PeerToNetworkFeedback {
+                  public PeerToNetworkFeedback,
+                  public ResponseSender {
    public:
     /// Ctor.
     /// \param host libp2p host object
     /// \param scheduler libp2p scheduler
+    /// \param metrics graphsync metrics
     Network(std::shared_ptr<libp2p::Host> host,
-            std::shared_ptr<libp2p::protocol::Scheduler> scheduler);
+            std::shared_ptr<libp2p::protocol::Scheduler> scheduler,
+            std::shared_ptr<Metrics> metrics);
 
     ~Network() override;
 
@@ -56,28 +59,17 @@ namespace fc::storage::ipfs::graphsync {
     /// \param request_body serialized request body
     void cancelRequest(RequestId request_id, SharedData request_body);
 
-    /// Adds data block to response
-    /// \param peer peer ID
-    /// \param request_id request ID
-    /// \param cid CID of the block
-    /// \param data data block, raw bytes
-    /// \return true if block is added to the response body
-    /// and response object itself can be sent
     bool addBlockToResponse(const PeerId &peer,
                             RequestId request_id,
                             const CID &cid,
-                            const common::Buffer &data);
+                            SharedData data) override;
+
+    size_t getPendingBytes(const PeerId &peer) override;
 
-    /// Sends response to peer. Data blocks may be added previously
-    /// to this response
-    /// \param peer peer ID
-    /// \param request_id request ID
-    /// \param status status code
-    /// \param extensions - data for protocol extensions
     void sendResponse(const PeerId &peer,
                       RequestId request_id,
                       ResponseStatusCode status,
-                      const std::vector<Extension> &extensions);
+                      const std::vector<Extension> &extensions) override;
 
    private:
     /// Callback from peer context that it's closed
@@ -118,6 +110,9 @@ namespace fc::storage::ipfs::graphsync {
     /// libp2p scheduler object
     std::shared_ptr<libp2p::protocol::Scheduler> scheduler_;
 
+    /// Graphsync metrics, shared with peer contexts
+    std::shared_ptr<Metrics> metrics_;
+
     /// libp2p peorocol ID
     libp2p::peer::Protocol protocol_id_;
 
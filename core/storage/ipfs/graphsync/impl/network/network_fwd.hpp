@@ -25,6 +25,9 @@ namespace fc::storage::ipfs::graphsync {
   /// PeerContext used by Network component to communicate with any peer
   class PeerContext;
 
+  /// Graphsync metrics
+  class Metrics;
+
   /// PeerContext used by shard ptr only
   using PeerContextPtr = std::shared_ptr<PeerContext>;
 
@@ -67,6 +70,40 @@ namespace fc::storage::ipfs::graphsync {
     virtual void peerClosed(const PeerId &peer, ResponseStatusCode status) = 0;
   };
 
+  /// Network interface used by remote requests module to serve peers
+  class ResponseSender {
+   public:
+    virtual ~ResponseSender() = default;
+
+    /// Adds data block to response
+    /// \param peer peer ID
+    /// \param request_id request ID
+    /// \param cid CID of the block
+    /// \param data data block, raw bytes
+    /// \return true if block is added to the response body
+    /// and response object itself can be sent
+    virtual bool addBlockToResponse(const PeerId &peer,
+                                    RequestId request_id,
+                                    const CID &cid,
+                                    SharedData data) = 0;
+
+    /// Returns bytes enqueued for writing to peer's streams
+    /// \param peer peer ID
+    /// \return pending bytes, 0 if peer is not connected
+    virtual size_t getPendingBytes(const PeerId &peer) = 0;
+
+    /// Sends response to peer. Data blocks may be added previously
+    /// to this response
+    /// \param peer peer ID
+    /// \param request_id request ID
+    /// \param status status code
+    /// \param extensions - data for protocol extensions
+    virtual void sendResponse(const PeerId &peer,
+                              RequestId request_id,
+                              ResponseStatusCode status,
+                              const std::vector<Extension> &extensions) = 0;
+  };
+
   /// Request/response endpoints to PeerContext feedback interface
   class EndpointToPeerFeedback {
    public:
@@ -75,8 +112,10 @@ namespace fc::storage::ipfs::graphsync {
     /// Called on graphsync message received
     /// \param stream libp2p stream
     /// \param message Graphsync message or read error
+    /// \param size message size on the wire, 0 on read errors
     virtual void onReaderEvent(const StreamPtr &stream,
-                               outcome::result<Message> message) = 0;
+                               outcome::result<Message> message,
+                               size_t size) = 0;
 
     /// Called on message is written asynchronously
     /// \param stream libp2p stream
@@ -11,6 +11,7 @@
 #include "message_queue.hpp"
 #include "message_reader.hpp"
 #include "outbound_endpoint.hpp"
+#include "storage/ipfs/graphsync/metrics.hpp"
 
 namespace fc::storage::ipfs::graphsync {
 
@@ -31,12 +32,16 @@ namespace fc::storage::ipfs::graphsync {
   PeerContext::PeerContext(PeerId peer_id,
                            PeerToGraphsyncFeedback &graphsync_feedback,
                            PeerToNetworkFeedback &network_feedback,
-                           libp2p::protocol::Scheduler &scheduler)
+                           libp2p::protocol::Scheduler &scheduler,
+                           std::shared_ptr<Metrics> metrics)
       : peer(std::move(peer_id)),
         str(makeStringRepr(peer)),
         graphsync_feedback_(graphsync_feedback),
         network_feedback_(network_feedback),
-        scheduler_(scheduler) {}
+        scheduler_(scheduler),
+        metrics_(std::move(metrics)) {
+    assert(metrics_);
+  }
 
   // Need to define it here due to unique_ptrs to incomplete types in the header
   PeerContext::~PeerContext() {
@@ -174,6 +179,7 @@ namespace fc::storage::ipfs::graphsync {
     auto res = requests_endpoint_->enqueue(std::move(request_body));
     if (res) {
       local_request_ids_.insert(request_id);
+      updateQueueMetrics();
     } else {
       logger()->error("enqueueRequest: outbound buffers overflow for peer {}",
                       str);
@@ -212,7 +218,7 @@ namespace fc::storage::ipfs::graphsync {
 
   bool PeerContext::addBlockToResponse(RequestId request_id,
                                        const CID &cid,
-                                       const common::Buffer &data) {
+                                       SharedData data) {
     auto it = findResponseSink(request_id);
     if (it == streams_.end()) {
       return false;
@@ -221,7 +227,8 @@ namespace fc::storage::ipfs::graphsync {
 
     createResponseEndpoint(it->first, ctx);
 
-    auto res = ctx.response_endpoint->addBlockToResponse(request_id, cid, data);
+    auto res = ctx.response_endpoint->addBlockToResponse(
+        request_id, cid, std::move(data));
     if (!res) {
       logger()->error(
           "addBlockToResponse: {}, peer={}", res.error().message(), str);
@@ -229,9 +236,21 @@ namespace fc::storage::ipfs::graphsync {
       close(RS_SLOW_STREAM);
       return false;
     }
+    metrics_->addBlocksOut(peer, 1);
+    updateQueueMetrics();
     return true;
   }
 
+  size_t PeerContext::getPendingBytes() const {
+    size_t bytes = 0;
+    for (const auto &[stream, ctx] : streams_) {
+      if (ctx.queue) {
+        bytes += ctx.queue->getState().pending_bytes;
+      }
+    }
+    return bytes;
+  }
+
   void PeerContext::sendResponse(RequestId request_id,
                                  ResponseStatusCode status,
                                  const std::vector<Extension> &extensions) {
@@ -249,7 +268,9 @@ namespace fc::storage::ipfs::graphsync {
       logger()->error("sendResponse: {}, peer={}", res.error().message(), str);
 
       close(RS_SLOW_STREAM);
+      return;
     }
+    updateQueueMetrics();
   }
 
   void PeerContext::close(ResponseStatusCode status) {
@@ -261,6 +282,7 @@ namespace fc::storage::ipfs::graphsync {
 
     close_status_ = status;
     closed_ = true;
+    metrics_->onPeerClosed(peer, status);
     remote_requests_streams_.clear();
     while (!streams_.empty()) {
       auto s = streams_.begin()->first;
@@ -374,11 +396,14 @@ namespace fc::storage::ipfs::graphsync {
   }
 
   void PeerContext::onReaderEvent(const StreamPtr &stream,
-                                  outcome::result<Message> msg_res) {
+                                  outcome::result<Message> msg_res,
+                                  size_t size) {
     if (closed_) {
       return;
     }
 
+    metrics_->addBytesIn(peer, size);
+
     if (!msg_res) {
       logger()->info(
           "stream read error, peer={}, msg={}", str, msg_res.error().message());
@@ -412,6 +437,7 @@ namespace fc::storage::ipfs::graphsync {
       onRequest(stream, item);
     }
 
+    metrics_->addBlocksIn(peer, msg.data.size());
     for (auto &item : msg.data) {
       graphsync_feedback_.onBlock(
           peer, std::move(item.first), std::move(item.second));
@@ -437,7 +463,23 @@ namespace fc::storage::ipfs::graphsync {
       return;
     }
 
-    shiftExpireTime(stream);
+    auto it = streams_.find(stream);
+    if (it != streams_.end()) {
+      auto &ctx = it->second;
+      if (ctx.queue) {
+        auto written = ctx.queue->getState().total_bytes_written;
+        metrics_->addBytesOut(peer, written - ctx.bytes_counted);
+        ctx.bytes_counted = written;
+      }
+      shiftExpireTime(ctx);
+    }
+    updateQueueMetrics();
+  }
+
+  void PeerContext::updateQueueMetrics() {
+    if (!closed_) {
+      metrics_->setQueueBytes(peer, getPendingBytes());
+    }
   }
 
   void PeerContext::shiftExpireTime(PeerContext::StreamCtx &ctx) {
@@ -35,10 +35,12 @@ namespace fc::storage::ipfs::graphsync {
     /// \param graphsync_feedback feedback interface of core module
     /// \param network_feedback feedback interface of network module
     /// \param scheduler libp2p scheduler
+    /// \param metrics graphsync metrics
     PeerContext(PeerId peer_id,
                 PeerToGraphsyncFeedback &graphsync_feedback,
                 PeerToNetworkFeedback &network_feedback,
-                libp2p::protocol::Scheduler &scheduler);
+                libp2p::protocol::Scheduler &scheduler,
+                std::shared_ptr<Metrics> metrics);
 
     /// Dtor.
     ~PeerContext() override;
@@ -89,12 +91,15 @@ namespace fc::storage::ipfs::graphsync {
     /// Adds data block to response
     /// \param request_id request ID
     /// \param cid CID of the block
-    /// \param data data block, raw bytes
+    /// \param data data block, raw bytes, sent without copying
     /// \return true if block is added to the response body
     /// and response object itself can be sent
     bool addBlockToResponse(RequestId request_id,
                             const CID &cid,
-                            const common::Buffer &data);
+                            SharedData data);
+
+    /// Returns bytes enqueued for writing to all streams of this peer
+    size_t getPendingBytes() const;
 
     /// Sends response to peer. Data blocks may be added previously
     /// to this response
@@ -133,6 +138,9 @@ namespace fc::storage::ipfs::graphsync {
       /// Stream which is inactive during some cleanup period is closed
       /// (activity depends on remote peeris well)
       uint64_t expire_time = 0;
+
+      /// Bytes written to stream and counted in metrics
+      size_t bytes_counted = 0;
     };
 
     /// Container for all active streams to/from the peer
@@ -141,8 +149,10 @@ namespace fc::storage::ipfs::graphsync {
     /// Feedback from MessageReader objects
     /// \param stream libp2p stream
     /// \param message Graphsync message or read error
+    /// \param size message size on the wire
     void onReaderEvent(const StreamPtr &stream,
-                       outcome::result<Message> message) override;
+                       outcome::result<Message> message,
+                       size_t size) override;
 
     /// Feedback from endpoints on async write operations
     /// \param stream libp2p stream
@@ -180,6 +190,9 @@ namespace fc::storage::ipfs::graphsync {
     /// \param ctx per stream context
     void createResponseEndpoint(const StreamPtr &stream, StreamCtx &ctx);
 
+    /// Updates queue depth in metrics
+    void updateQueueMetrics();
+
     /// Shifts stream expiration time due to network activity on this stream
     /// \param ctx per stream context
     void shiftExpireTime(StreamCtx &ctx);
@@ -209,6 +222,9 @@ namespace fc::storage::ipfs::graphsync {
     /// Scheduler
     Scheduler &scheduler_;
 
+    /// Graphsync metrics
+    std::shared_ptr<Metrics> metrics_;
+
     /// Outbound address
     boost::optional<libp2p::multi::Multiaddress> connect_to_;
 
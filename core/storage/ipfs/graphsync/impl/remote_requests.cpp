@@ -0,0 +1,397 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "remote_requests.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include <boost/asio/post.hpp>
+
+#include "storage/ipfs/graphsync/extension.hpp"
+#include "storage/ipfs/graphsync/metrics.hpp"
+
+namespace fc::storage::ipfs::graphsync {
+
+  RemoteRequests::RemoteRequests(
+      std::shared_ptr<libp2p::protocol::Scheduler> scheduler,
+      std::shared_ptr<ResponseSender> network,
+      std::shared_ptr<Metrics> metrics,
+      Config config)
+      : scheduler_(std::move(scheduler)),
+        network_(std::move(network)),
+        metrics_(std::move(metrics)),
+        config_(config),
+        round_delay_(config.round_msec),
+        pool_(std::make_unique<boost::asio::thread_pool>(config.workers)) {
+    assert(scheduler_);
+    assert(network_);
+    assert(metrics_);
+    assert(config_.peer_workers > 0);
+    assert(config_.chunk_bytes <= config_.peer_budget);
+    assert(config_.round_msec > 0);
+    assert(config_.round_msec <= config_.idle_round_msec);
+  }
+
+  RemoteRequests::~RemoteRequests() {
+    cancelAll();
+    pool_->join();
+  }
+
+  void RemoteRequests::newRequest(std::shared_ptr<MerkleDagBridge> dag,
+                                  const PeerId &from,
+                                  Message::Request request) {
+    auto serving = std::make_shared<Serving>(Serving{from, std::move(request)});
+    serving->started = Metrics::Clock::now();
+    for (const auto &extension : serving->request.extensions) {
+      if (extension.name == kDontSendCidsProtocol) {
+        auto cids = decodeDontSendCids(extension);
+        if (cids) {
+          serving->dont_send = std::move(cids.value());
+        } else {
+          logger()->debug("ignoring invalid {} extension, peer={}",
+                          kDontSendCidsProtocol,
+                          from.toBase58().substr(46));
+        }
+      }
+    }
+    active_.push_back(serving);
+    {
+      std::lock_guard lock{mutex_};
+      ++sessions_[from].requests;
+      auto &workers = peer_workers_[from];
+      if (workers.running < config_.peer_workers) {
+        ++workers.running;
+        startSelect({std::move(dag), std::move(serving)});
+      } else {
+        workers.waiting.emplace_back(std::move(dag), std::move(serving));
+      }
+    }
+    // idle rounds may be far apart, new request is served right away
+    if (round_delay_ != config_.round_msec) {
+      round_delay_ = config_.round_msec;
+      timer_.cancel();
+      round_scheduled_ = false;
+    }
+    scheduleRound();
+  }
+
+  void RemoteRequests::cancelAll() {
+    {
+      std::lock_guard lock{mutex_};
+      for (auto &serving : active_) {
+        serving->cancelled = true;
+        release(*serving);
+      }
+      sessions_.clear();
+      // running workers finish cancelled selections and release their peers
+      for (auto &workers : peer_workers_) {
+        workers.second.waiting.clear();
+      }
+    }
+    budget_freed_.notify_all();
+    active_.clear();
+    timer_.cancel();
+    round_scheduled_ = false;
+  }
+
+  void RemoteRequests::startSelect(Selection selection) {
+    boost::asio::post(*pool_, [this, selection{std::move(selection)}] {
+      const auto &[dag, serving] = selection;
+      select(dag, serving);
+      std::lock_guard lock{mutex_};
+      auto workers = peer_workers_.find(serving->peer);
+      if (!workers->second.waiting.empty()) {
+        startSelect(std::move(workers->second.waiting.front()));
+        workers->second.waiting.pop_front();
+      } else if (--workers->second.running == 0) {
+        peer_workers_.erase(workers);
+      }
+    });
+  }
+
+  void RemoteRequests::select(const std::shared_ptr<MerkleDagBridge> &dag,
+                              const ServingPtr &serving) {
+    {
+      // request may be cancelled while waiting for worker
+      std::lock_guard lock{mutex_};
+      if (serving->cancelled) {
+        serving->done = true;
+        return;
+      }
+    }
+
+    auto handler = [&](const CID &cid, const common::Buffer &data) -> bool {
+      if (data.empty() || serving->dont_send.count(cid) > 0) {
+        return true;
+      }
+      std::unique_lock lock{mutex_};
+      if (serving->cancelled) {
+        return false;
+      }
+      if (wasSent(serving->peer, cid)) {
+        // written by overlapping request of the same peer
+        serving->skipped.push_back(cid);
+        return true;
+      }
+      if (!fitsBudget(*serving, data.size())) {
+        serving->stalled = true;
+        auto resumed = budget_freed_.wait_for(
+            lock, std::chrono::milliseconds{config_.budget_wait_msec}, [&] {
+              return serving->cancelled || fitsBudget(*serving, data.size());
+            });
+        serving->stalled = false;
+        if (!resumed) {
+          // budget is held by other requests, worker is given to them
+          serving->gave_up = true;
+          return false;
+        }
+      }
+      if (serving->cancelled) {
+        return false;
+      }
+      // the only copy of block, it is referenced by message segments then
+      serving->blocks.emplace_back(
+          cid, std::make_shared<const ByteArray>(data.begin(), data.end()));
+      serving->buffered += data.size();
+      peer_bytes_[serving->peer] += data.size();
+      total_bytes_ += data.size();
+      return true;
+    };
+
+    const auto &request = serving->request;
+    auto started = Metrics::Clock::now();
+    auto select_res = dag->select(request.root_cid, request.selector, handler);
+    metrics_->observeSelect(started);
+
+    std::lock_guard lock{mutex_};
+    serving->done = true;
+    if (serving->gave_up) {
+      serving->status = RS_TRY_AGAIN;
+    } else if (select_res) {
+      serving->status =
+          select_res.value() > 0 ? RS_FULL_CONTENT : RS_NOT_FOUND;
+    }
+  }
+
+  bool RemoteRequests::fitsBudget(const Serving &serving, size_t size) const {
+    // empty buffers always accept one block, so that blocks greater than
+    // budget are not stuck
+    auto peer = peer_bytes_.find(serving.peer);
+    if (peer != peer_bytes_.end() && peer->second > 0
+        && peer->second + size > config_.peer_budget) {
+      return false;
+    }
+    return total_bytes_ == 0 || total_bytes_ + size <= config_.total_budget;
+  }
+
+  std::vector<std::pair<CID, SharedData>> RemoteRequests::takeChunk(
+      Serving &serving) {
+    std::vector<std::pair<CID, SharedData>> chunk;
+    // incomplete chunk is held back unless worker waits for it to be sent
+    if (serving.blocks.empty()
+        || (!serving.done && !serving.stalled
+            && serving.buffered < config_.chunk_bytes)) {
+      return chunk;
+    }
+    size_t bytes = 0;
+    size_t chunk_bytes = 0;
+    while (!serving.blocks.empty() && chunk_bytes < config_.chunk_bytes) {
+      auto &block = serving.blocks.front();
+      auto size = block.second->size();
+      bytes += size;
+      // overlapping request may have written the block since it was buffered
+      if (wasSent(serving.peer, block.first)) {
+        serving.skipped.push_back(block.first);
+      } else {
+        chunk_bytes += size;
+        chunk.push_back(std::move(block));
+      }
+      serving.blocks.pop_front();
+    }
+    serving.buffered -= bytes;
+    total_bytes_ -= bytes;
+    auto peer = peer_bytes_.find(serving.peer);
+    peer->second -= bytes;
+    if (peer->second == 0) {
+      peer_bytes_.erase(peer);
+    }
+    return chunk;
+  }
+
+  void RemoteRequests::release(Serving &serving) {
+    if (serving.buffered == 0) {
+      return;
+    }
+    total_bytes_ -= serving.buffered;
+    auto peer = peer_bytes_.find(serving.peer);
+    peer->second -= serving.buffered;
+    if (peer->second == 0) {
+      peer_bytes_.erase(peer);
+    }
+    serving.buffered = 0;
+    serving.blocks.clear();
+  }
+
+  void RemoteRequests::cancel(Serving &serving) {
+    {
+      std::lock_guard lock{mutex_};
+      serving.cancelled = true;
+      release(serving);
+      endSession(serving.peer);
+    }
+    budget_freed_.notify_all();
+  }
+
+  bool RemoteRequests::wasSent(const PeerId &peer, const CID &cid) const {
+    auto it = sessions_.find(peer);
+    return it != sessions_.end() && it->second.cids.count(cid) > 0;
+  }
+
+  void RemoteRequests::markSent(const PeerId &peer, const CID &cid) {
+    auto it = sessions_.find(peer);
+    if (it == sessions_.end()) {
+      return;
+    }
+    auto &session = it->second;
+    if (!session.cids.insert(cid).second) {
+      return;
+    }
+    session.order.push_back(cid);
+    if (session.order.size() > config_.session_cids) {
+      session.cids.erase(session.order.front());
+      session.order.pop_front();
+    }
+  }
+
+  void RemoteRequests::takeSkipped(Serving &serving,
+                                   std::vector<Extension> &extensions) {
+    ResponseMetadata metadata;
+    {
+      std::lock_guard lock{mutex_};
+      for (auto &cid : serving.skipped) {
+        metadata.emplace_back(std::move(cid), true);
+      }
+      serving.skipped.clear();
+    }
+    if (!metadata.empty()) {
+      extensions.push_back(encodeResponseMetadata(metadata));
+    }
+  }
+
+  void RemoteRequests::endSession(const PeerId &peer) {
+    auto it = sessions_.find(peer);
+    if (it != sessions_.end() && --it->second.requests == 0) {
+      sessions_.erase(it);
+    }
+  }
+
+  void RemoteRequests::sendRound() {
+    round_scheduled_ = false;
+
+    static const std::vector<Extension> no_extensions;
+    const auto now = std::chrono::steady_clock::now();
+    const std::chrono::milliseconds stall_timeout{config_.stall_msec};
+    bool progress = false;
+
+    for (size_t n = active_.size(); n > 0; --n) {
+      auto serving = std::move(active_.front());
+      active_.pop_front();
+      const auto &request = serving->request;
+
+      // peers which don't read fast enough are skipped until their queues
+      // are written, their requests are cancelled if that takes too long
+      if (network_->getPendingBytes(serving->peer) >= config_.peer_budget) {
+        if (!serving->blocked_since) {
+          serving->blocked_since = now;
+        } else if (now - *serving->blocked_since >= stall_timeout) {
+          cancel(*serving);
+          network_->sendResponse(
+              serving->peer, request.id, RS_SLOW_STREAM, no_extensions);
+          metrics_->observeRemoteRequest(serving->started);
+          progress = true;
+          continue;
+        }
+        active_.push_back(std::move(serving));
+        continue;
+      }
+      serving->blocked_since = boost::none;
+
+      std::vector<std::pair<CID, SharedData>> chunk;
+      bool last = false;
+      bool freed = false;
+      {
+        std::lock_guard lock{mutex_};
+        auto buffered = serving->buffered;
+        chunk = takeChunk(*serving);
+        last = serving->done && serving->blocks.empty();
+        freed = serving->buffered < buffered;
+      }
+      if (freed) {
+        budget_freed_.notify_all();
+        progress = true;
+      }
+
+      size_t sent = 0;
+      for (; sent < chunk.size(); ++sent) {
+        auto &[cid, data] = chunk[sent];
+        if (!network_->addBlockToResponse(
+                serving->peer, request.id, cid, std::move(data))) {
+          // cancelled by peer or peer is closed
+          break;
+        }
+      }
+      if (sent > 0) {
+        std::lock_guard lock{mutex_};
+        for (size_t i = 0; i < sent; ++i) {
+          markSent(serving->peer, chunk[i].first);
+        }
+      }
+      if (sent < chunk.size()) {
+        cancel(*serving);
+        metrics_->observeRemoteRequest(serving->started);
+        continue;
+      }
+
+      if (last) {
+        auto extensions = request.extensions;
+        takeSkipped(*serving, extensions);
+        network_->sendResponse(
+            serving->peer, request.id, serving->status, extensions);
+        metrics_->observeRemoteRequest(serving->started);
+        std::lock_guard lock{mutex_};
+        endSession(serving->peer);
+        progress = true;
+        continue;
+      }
+      if (!chunk.empty()) {
+        std::vector<Extension> extensions;
+        takeSkipped(*serving, extensions);
+        network_->sendResponse(
+            serving->peer, request.id, RS_PARTIAL_RESPONSE, extensions);
+      }
+      active_.push_back(std::move(serving));
+    }
+
+    round_delay_ = progress
+                       ? config_.round_msec
+                       : std::min(round_delay_ * 2, config_.idle_round_msec);
+    scheduleRound();
+  }
+
+  void RemoteRequests::scheduleRound() {
+    if (round_scheduled_ || active_.empty()) {
+      return;
+    }
+    round_scheduled_ = true;
+    timer_ = scheduler_->schedule(round_delay_, [wptr{weak_from_this()}]() {
+      auto self = wptr.lock();
+      if (self) {
+        self->sendRound();
+      }
+    });
+  }
+
+}  // namespace fc::storage::ipfs::graphsync
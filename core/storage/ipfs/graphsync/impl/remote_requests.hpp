@@ -0,0 +1,262 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_GRAPHSYNC_REMOTE_REQUESTS_HPP
+#define CPP_FILECOIN_GRAPHSYNC_REMOTE_REQUESTS_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+#include <boost/asio/thread_pool.hpp>
+#include <boost/optional.hpp>
+#include <libp2p/protocol/common/scheduler.hpp>
+
+#include "network/network_fwd.hpp"
+
+namespace fc::storage::ipfs::graphsync {
+
+  /// Remote requests module for graphsync, serves requests made by peers.
+  /// Blocks are selected on worker threads into per-request buffers, and
+  /// buffers are sent in chunks from the scheduler thread, one chunk per
+  /// request per round. Workers wait while buffered bytes of their peer or
+  /// of all requests exceed budgets. Requests of peers whose write queues
+  /// stay over budget are cancelled with RS_SLOW_STREAM, workers waiting
+  /// for budget too long end their requests with RS_TRY_AGAIN, so waiting
+  /// workers always resume. Only a few workers select blocks for one peer
+  /// at once, so slow peer cannot occupy all of them. Blocks listed in
+  /// do-not-send-cids
+  /// extension and blocks already written to peer by its overlapping
+  /// requests are not sent, the latter are listed in response metadata
+  class RemoteRequests : public std::enable_shared_from_this<RemoteRequests> {
+   public:
+    /// Serving limits
+    struct Config {
+      /// Worker threads selecting blocks
+      size_t workers = 2;
+
+      /// Max workers selecting blocks for one peer, further requests of
+      /// peer wait for them
+      size_t peer_workers = 1;
+
+      /// Max bytes buffered or pending write for one peer
+      size_t peer_budget = 8 * 1024 * 1024;
+
+      /// Max bytes buffered for all requests
+      size_t total_budget = 32 * 1024 * 1024;
+
+      /// Blocks sent in one partial response, bytes
+      size_t chunk_bytes = 1024 * 1024;
+
+      /// Interval of sending rounds while chunks are being sent, msec
+      unsigned round_msec = 1;
+
+      /// Max interval of rounds while nothing can be sent, msec. Workers
+      /// cannot wake scheduler thread, so interval of idle rounds doubles up
+      /// to this value instead of polling every round_msec
+      unsigned idle_round_msec = 64;
+
+      /// Time peer's write queue may stay over budget before its requests
+      /// are cancelled, msec
+      unsigned stall_msec = 30000;
+
+      /// Time worker may wait for budget before its request ends with
+      /// RS_TRY_AGAIN, msec
+      unsigned budget_wait_msec = 30000;
+
+      /// CIDs remembered as sent per peer session
+      size_t session_cids = 64 * 1024;
+    };
+
+    RemoteRequests(const RemoteRequests &) = delete;
+    RemoteRequests &operator=(const RemoteRequests &) = delete;
+
+    /// Ctor.
+    /// \param scheduler scheduler
+    /// \param network network module to send responses through
+    /// \param metrics graphsync metrics
+    /// \param config serving limits
+    RemoteRequests(std::shared_ptr<libp2p::protocol::Scheduler> scheduler,
+                   std::shared_ptr<ResponseSender> network,
+                   std::shared_ptr<Metrics> metrics,
+                   Config config);
+
+    /// Cancels active requests and joins workers
+    ~RemoteRequests();
+
+    /// Starts serving request asynchronously
+    /// \param dag MerkleDAG to select blocks from
+    /// \param from requesting peer
+    /// \param request request received from wire
+    void newRequest(std::shared_ptr<MerkleDagBridge> dag,
+                    const PeerId &from,
+                    Message::Request request);
+
+    /// Cancels all requests, called during Graphsync::stop()
+    void cancelAll();
+
+   private:
+    /// Request being served, shared between worker and scheduler threads
+    struct Serving {
+      PeerId peer;
+      Message::Request request;
+
+      /// CIDs requester already has, from do-not-send-cids extension
+      std::set<CID> dont_send;
+
+      /// Time request was received
+      std::chrono::steady_clock::time_point started;
+
+      /// Time since peer's write queue is over budget, accessed from
+      /// scheduler thread
+      boost::optional<std::chrono::steady_clock::time_point> blocked_since;
+
+      /// Selected blocks not yet sent, guarded by mutex_. Blocks are shared
+      /// with network buffers until written
+      std::deque<std::pair<CID, SharedData>> blocks;
+
+      /// Bytes of blocks, guarded by mutex_
+      size_t buffered = 0;
+
+      /// Blocks skipped since the last response because overlapping
+      /// requests wrote them, guarded by mutex_
+      std::vector<CID> skipped;
+
+      /// Worker waits for budget, so buffer is sent even if less than chunk
+      bool stalled = false;
+
+      /// Selection finished, status is final
+      bool done = false;
+
+      /// Request is no longer served, worker stops selection
+      bool cancelled = false;
+
+      /// Worker gave up waiting for budget, request ends with RS_TRY_AGAIN
+      bool gave_up = false;
+
+      /// Terminal status, valid if done
+      ResponseStatusCode status = RS_REQUEST_FAILED;
+    };
+
+    using ServingPtr = std::shared_ptr<Serving>;
+
+    /// Selection waiting for worker
+    using Selection = std::pair<std::shared_ptr<MerkleDagBridge>, ServingPtr>;
+
+    /// Workers selecting blocks for one peer
+    struct PeerWorkers {
+      /// Selections running on workers
+      size_t running = 0;
+
+      /// Selections waiting for one of running ones to finish
+      std::deque<Selection> waiting;
+    };
+
+    /// Blocks written to peer while it has requests being served
+    struct Session {
+      /// Requests being served
+      size_t requests = 0;
+
+      /// CIDs of blocks
+      std::set<CID> cids;
+
+      /// CIDs in order of sending, oldest are forgotten first
+      std::deque<CID> order;
+    };
+
+    /// Posts selection to worker pool, worker takes next selection of the
+    /// same peer when it finishes
+    void startSelect(Selection selection);
+
+    /// Selects blocks of request, runs on worker thread
+    /// \param dag MerkleDAG to select blocks from
+    /// \param serving request state
+    void select(const std::shared_ptr<MerkleDagBridge> &dag,
+                const ServingPtr &serving);
+
+    /// Returns true if block of given size can be buffered, called under lock
+    bool fitsBudget(const Serving &serving, size_t size) const;
+
+    /// Moves next chunk out of request buffer, called under lock
+    /// \return blocks to send, empty if chunk is not ready yet
+    std::vector<std::pair<CID, SharedData>> takeChunk(Serving &serving);
+
+    /// Releases buffered bytes of cancelled request, called under lock
+    void release(Serving &serving);
+
+    /// Cancels request and wakes its worker
+    void cancel(Serving &serving);
+
+    /// Checks if block was written to peer, called under lock
+    bool wasSent(const PeerId &peer, const CID &cid) const;
+
+    /// Marks block as written to peer, called under lock
+    void markSent(const PeerId &peer, const CID &cid);
+
+    /// Moves skipped blocks of request into response metadata extension
+    /// \param extensions response extensions to append to
+    void takeSkipped(Serving &serving, std::vector<Extension> &extensions);
+
+    /// Ends request in peer session, called under lock
+    void endSession(const PeerId &peer);
+
+    /// Sends one chunk of each active request
+    void sendRound();
+
+    /// Schedules the next sending round if needed
+    void scheduleRound();
+
+    /// licp2p scheduler
+    std::shared_ptr<libp2p::protocol::Scheduler> scheduler_;
+
+    /// Network module
+    std::shared_ptr<ResponseSender> network_;
+
+    /// Graphsync metrics
+    std::shared_ptr<Metrics> metrics_;
+
+    /// Serving limits
+    Config config_;
+
+    /// Requests in round-robin order, accessed from scheduler thread
+    std::deque<ServingPtr> active_;
+
+    /// Guards buffers of requests and byte counters
+    std::mutex mutex_;
+
+    /// Notifies workers waiting for budget
+    std::condition_variable budget_freed_;
+
+    /// Buffered bytes per peer
+    std::unordered_map<PeerId, size_t> peer_bytes_;
+
+    /// Buffered bytes of all requests
+    size_t total_bytes_ = 0;
+
+    /// Sessions of peers having requests being served, guarded by mutex_
+    std::unordered_map<PeerId, Session> sessions_;
+
+    /// Workers of peers having selections, guarded by mutex_
+    std::unordered_map<PeerId, PeerWorkers> peer_workers_;
+
+    /// Scheduler's handle, sending round timer
+    libp2p::protocol::Scheduler::Handle timer_;
+
+    /// Indicates that the next round is scheduled
+    bool round_scheduled_ = false;
+
+    /// Delay of the next round, grows while rounds send nothing, msec
+    unsigned round_delay_;
+
+    /// Worker threads
+    std::unique_ptr<boost::asio::thread_pool> pool_;
+  };
+
+}  // namespace fc::storage::ipfs::graphsync
+
+#endif  // CPP_FILECOIN_GRAPHSYNC_REMOTE_REQUESTS_HPP
@@ -0,0 +1,165 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_GRAPHSYNC_INGESTER_HPP
+#define CPP_FILECOIN_GRAPHSYNC_INGESTER_HPP
+
+#include <mutex>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/thread_pool.hpp>
+
+#include "storage/ipfs/datastore.hpp"
+#include "storage/ipfs/graphsync/graphsync.hpp"
+
+namespace fc::storage::ipfs::graphsync {
+
+  /// Checks that block data hashes to multihash of its CID
+  /// \param cid CID of block
+  /// \param data block data
+  /// \return error if hash type is not supported or hash mismatches
+  outcome::result<void> verifyBlock(const CID &cid,
+                                    gsl::span<const uint8_t> data);
+
+  /// Ingests blocks received by graphsync into datastore. Blocks are
+  /// verified against their CIDs on worker threads and verified blocks are
+  /// written in batches. While bytes queued exceed the limit, backpressure
+  /// is signalled so that no new requests are made, it is released when
+  /// queue drains below half of the limit. Blocks become readable from
+  /// datastore when they are written, flush() waits for it. Workers post
+  /// completions to the io context, so nothing is polled while idle
+  class Ingester : public std::enable_shared_from_this<Ingester> {
+   public:
+    /// Ingestion limits
+    struct Config {
+      /// Worker threads hashing blocks
+      size_t workers = 4;
+
+      /// Blocks written to datastore at once
+      size_t batch_blocks = 256;
+
+      /// Bytes queued for verification or writing until backpressure
+      size_t max_queue_bytes = 64 * 1024 * 1024;
+    };
+
+    /// Called on io thread when backpressure is set or released
+    using BackpressureCallback = std::function<void(bool full)>;
+
+    /// Called on io thread for block which failed verification or write,
+    /// the block is dropped
+    using ErrorCallback =
+        std::function<void(const CID &cid, std::error_code error)>;
+
+    /// Called on io thread when queue is drained, with the first error
+    /// since previous flush if any
+    using FlushCallback = std::function<void(outcome::result<void>)>;
+
+    Ingester(const Ingester &) = delete;
+    Ingester &operator=(const Ingester &) = delete;
+
+    /// Ctor.
+    /// \param io io context, all public methods are called on its thread
+    /// \param datastore datastore to write verified blocks to
+    /// \param config ingestion limits
+    /// \param on_backpressure backpressure callback
+    /// \param on_error error callback, optional
+    Ingester(std::shared_ptr<boost::asio::io_context> io,
+             std::shared_ptr<IpfsDatastore> datastore,
+             Config config,
+             BackpressureCallback on_backpressure,
+             ErrorCallback on_error = {});
+
+    /// Joins workers
+    ~Ingester();
+
+    /// Returns callback for Graphsync::start() which pushes blocks here
+    Graphsync::BlockCallback blockCallback();
+
+    /// Queues block for verification and writing
+    void push(CID cid, common::Buffer data);
+
+    /// Calls callback when all queued blocks are written or dropped
+    void flush(FlushCallback callback);
+
+    /// Returns true while backpressure is set
+    bool full() const;
+
+    /// Returns bytes of blocks not yet written or dropped
+    size_t queuedBytes() const;
+
+   private:
+    using Batch = std::vector<std::pair<CID, common::Buffer>>;
+
+    /// Verifies block and adds it to batch, runs on worker thread
+    void verify(CID cid, common::Buffer data);
+
+    /// Writes batches to datastore while they are ready, runs on worker
+    /// thread
+    void write(Batch batch);
+
+    /// Moves batch out if it is full or no other blocks are being
+    /// verified, so that incomplete batch is not left waiting. Called under
+    /// lock
+    Batch takeReadyBatch();
+
+    /// Posts poll() to io thread unless it is already posted, called by
+    /// workers when blocks are written or dropped
+    void notify();
+
+    /// Delivers errors and flushes, updates backpressure
+    void poll();
+
+    /// Sets or releases backpressure
+    /// \param queued_bytes bytes currently queued
+    void updateBackpressure(size_t queued_bytes);
+
+    std::shared_ptr<boost::asio::io_context> io_;
+    std::shared_ptr<IpfsDatastore> datastore_;
+    Config config_;
+    BackpressureCallback on_backpressure_;
+    ErrorCallback on_error_;
+    std::unique_ptr<boost::asio::thread_pool> pool_;
+
+    /// Guards state shared with workers
+    mutable std::mutex mutex_;
+
+    /// Serializes datastore writes
+    std::mutex write_mutex_;
+
+    /// Verified blocks not yet written, guarded by mutex_
+    Batch batch_;
+
+    /// Blocks pushed and not yet written or dropped, guarded by mutex_
+    size_t queued_blocks_ = 0;
+
+    /// Bytes of queued blocks, guarded by mutex_
+    size_t queued_bytes_ = 0;
+
+    /// Dropped blocks not yet reported, guarded by mutex_
+    std::vector<std::pair<CID, std::error_code>> errors_;
+
+    /// poll() is posted and has not started yet, guarded by mutex_
+    bool poll_posted_ = false;
+
+    /// First error since previous flush
+    std::error_code flush_error_;
+
+    /// Flushes waiting for queue to drain
+    std::vector<FlushCallback> flushes_;
+
+    bool full_ = false;
+  };
+
+  /// Ingester errors
+  enum class IngesterError {
+    UNSUPPORTED_HASH = 1,  // hash type of CID is not supported
+    HASH_MISMATCH,         // block data does not match CID
+  };
+
+}  // namespace fc::storage::ipfs::graphsync
+
+OUTCOME_HPP_DECLARE_ERROR(fc::storage::ipfs::graphsync, IngesterError);
+
+#endif  // CPP_FILECOIN_GRAPHSYNC_INGESTER_HPP
@@ -0,0 +1,99 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_GRAPHSYNC_METRICS_HPP
+#define CPP_FILECOIN_GRAPHSYNC_METRICS_HPP
+
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+
+#include "storage/ipfs/graphsync/graphsync.hpp"
+
+namespace fc::storage::ipfs::graphsync {
+
+  /// Graphsync metrics, updated from scheduler and worker threads and
+  /// rendered in Prometheus text format. Blocks per second are rates of
+  /// block counters
+  class Metrics {
+   public:
+    using PeerId = libp2p::peer::PeerId;
+    using Clock = std::chrono::steady_clock;
+
+    /// Upper bounds of duration histogram buckets, seconds
+    static constexpr std::array<double, 10> kDurationBuckets{
+        0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5, 10, 60};
+
+    /// Counts bytes of messages received from peer
+    void addBytesIn(const PeerId &peer, size_t bytes);
+
+    /// Counts bytes written to peer's streams
+    void addBytesOut(const PeerId &peer, size_t bytes);
+
+    /// Counts data blocks received from peer
+    void addBlocksIn(const PeerId &peer, size_t count);
+
+    /// Counts data blocks sent to peer
+    void addBlocksOut(const PeerId &peer, size_t count);
+
+    /// Sets bytes enqueued for writing to peer's streams
+    void setQueueBytes(const PeerId &peer, size_t bytes);
+
+    /// Forgets peer stats, counts slow stream disconnects
+    /// \param peer peer ID
+    /// \param status close reason
+    void onPeerClosed(const PeerId &peer, ResponseStatusCode status);
+
+    /// Observes duration of request made by this node
+    void observeLocalRequest(Clock::time_point started);
+
+    /// Observes duration of request served by this node
+    void observeRemoteRequest(Clock::time_point started);
+
+    /// Observes duration of selector traversal
+    void observeSelect(Clock::time_point started);
+
+    /// Renders metrics in Prometheus text exposition format
+    std::string toPrometheus() const;
+
+   private:
+    /// Stats of connected peer
+    struct PeerStats {
+      uint64_t bytes_in = 0;
+      uint64_t bytes_out = 0;
+      uint64_t blocks_in = 0;
+      uint64_t blocks_out = 0;
+      uint64_t queue_bytes = 0;
+    };
+
+    /// Histogram of durations
+    struct Histogram {
+      /// Counts of observations per bucket, not cumulative
+      std::array<uint64_t, kDurationBuckets.size()> buckets{};
+      uint64_t count = 0;
+      double sum = 0;
+
+      void observe(Clock::time_point started);
+    };
+
+    mutable std::mutex mutex_;
+
+    /// Stats of connected peers
+    std::unordered_map<PeerId, PeerStats> peers_;
+
+    /// Totals of all peers, including disconnected
+    PeerStats total_;
+
+    uint64_t slow_stream_disconnects_ = 0;
+
+    Histogram local_requests_;
+    Histogram remote_requests_;
+    Histogram selects_;
+  };
+
+}  // namespace fc::storage::ipfs::graphsync
+
+#endif  // CPP_FILECOIN_GRAPHSYNC_METRICS_HPP
@@ -0,0 +1,70 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/cid_bloom_filter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <string_view>
+
+namespace fc::storage::ipfs {
+
+  namespace {
+    /// Two base hashes of CID, combined as h1 + i * h2 for i-th function
+    std::pair<uint64_t, uint64_t> baseHashes(const CID &cid) {
+      const auto &digest = cid.content_address.getHash();
+      uint64_t h1{}, h2{};
+      if (static_cast<size_t>(digest.size()) >= 2 * sizeof(uint64_t)) {
+        std::memcpy(&h1, digest.data(), sizeof(h1));
+        std::memcpy(&h2, digest.data() + sizeof(h1), sizeof(h2));
+      } else {
+        // identity and short digests are not uniform, so they are hashed
+        h1 = std::hash<std::string_view>{}(
+            {reinterpret_cast<const char *>(digest.data()),
+             static_cast<size_t>(digest.size())});
+        h2 = (h1 >> 32) | (h1 << 32);
+      }
+      h1 ^= static_cast<uint64_t>(cid.content_type);
+      // odd step visits distinct positions, as count of bits is power of two
+      return {h1, h2 | 1};
+    }
+  }  // namespace
+
+  CidBloomFilter::CidBloomFilter(size_t expected, double false_positive_rate) {
+    const double ln2 = std::log(2.0);
+    auto n = static_cast<double>(std::max<size_t>(expected, 1));
+    auto bits = -n * std::log(false_positive_rate) / (ln2 * ln2);
+    hashes_ = std::max<size_t>(std::lround(bits / n * ln2), 1);
+    // power of two bits, positions are taken by mask
+    size_t rounded = 64;
+    while (rounded < bits) {
+      rounded *= 2;
+    }
+    mask_ = rounded - 1;
+    words_.resize(rounded / 64);
+  }
+
+  void CidBloomFilter::insert(const CID &cid) {
+    auto [h1, h2] = baseHashes(cid);
+    for (size_t i = 0; i < hashes_; ++i) {
+      auto bit = (h1 + i * h2) & mask_;
+      words_[bit / 64] |= uint64_t{1} << (bit % 64);
+    }
+  }
+
+  bool CidBloomFilter::mayContain(const CID &cid) const {
+    auto [h1, h2] = baseHashes(cid);
+    for (size_t i = 0; i < hashes_; ++i) {
+      auto bit = (h1 + i * h2) & mask_;
+      if ((words_[bit / 64] & (uint64_t{1} << (bit % 64))) == 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+}  // namespace fc::storage::ipfs
@@ -0,0 +1,45 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_STORAGE_IPFS_CID_BLOOM_FILTER_HPP
+#define CPP_FILECOIN_STORAGE_IPFS_CID_BLOOM_FILTER_HPP
+
+#include <vector>
+
+#include "primitives/cid/cid.hpp"
+
+namespace fc::storage::ipfs {
+
+  /**
+   * @brief Bloom filter of CIDs. Bit positions are derived from multihash
+   * digest of CID, which is already uniformly distributed
+   */
+  class CidBloomFilter {
+   public:
+    /**
+     * @param expected - expected count of CIDs
+     * @param false_positive_rate - false positive rate at expected count
+     */
+    CidBloomFilter(size_t expected, double false_positive_rate);
+
+    /// Adds CID to filter
+    void insert(const CID &cid);
+
+    /// Returns false if CID was never added, true if it was probably added
+    bool mayContain(const CID &cid) const;
+
+   private:
+    std::vector<uint64_t> words_;
+
+    /// Count of bits minus one, count is power of two
+    uint64_t mask_;
+
+    /// Count of hash functions
+    size_t hashes_;
+  };
+
+}  // namespace fc::storage::ipfs
+
+#endif  // CPP_FILECOIN_STORAGE_IPFS_CID_BLOOM_FILTER_HPP
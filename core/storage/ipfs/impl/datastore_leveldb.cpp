@@ -60,4 +60,26 @@ namespace fc::storage::ipfs {
     return leveldb_->remove(encoded_key);
   }
 
+  outcome::result<void> LeveldbDatastore::setMany(
+      std::vector<std::pair<CID, Value>> values) {
+    auto batch = leveldb_->batch();
+    for (auto &value : values) {
+      OUTCOME_TRY(encoded_key, encode(value.first));
+      OUTCOME_TRY(batch->put(encoded_key, std::move(value.second)));
+    }
+    return batch->commit();
+  }
+
+  void LeveldbDatastore::forEachCid(
+      const std::function<void(const CID &)> &visitor) const {
+    auto cursor = leveldb_->cursor();
+    for (cursor->seekToFirst(); cursor->isValid(); cursor->next()) {
+      auto decoded =
+          libp2p::multi::ContentIdentifierCodec::decode(cursor->key());
+      if (decoded) {
+        visitor(CID{std::move(decoded.value())});
+      }
+    }
+  }
+
 }  // namespace fc::storage::ipfs
@@ -6,6 +6,7 @@
 #ifndef CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_DATASTORE_LEVELDB_HPP
 #define CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_DATASTORE_LEVELDB_HPP
 
+#include <functional>
 #include <memory>
 
 #include "common/outcome.hpp"
@@ -45,6 +46,17 @@ namespace fc::storage::ipfs {
 
     outcome::result<void> remove(const CID &key) override;
 
+    /** @brief writes values in single leveldb write batch */
+    outcome::result<void> setMany(
+        std::vector<std::pair<CID, Value>> values) override;
+
+    /**
+     * @brief visits CIDs of stored values, keys which are not CIDs are
+     * skipped
+     * @param visitor called for each CID
+     */
+    void forEachCid(const std::function<void(const CID &)> &visitor) const;
+
    private:
     std::shared_ptr<LevelDB> leveldb_;  ///< underlying db wrapper
   };
@@ -5,30 +5,149 @@
 
 #include "storage/ipfs/impl/ipfs_block_service.hpp"
 
+#include <algorithm>
+
 namespace fc::storage::ipfs {
-  IpfsBlockService::IpfsBlockService(std::shared_ptr<IpfsDatastore> data_store)
-      : local_storage_{std::move(data_store)} {
+  namespace {
+    /// False positive rate of filter of stored blocks
+    constexpr double kFalsePositiveRate = 0.01;
+  }  // namespace
+
+  IpfsBlockService::IpfsBlockService(std::shared_ptr<IpfsDatastore> data_store,
+                                     size_t expected_blocks,
+                                     size_t max_marks)
+      : local_storage_{std::move(data_store)},
+        capacity_{std::max<size_t>(expected_blocks, 1)},
+        max_marks_{max_marks} {
+    stored_.emplace_back(capacity_, kFalsePositiveRate);
     BOOST_ASSERT_MSG(local_storage_ != nullptr,
                      "IPFS block service: invalid local storage");
   }
 
   outcome::result<bool> IpfsBlockService::contains(const CID &key) const {
-    return local_storage_->contains(key);
+    OUTCOME_TRY(found, local_storage_->contains(key));
+    if (found) {
+      std::lock_guard lock{mutex_};
+      insertStored(key);
+    }
+    return found;
   }
 
   outcome::result<void> IpfsBlockService::set(const CID &key, Value value) {
-    auto result = local_storage_->set(key, std::move(value));
-    if (result.has_error()) return result.error();
+    // blocks are content addressed, stored block is not written again
+    OUTCOME_TRY(stored, isStored(key));
+    if (!stored) {
+      OUTCOME_TRY(local_storage_->set(key, std::move(value)));
+    }
+    markStored(key);
     return outcome::success();
   }
 
   outcome::result<IpfsBlockService::Value> IpfsBlockService::get(
       const CID &key) const {
     OUTCOME_TRY(data, local_storage_->get(key));
+    {
+      std::lock_guard lock{mutex_};
+      insertStored(key);
+    }
     return std::move(data);
   }
 
   outcome::result<void> IpfsBlockService::remove(const CID &key) {
+    {
+      // filter keeps key, datastore is asked next time it is set
+      std::lock_guard lock{mutex_};
+      marks_.erase(key);
+    }
     return local_storage_->remove(key);
   }
+
+  outcome::result<void> IpfsBlockService::setMany(
+      std::vector<std::pair<CID, Value>> values) {
+    std::vector<std::pair<CID, Value>> missing;
+    for (auto &value : values) {
+      OUTCOME_TRY(stored, isStored(value.first));
+      if (!stored) {
+        missing.emplace_back(value.first, std::move(value.second));
+      }
+    }
+    if (!missing.empty()) {
+      OUTCOME_TRY(local_storage_->setMany(std::move(missing)));
+    }
+    for (const auto &value : values) {
+      markStored(value.first);
+    }
+    return outcome::success();
+  }
+
+  void IpfsBlockService::seedStored(const CID &key) {
+    std::lock_guard lock{mutex_};
+    insertStored(key);
+  }
+
+  uint64_t IpfsBlockService::nextGeneration() {
+    std::lock_guard lock{mutex_};
+    return ++generation_;
+  }
+
+  std::vector<CID> IpfsBlockService::takeMarkedBefore(uint64_t generation) {
+    std::vector<CID> cids;
+    std::lock_guard lock{mutex_};
+    for (auto it = marks_.begin(); it != marks_.end();) {
+      if (it->second < generation) {
+        cids.push_back(it->first);
+        it = marks_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    return cids;
+  }
+
+  outcome::result<bool> IpfsBlockService::isStored(const CID &key) const {
+    {
+      std::lock_guard lock{mutex_};
+      if (!mayBeStored(key)) {
+        return false;
+      }
+    }
+    return local_storage_->contains(key);
+  }
+
+  bool IpfsBlockService::mayBeStored(const CID &key) const {
+    for (const auto &filter : stored_) {
+      if (filter.mayContain(key)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void IpfsBlockService::insertStored(const CID &key) const {
+    if (mayBeStored(key)) {
+      return;
+    }
+    if (inserted_ >= capacity_) {
+      capacity_ *= 2;
+      inserted_ = 0;
+      stored_.emplace_back(capacity_, kFalsePositiveRate);
+    }
+    stored_.back().insert(key);
+    ++inserted_;
+  }
+
+  void IpfsBlockService::markStored(const CID &key) {
+    std::lock_guard lock{mutex_};
+    insertStored(key);
+    if (generation_ == 0) {
+      return;
+    }
+    // unmarked blocks are never candidates, so skipping marks is safe
+    auto mark = marks_.find(key);
+    if (mark != marks_.end()) {
+      mark->second = generation_;
+    } else if (marks_.size() < max_marks_) {
+      marks_.emplace(key, generation_);
+    }
+  }
 }  // namespace fc::storage::ipfs
@@ -6,18 +6,38 @@
 #ifndef FILECOIN_STORAGE_IPFS_BLOCKSERVICE_IMPL_HPP
 #define FILECOIN_STORAGE_IPFS_BLOCKSERVICE_IMPL_HPP
 
+#include <map>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "storage/ipfs/datastore.hpp"
+#include "storage/ipfs/impl/cid_bloom_filter.hpp"
 
 namespace fc::storage::ipfs {
   class IpfsBlockService : public IpfsDatastore {
    public:
+    /// Default expected count of blocks for filter of stored blocks
+    static constexpr size_t kDefaultExpectedBlocks = 1 << 20;
+
+    /// Default max count of blocks marked with generations
+    static constexpr size_t kDefaultMaxMarks = 1 << 20;
+
     /**
-     * @brief Construct IPFS storage
+     * @brief Construct IPFS storage. Blocks already stored, as probably
+     * stored by filter, are not written again. Filter starts empty, so
+     * blocks stored before are written again once unless filter is seeded.
+     * When more blocks than expected are added, filter of twice the size is
+     * stacked on top, so false positive rate stays bounded
      * @param data_store - IPFS storage implementation
+     * @param expected_blocks - expected count of blocks, sizes first filter
+     * of stored blocks
+     * @param max_marks - max count of marked blocks
      */
-    explicit IpfsBlockService(std::shared_ptr<IpfsDatastore> data_store);
+    explicit IpfsBlockService(
+        std::shared_ptr<IpfsDatastore> data_store,
+        size_t expected_blocks = kDefaultExpectedBlocks,
+        size_t max_marks = kDefaultMaxMarks);
 
     outcome::result<bool> contains(const CID &key) const override;
 
@@ -27,8 +47,75 @@ namespace fc::storage::ipfs {
 
     outcome::result<void> remove(const CID &key) override;
 
+    outcome::result<void> setMany(
+        std::vector<std::pair<CID, Value>> values) override;
+
+    /**
+     * @brief Add block stored before to filter of stored blocks, e.g. keys
+     * of persistent datastore on startup
+     * @param key - block CID
+     */
+    void seedStored(const CID &key);
+
+    /**
+     * @brief Start new generation of marks, blocks set from now on are
+     * marked with it, including blocks which are already stored. Blocks
+     * are not marked until first generation is started. Marks are kept in
+     * memory, blocks not marked in this process or set while max count of
+     * marks is reached are never taken as candidates
+     * @return new generation
+     */
+    uint64_t nextGeneration();
+
+    /**
+     * @brief Take blocks last marked before given generation, their marks
+     * are forgotten. Blocks are candidates for collection, caller checks
+     * that they are unreachable before removing them
+     * @param generation - generation to compare marks with
+     * @return CIDs of blocks
+     */
+    std::vector<CID> takeMarkedBefore(uint64_t generation);
+
    private:
+    /**
+     * @brief Check block existence, datastore is asked only if filter
+     * reports block as probably stored
+     * @param key - block CID
+     * @return true if block is stored
+     */
+    outcome::result<bool> isStored(const CID &key) const;
+
+    /**
+     * @brief Add block to filter and mark it with current generation
+     * @param key - block CID
+     */
+    void markStored(const CID &key);
+
+    /**
+     * @brief Check filters of stored blocks. Must be called with mutex
+     * locked
+     * @param key - block CID
+     * @return false if block was never added, true if it probably was
+     */
+    bool mayBeStored(const CID &key) const;
+
+    /**
+     * @brief Add block to newest filter, stacks new filter when newest one
+     * is full. Must be called with mutex locked
+     * @param key - block CID
+     */
+    void insertStored(const CID &key) const;
+
     std::shared_ptr<IpfsDatastore> local_storage_; /**< Local data storage */
+
+    mutable std::mutex mutex_; /**< Guards filter and marks */
+    /** Filters of stored blocks, each next one is twice larger */
+    mutable std::vector<CidBloomFilter> stored_;
+    mutable size_t capacity_; /**< Expected count of blocks of newest filter */
+    mutable size_t inserted_{}; /**< Count of blocks added to newest filter */
+    std::map<CID, uint64_t> marks_; /**< Generations of blocks */
+    size_t max_marks_; /**< Max count of marks */
+    uint64_t generation_{}; /**< Current generation */
   };
 }  // namespace fc::storage::ipfs
 
@@ -0,0 +1,42 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/overlay_datastore.hpp"
+
+namespace fc::storage::ipfs {
+
+  OverlayDatastore::OverlayDatastore(std::shared_ptr<IpfsDatastore> base,
+                                     std::shared_ptr<IpfsDatastore> overlay)
+      : base_{std::move(base)}, overlay_{std::move(overlay)} {
+    BOOST_ASSERT_MSG(base_ != nullptr, "base datastore is nullptr");
+    BOOST_ASSERT_MSG(overlay_ != nullptr, "overlay datastore is nullptr");
+  }
+
+  outcome::result<bool> OverlayDatastore::contains(const CID &key) const {
+    OUTCOME_TRY(in_overlay, overlay_->contains(key));
+    if (in_overlay) {
+      return true;
+    }
+    return base_->contains(key);
+  }
+
+  outcome::result<void> OverlayDatastore::set(const CID &key, Value value) {
+    return overlay_->set(key, std::move(value));
+  }
+
+  outcome::result<OverlayDatastore::Value> OverlayDatastore::get(
+      const CID &key) const {
+    auto value = overlay_->get(key);
+    if (value || value.error() != IpfsDatastoreError::NOT_FOUND) {
+      return value;
+    }
+    return base_->get(key);
+  }
+
+  outcome::result<void> OverlayDatastore::remove(const CID &key) {
+    return overlay_->remove(key);
+  }
+
+}  // namespace fc::storage::ipfs
@@ -0,0 +1,53 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_OVERLAY_DATASTORE_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_OVERLAY_DATASTORE_HPP
+
+#include <memory>
+
+#include "storage/ipfs/datastore.hpp"
+
+namespace fc::storage::ipfs {
+
+  /**
+   * @class OverlayDatastore is a copy-on-write view of another datastore.
+   * Reads fall through to the base datastore, writes and removes only touch
+   * the overlay, so the base datastore is never modified.
+   */
+  class OverlayDatastore : public IpfsDatastore {
+   public:
+    /**
+     * @param base - read-only underlying datastore
+     * @param overlay - datastore receiving all writes
+     */
+    OverlayDatastore(std::shared_ptr<IpfsDatastore> base,
+                     std::shared_ptr<IpfsDatastore> overlay);
+
+    ~OverlayDatastore() override = default;
+
+    /** @copydoc IpfsDatastore::contains() */
+    outcome::result<bool> contains(const CID &key) const override;
+
+    /** @copydoc IpfsDatastore::set() */
+    outcome::result<void> set(const CID &key, Value value) override;
+
+    /** @copydoc IpfsDatastore::get() */
+    outcome::result<Value> get(const CID &key) const override;
+
+    /**
+     * @brief removes key from overlay only, values of base datastore stay
+     * visible
+     */
+    outcome::result<void> remove(const CID &key) override;
+
+   private:
+    std::shared_ptr<IpfsDatastore> base_;
+    std::shared_ptr<IpfsDatastore> overlay_;
+  };
+
+}  // namespace fc::storage::ipfs
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_OVERLAY_DATASTORE_HPP
@@ -33,11 +33,11 @@ namespace fc::storage::ipfs::merkledag {
     return names;
   }
 
-  outcome::result<void> LeafImpl::insertSubLeaf(std::string name,
-                                                 LeafImpl children) {
+  outcome::result<std::reference_wrapper<LeafImpl>> LeafImpl::insertSubLeaf(
+      std::string name, LeafImpl children) {
     auto result = children_.emplace(std::move(name), std::move(children));
     if (result.second) {
-      return outcome::success();
+      return result.first->second;
     }
     return LeafError::DUPLICATE_LEAF;
   }
@@ -33,9 +33,10 @@ namespace fc::storage::ipfs::merkledag {
      * @brief Insert children leaf
      * @param name - id of the leaf
      * @param children - leaf to insert
-     * @return operation result
+     * @return inserted leaf
      */
-    outcome::result<void> insertSubLeaf(std::string name, LeafImpl children);
+    outcome::result<std::reference_wrapper<LeafImpl>> insertSubLeaf(
+        std::string name, LeafImpl children);
 
    private:
     common::Buffer content_;
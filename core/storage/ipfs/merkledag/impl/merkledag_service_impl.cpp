@@ -5,20 +5,516 @@
 
 #include "storage/ipfs/merkledag/impl/merkledag_service_impl.hpp"
 
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <iterator>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/assert.hpp>
+#include <boost/variant.hpp>
 #include <libp2p/multi/content_identifier_codec.hpp>
+#include "codec/cbor/cbor_decode_stream.hpp"
+#include "storage/ipfs/merkledag/selector.hpp"
 #include "storage/ipld/impl/ipld_node_impl.hpp"
+#include "storage/ipld/impl/ipld_node_reader_pb.hpp"
 
 using libp2p::multi::ContentIdentifierCodec;
 
 namespace fc::storage::ipfs::merkledag {
+  using codec::cbor::CborDecodeStream;
   using ipld::IPLDNodeImpl;
+  using ipld::PBLinkView;
+  using ipld::PBNodeReader;
+
+  namespace {
+    /// Shards of block cache, so that concurrent selections rarely contend
+    constexpr size_t kCacheShards = 16;
+
+    using ContentType = libp2p::multi::MulticodecType::Code;
+    using WalkOrder = MerkleDagService::WalkOrder;
+
+    /// Selected block, as it is stored
+    class RawBlock : public IPLDBlock {
+     public:
+      RawBlock(CID cid, common::Buffer bytes)
+          : cid_{std::move(cid)}, bytes_{std::move(bytes)} {}
+
+      const CID &getCID() const override {
+        return cid_;
+      }
+
+      const common::Buffer &getRawBytes() const override {
+        return bytes_;
+      }
+
+     private:
+      CID cid_;
+      common::Buffer bytes_;
+    };
+
+    /// DAG-PB block with links read from its bytes
+    struct PBNode {
+      common::Buffer bytes;
+
+      /// Links referencing bytes
+      std::vector<PBLinkView> links;
+    };
+
+    /// Value of DAG-PB data model, map of "Data" and "Links", where links
+    /// are maps of "Hash", "Name" and "Tsize". Only values leading to links
+    /// are represented, other ones are scalars and select nothing
+    struct PBValue {
+      enum class Kind {
+        NODE,   // node map
+        LINKS,  // "Links" list
+        LINK,   // link map
+        HASH,   // "Hash" of link
+      };
+
+      std::shared_ptr<const PBNode> node;
+
+      Kind kind{Kind::NODE};
+
+      /// Index of link for LINK and HASH
+      size_t link{};
+    };
+
+    /// Innermost recursion of selector being applied
+    struct Recursion {
+      /// Selector applied on each recursion edge
+      const Selector *sequence{};
+
+      /// Times sequence may be applied yet, none means unlimited
+      boost::optional<size_t> depth;
+    };
+
+    /// Value waiting to be explored by selector traversal
+    struct Step {
+      /// DAG-CBOR value or DAG-PB value, owns bytes of its block
+      boost::variant<CborDecodeStream, PBValue> value;
+
+      /// Selector applied to value
+      const Selector *selector{};
+
+      Recursion recursion;
+    };
+
+    /// Orders map keys as DAG-CBOR canonical encoding does, shorter keys
+    /// first and keys of equal length bytewise
+    bool canonicalKeyLess(const std::string &lhs, const std::string &rhs) {
+      if (lhs.size() != rhs.size()) {
+        return lhs.size() < rhs.size();
+      }
+      return lhs < rhs;
+    }
+
+    /// Selector traversal, hands blocks to handler as they are loaded.
+    /// Values to explore are kept on explicit stack, so that deep graphs
+    /// don't exhaust call stack
+    class Traversal {
+     public:
+      using Handler = std::function<bool(std::shared_ptr<const IPLDBlock>)>;
+      using Loader =
+          std::function<outcome::result<common::Buffer>(const CID &)>;
+
+      Traversal(const Loader &load, const Handler &handler)
+          : load_{load}, handler_{handler} {}
+
+      /**
+       * @brief Hands root block to handler and explores graph depth-first
+       * in link order
+       */
+      outcome::result<void> traverse(const CID &cid,
+                                     const common::Buffer &bytes,
+                                     const Selector &selector) {
+        OUTCOME_TRY(more, visit(cid, bytes, selector, {}));
+        while (more && !stack_.empty()) {
+          auto step = std::move(stack_.back());
+          stack_.pop_back();
+          OUTCOME_TRY(next, explore(std::move(step)));
+          more = next;
+        }
+        return outcome::success();
+      }
+
+      /// Blocks handed to handler
+      size_t count{};
+
+     private:
+      /**
+       * @brief Hands block to handler and pushes its data model to explore
+       * @return false if handler stopped traversal
+       */
+      outcome::result<bool> visit(const CID &cid,
+                                  const common::Buffer &bytes,
+                                  const Selector &selector,
+                                  const Recursion &recursion) {
+        std::shared_ptr<PBNode> node;
+        if (cid.content_type == ContentType::DAG_PB) {
+          // links are explored as views of block bytes
+          node = std::make_shared<PBNode>();
+          node->bytes = bytes;
+          OUTCOME_TRY(reader, PBNodeReader::read(node->bytes));
+          node->links.assign(reader.begin(), reader.end());
+        }
+        ++count;
+        if (!handler_(std::make_shared<RawBlock>(cid, bytes))) {
+          return false;
+        }
+        if (selector.kind == Selector::Kind::MATCHER) {
+          return true;
+        }
+        if (node) {
+          stack_.push_back(
+              Step{PBValue{std::move(node)}, &selector, recursion});
+        } else if (cid.content_type == ContentType::DAG_CBOR) {
+          stack_.push_back(
+              Step{CborDecodeStream{bytes}, &selector, recursion});
+        }
+        return true;
+      }
+
+      /**
+       * @brief Applies selector to value, pushes values to explore next
+       * @return false if handler stopped traversal
+       */
+      outcome::result<bool> explore(Step step) {
+        using Kind = Selector::Kind;
+        const auto &selector = *step.selector;
+        auto &recursion = step.recursion;
+        // recursion edge is resolved before link is loaded, so that links
+        // beyond depth limit are not selected
+        if (selector.kind == Kind::RECURSIVE_EDGE) {
+          if (recursion.depth) {
+            if (*recursion.depth <= 1) {
+              return true;
+            }
+            --*recursion.depth;
+          }
+          stack_.push_back(Step{step.value, recursion.sequence, recursion});
+          return true;
+        }
+        // children are pushed in reverse, so that they are explored in order
+        std::vector<Step> children;
+        switch (selector.kind) {
+          case Kind::MATCHER:
+          case Kind::RECURSIVE_EDGE:
+            break;
+          case Kind::EXPLORE_RECURSIVE:
+            children.push_back(
+                Step{step.value,
+                     selector.next.get(),
+                     Recursion{selector.next.get(), selector.depth}});
+            break;
+          case Kind::EXPLORE_UNION:
+            for (const auto &item : selector.selectors) {
+              children.push_back(Step{step.value, item.get(), recursion});
+            }
+            break;
+          case Kind::EXPLORE_ALL:
+          case Kind::EXPLORE_FIELDS:
+          case Kind::EXPLORE_INDEX:
+            // depend on data model of value
+            break;
+        }
+        if (const auto *pb = boost::get<PBValue>(&step.value)) {
+          if (pb->kind == PBValue::Kind::HASH) {
+            const auto &link = pb->node->links[pb->link];
+            return visitPBLink(link.cid, selector, recursion);
+          }
+          explorePB(*pb, selector, recursion, children);
+        } else {
+          auto &value = boost::get<CborDecodeStream>(step.value);
+          if (value.isCid()) {
+            CID cid;
+            value >> cid;
+            return visitLink(cid, selector, recursion);
+          }
+          exploreCbor(value, selector, recursion, children);
+        }
+        std::move(children.rbegin(),
+                  children.rend(),
+                  std::back_inserter(stack_));
+        return true;
+      }
+
+      /// Loads linked block and visits it
+      outcome::result<bool> visitLink(const CID &cid,
+                                      const Selector &selector,
+                                      const Recursion &recursion) {
+        auto bytes = load_(cid);
+        if (!bytes) {
+          return ServiceError::UNRESOLVED_LINK;
+        }
+        return visit(cid, bytes.value(), selector, recursion);
+      }
+
+      /// Loads block linked by DAG-PB link and visits it
+      outcome::result<bool> visitPBLink(gsl::span<const uint8_t> cid_bytes,
+                                        const Selector &selector,
+                                        const Recursion &recursion) {
+        OUTCOME_TRY(cid, ContentIdentifierCodec::decode(cid_bytes));
+        return visitLink(CID{std::move(cid)}, selector, recursion);
+      }
+
+      /// Appends DAG-PB values explored by selector, in canonical key order
+      static void explorePB(const PBValue &value,
+                            const Selector &selector,
+                            const Recursion &recursion,
+                            std::vector<Step> &children) {
+        using Kind = Selector::Kind;
+        using PBKind = PBValue::Kind;
+        auto child = [&](PBKind kind, size_t link, const Selector *next) {
+          children.push_back(
+              Step{PBValue{value.node, kind, link}, next, recursion});
+        };
+        const auto *next = selector.next.get();
+        switch (selector.kind) {
+          case Kind::EXPLORE_ALL:
+            if (value.kind == PBKind::NODE) {
+              child(PBKind::LINKS, 0, next);
+            } else if (value.kind == PBKind::LINKS) {
+              for (size_t i = 0; i < value.node->links.size(); ++i) {
+                child(PBKind::LINK, i, next);
+              }
+            } else if (value.kind == PBKind::LINK) {
+              child(PBKind::HASH, value.link, next);
+            }
+            break;
+          case Kind::EXPLORE_FIELDS: {
+            const char *field{};
+            auto kind = PBKind::HASH;
+            if (value.kind == PBKind::NODE) {
+              field = "Links";
+              kind = PBKind::LINKS;
+            } else if (value.kind == PBKind::LINK) {
+              field = "Hash";
+            }
+            auto it = selector.fields.end();
+            if (field != nullptr) {
+              it = selector.fields.find(field);
+            }
+            if (it != selector.fields.end()) {
+              child(kind, value.link, it->second.get());
+            }
+            break;
+          }
+          case Kind::EXPLORE_INDEX:
+            if (value.kind == PBKind::LINKS
+                && selector.index < value.node->links.size()) {
+              child(PBKind::LINK, selector.index, next);
+            }
+            break;
+          default:
+            break;
+        }
+      }
+
+      /// Appends DAG-CBOR values explored by selector
+      static void exploreCbor(CborDecodeStream &value,
+                              const Selector &selector,
+                              const Recursion &recursion,
+                              std::vector<Step> &children) {
+        using Kind = Selector::Kind;
+        switch (selector.kind) {
+          case Kind::EXPLORE_ALL:
+            if (value.isList()) {
+              auto n = value.listLength();
+              auto items = value.list();
+              for (size_t i = 0; i < n; ++i) {
+                children.push_back(
+                    Step{items, selector.next.get(), recursion});
+                items.next();
+              }
+            } else if (value.isMap()) {
+              auto map = value.map();
+              std::vector<std::string> keys;
+              keys.reserve(map.size());
+              for (const auto &item : map) {
+                keys.push_back(item.first);
+              }
+              std::sort(keys.begin(), keys.end(), canonicalKeyLess);
+              for (const auto &key : keys) {
+                children.push_back(
+                    Step{map.at(key), selector.next.get(), recursion});
+              }
+            }
+            break;
+          case Kind::EXPLORE_FIELDS:
+            if (value.isMap()) {
+              auto map = value.map();
+              for (const auto &[name, field_selector] : selector.fields) {
+                auto field = map.find(name);
+                if (field != map.end()) {
+                  children.push_back(
+                      Step{field->second, field_selector.get(), recursion});
+                }
+              }
+            }
+            break;
+          case Kind::EXPLORE_INDEX:
+            if (value.isList() && selector.index < value.listLength()) {
+              auto items = value.list();
+              for (size_t i = 0; i < selector.index; ++i) {
+                items.next();
+              }
+              children.push_back(Step{items, selector.next.get(), recursion});
+            }
+            break;
+          default:
+            break;
+        }
+      }
+
+      const Loader &load_;
+      const Handler &handler_;
+
+      /// Values to explore, the next one is at back
+      std::vector<Step> stack_;
+    };
+
+    /// Node waiting to be visited by graph walk
+    struct WalkEntry {
+      CID cid;
+      uint64_t depth{};
+
+      /// Name of link to node
+      std::string name;
+
+      /// Leaf of parent node, when graph is built
+      LeafImpl *parent{};
+
+      /// Leaf of node, set by visitor for children of node
+      LeafImpl *leaf{};
+
+      /// Node bytes, valid if node is prefetched
+      std::future<outcome::result<common::Buffer>> bytes;
+    };
+
+    /// Iterative graph walk. Nodes to visit are kept as CIDs, only nodes at
+    /// the front of pending queue are loaded ahead. Depth-first walk pushes
+    /// children in front of prefetched siblings, so memory is bounded by
+    /// window per level and not by graph size
+    class GraphWalk {
+     public:
+      using Visitor = std::function<outcome::result<bool>(
+          WalkEntry &entry, const std::shared_ptr<IPLDNode> &node)>;
+
+      /**
+       * @param store - datastore to load nodes from
+       * @param pool - pool to prefetch nodes on, nullptr loads nodes on
+       * calling thread
+       * @param prefetch - nodes at the front of queue loaded ahead
+       */
+      GraphWalk(std::shared_ptr<IpfsDatastore> store,
+                boost::asio::thread_pool *pool,
+                size_t prefetch)
+          : store_{std::move(store)},
+            pool_{pool},
+            prefetch_{pool ? prefetch : 0} {}
+
+      /**
+       * @brief Visits nodes of graph
+       * @return count of visited nodes
+       */
+      outcome::result<size_t> walk(const CID &root,
+                                   boost::optional<uint64_t> max_depth,
+                                   WalkOrder order,
+                                   const Visitor &visit) {
+        std::deque<WalkEntry> pending;
+        pending.push_back(WalkEntry{root});
+        size_t count = 0;
+        while (!pending.empty()) {
+          prefetch(pending);
+          auto entry = std::move(pending.front());
+          pending.pop_front();
+          auto node = load(entry);
+          if (!node) {
+            if (entry.depth == 0) {
+              return node.error();
+            }
+            return ServiceError::UNRESOLVED_LINK;
+          }
+          ++count;
+          OUTCOME_TRY(more, visit(entry, node.value()));
+          if (!more) {
+            break;
+          }
+          if (max_depth && entry.depth >= *max_depth) {
+            continue;
+          }
+          const auto &links = node.value()->getLinks();
+          for (size_t i = 0; i < links.size(); ++i) {
+            bool depth_first = order == WalkOrder::DEPTH_FIRST;
+            // children are pushed to front in reverse, so that depth-first
+            // walk visits them in link order
+            const IPLDLink &link =
+                depth_first ? links[links.size() - 1 - i] : links[i];
+            WalkEntry child{link.getCID(),
+                            entry.depth + 1,
+                            link.getName(),
+                            entry.leaf};
+            if (depth_first) {
+              pending.push_front(std::move(child));
+            } else {
+              pending.push_back(std::move(child));
+            }
+          }
+        }
+        return count;
+      }
+
+     private:
+      /// Starts loading of nodes to be visited next, within window at the
+      /// front of queue. Entries prefetched earlier and pushed back by
+      /// children don't take window slots, their bytes wait for visit
+      void prefetch(std::deque<WalkEntry> &pending) {
+        for (size_t i = 0; i < pending.size() && i < prefetch_; ++i) {
+          auto &entry = pending[i];
+          if (entry.bytes.valid()) {
+            continue;
+          }
+          auto task = std::make_shared<
+              std::packaged_task<outcome::result<common::Buffer>()>>(
+              [store{store_}, cid{entry.cid}] { return store->get(cid); });
+          entry.bytes = task->get_future();
+          boost::asio::post(*pool_, [task] { (*task)(); });
+        }
+      }
+
+      /// Loads node, waits for it if it is prefetched
+      outcome::result<std::shared_ptr<IPLDNode>> load(WalkEntry &entry) {
+        if (entry.bytes.valid()) {
+          OUTCOME_TRY(bytes, entry.bytes.get());
+          return IPLDNodeImpl::createFromRawBytes(bytes);
+        }
+        OUTCOME_TRY(bytes, store_->get(entry.cid));
+        return IPLDNodeImpl::createFromRawBytes(bytes);
+      }
+
+      std::shared_ptr<IpfsDatastore> store_;
+
+      /// Loads nodes, shared by walks of service
+      boost::asio::thread_pool *pool_;
+
+      size_t prefetch_;
+    };
+  }  // namespace
 
   MerkleDagServiceImpl::MerkleDagServiceImpl(
-      std::shared_ptr<IpfsDatastore> service)
-      : block_service_{std::move(service)} {
+      std::shared_ptr<IpfsDatastore> service,
+      size_t prefetch,
+      size_t cached_blocks)
+      : block_service_{std::move(service)},
+        prefetch_{prefetch},
+        block_cache_{std::max<size_t>(cached_blocks, 1), kCacheShards} {
     BOOST_ASSERT_MSG(block_service_ != nullptr,
                      "MerkleDAG service: Block service not connected");
+    if (prefetch_ > 0) {
+      pool_ = std::make_unique<boost::asio::thread_pool>(prefetch_);
+    }
   }
 
   outcome::result<void> MerkleDagServiceImpl::addNode(
@@ -29,87 +525,100 @@ namespace fc::storage::ipfs::merkledag {
 
   outcome::result<std::shared_ptr<IPLDNode>> MerkleDagServiceImpl::getNode(
       const CID &cid) const {
-    OUTCOME_TRY(content, block_service_->get(cid));
+    OUTCOME_TRY(content, getBlock(cid));
     return IPLDNodeImpl::createFromRawBytes(content);
   }
 
   outcome::result<void> MerkleDagServiceImpl::removeNode(const CID &cid) {
+    block_cache_.remove(cid);
     return block_service_->remove(cid);
   }
 
   outcome::result<size_t> MerkleDagServiceImpl::select(
       gsl::span<const uint8_t> root_cid,
       gsl::span<const uint8_t> selector,
-      std::function<bool(std::shared_ptr<const IPLDNode>)> handler) const {
-    std::ignore = selector;
+      std::function<bool(std::shared_ptr<const IPLDBlock>)> handler) const {
+    SelectorPtr root_selector = directLinksSelector();
+    if (!selector.empty()) {
+      OUTCOME_TRY(decoded, decodeSelector(selector));
+      root_selector = std::move(decoded);
+    }
     OUTCOME_TRY(content_id, ContentIdentifierCodec::decode(root_cid));
     CID cid{std::move(content_id)};
-    OUTCOME_TRY(root_node, getNode(cid));
-    std::vector<std::shared_ptr<const IPLDNode>> node_set{};
-    node_set.emplace_back(std::move(root_node));
-    const auto &links = node_set.front()->getLinks();
-    for (const auto &link : links) {
-      auto request = getNode(link.get().getCID());
-      if (request.has_error()) return ServiceError::UNRESOLVED_LINK;
-      node_set.emplace_back(std::move(request.value()));
+    OUTCOME_TRY(content, getBlock(cid));
+    Traversal::Loader load = [this](const CID &link) {
+      return getBlock(link);
+    };
+    Traversal traversal{load, handler};
+    try {
+      OUTCOME_TRY(traversal.traverse(cid, content, *root_selector));
+    } catch (std::system_error &e) {
+      return outcome::failure(e.code());
     }
-    size_t sent_count{};
-    for (const auto &node : node_set) {
-      ++sent_count;
-      if (!handler(node)) break;
-    }
-    return sent_count;
+    return traversal.count;
   }
 
   outcome::result<std::shared_ptr<Leaf>> MerkleDagServiceImpl::fetchGraph(
       const CID &cid) const {
-    OUTCOME_TRY(node, getNode(cid));
-    auto root_leaf = std::make_shared<LeafImpl>(node->content());
-    auto result = buildGraph(root_leaf, node->getLinks(), false, 0, 0);
-    if (result.has_error()) return result.error();
-    return root_leaf;
+    return buildGraph(cid, boost::none);
   }
 
   outcome::result<std::shared_ptr<Leaf>>
   MerkleDagServiceImpl::fetchGraphOnDepth(const CID &cid,
                                           uint64_t depth) const {
-    OUTCOME_TRY(node, getNode(cid));
-    auto leaf = std::make_shared<LeafImpl>(node->content());
-    auto result = buildGraph(leaf, node->getLinks(), true, depth, 0);
-    if (result.has_error()) return result.error();
-    return leaf;
+    return buildGraph(cid, depth);
   }
 
-  outcome::result<void> MerkleDagServiceImpl::buildGraph(
-      const std::shared_ptr<LeafImpl> &root,
-      const std::vector<std::reference_wrapper<const IPLDLink>> &links,
-      bool depth_limit,
-      const size_t max_depth,
-      size_t current_depth) const {
-    if (depth_limit && current_depth == max_depth) {
-      return outcome::success();
-    }
-    for (const auto &link : links) {
-      auto request = getNode(link.get().getCID());
-      if (request.has_error()) return ServiceError::UNRESOLVED_LINK;
-      std::shared_ptr<IPLDNode> node = request.value();
-      auto child_leaf = std::make_shared<LeafImpl>(node->content());
-      auto build_result = buildGraph(child_leaf,
-                                     node->getLinks(),
-                                     depth_limit,
-                                     max_depth,
-                                     ++current_depth);
-      if (build_result.has_error()) {
-        return build_result;
-      }
-      auto insert_result =
-          root->insertSubLeaf(link.get().getName(), std::move(*child_leaf));
-      if (insert_result.has_error()) {
-        return insert_result;
+  outcome::result<size_t> MerkleDagServiceImpl::walkGraph(
+      const CID &cid,
+      boost::optional<uint64_t> depth,
+      WalkOrder order,
+      WalkHandler handler) const {
+    GraphWalk walk{block_service_, pool_.get(), prefetch_};
+    return walk.walk(
+        cid,
+        depth,
+        order,
+        [&](WalkEntry &entry,
+            const std::shared_ptr<IPLDNode> &node) -> outcome::result<bool> {
+          return handler(node, entry.depth);
+        });
+  }
+
+  outcome::result<std::shared_ptr<Leaf>> MerkleDagServiceImpl::buildGraph(
+      const CID &cid, boost::optional<uint64_t> depth) const {
+    std::shared_ptr<LeafImpl> root;
+    GraphWalk walk{block_service_, pool_.get(), prefetch_};
+    auto visit = [&](WalkEntry &entry, const std::shared_ptr<IPLDNode> &node)
+        -> outcome::result<bool> {
+      LeafImpl leaf{node->content()};
+      if (entry.parent == nullptr) {
+        root = std::make_shared<LeafImpl>(std::move(leaf));
+        entry.leaf = root.get();
+      } else {
+        OUTCOME_TRY(inserted,
+                    entry.parent->insertSubLeaf(entry.name, std::move(leaf)));
+        entry.leaf = &inserted.get();
       }
+      return true;
+    };
+    // depth-first walk keeps pending only siblings of nodes on current path
+    OUTCOME_TRY(walk.walk(cid, depth, WalkOrder::DEPTH_FIRST, visit));
+    return root;
+  }
+
+  outcome::result<common::Buffer> MerkleDagServiceImpl::getBlock(
+      const CID &cid) const {
+    if (auto cached = block_cache_.get(cid)) {
+      return std::move(*cached);
     }
-    return outcome::success();
+    OUTCOME_TRY(bytes, block_service_->get(cid));
+    if (bytes.size() <= kMaxCachedBlockSize) {
+      block_cache_.put(cid, bytes);
+    }
+    return std::move(bytes);
   }
+
 }  // namespace fc::storage::ipfs::merkledag
 
 OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::ipfs::merkledag, ServiceError, e) {
@@ -8,6 +8,8 @@
 
 #include <memory>
 
+#include <boost/asio/thread_pool.hpp>
+#include "common/lru_cache.hpp"
 #include "storage/ipfs/datastore.hpp"
 #include "storage/ipfs/merkledag/impl/leaf_impl.hpp"
 #include "storage/ipfs/merkledag/merkledag_service.hpp"
@@ -18,11 +20,26 @@ namespace fc::storage::ipfs::merkledag {
 
   class MerkleDagServiceImpl : public MerkleDagService {
    public:
+    /// Default count of recently read blocks kept in memory
+    static constexpr size_t kDefaultCachedBlocks = 4096;
+
+    /// Larger blocks are not cached
+    static constexpr size_t kMaxCachedBlockSize = 64 << 10;
+
     /**
      * @brief Construct service
-     * @param service - underlying block service
+     * @param service - underlying block service, must allow concurrent reads
+     * if prefetch is used
+     * @param prefetch - nodes loaded ahead in parallel during graph walk,
+     * 0 loads nodes one by one on calling thread. Walks share one pool of
+     * prefetch threads
+     * @param cached_blocks - count of recently read blocks kept in memory,
+     * so that blocks selected for many peers are not read from disk again
      */
-    explicit MerkleDagServiceImpl(std::shared_ptr<IpfsDatastore> service);
+    explicit MerkleDagServiceImpl(
+        std::shared_ptr<IpfsDatastore> service,
+        size_t prefetch = 0,
+        size_t cached_blocks = kDefaultCachedBlocks);
 
     outcome::result<void> addNode(
         std::shared_ptr<const IPLDNode> node) override;
@@ -35,7 +52,7 @@ namespace fc::storage::ipfs::merkledag {
     outcome::result<size_t> select(
         gsl::span<const uint8_t> root_cid,
         gsl::span<const uint8_t> selector,
-        std::function<bool(std::shared_ptr<const IPLDNode> node)> handler)
+        std::function<bool(std::shared_ptr<const IPLDBlock> block)> handler)
         const override;
 
     outcome::result<std::shared_ptr<Leaf>> fetchGraph(
@@ -44,25 +61,37 @@ namespace fc::storage::ipfs::merkledag {
     outcome::result<std::shared_ptr<Leaf>> fetchGraphOnDepth(
         const CID &cid, uint64_t depth) const override;
 
+    outcome::result<size_t> walkGraph(const CID &cid,
+                                      boost::optional<uint64_t> depth,
+                                      WalkOrder order,
+                                      WalkHandler handler) const override;
+
    private:
     std::shared_ptr<IpfsDatastore> block_service_;
+    size_t prefetch_;
+
+    /// Prefetches nodes of all walks, null if prefetch is disabled
+    std::unique_ptr<boost::asio::thread_pool> pool_;
+
+    /// Recently read blocks, blocks are content addressed so they are never
+    /// stale
+    common::ShardedLruCache<CID, common::Buffer> block_cache_;
+
+    /**
+     * @brief Read block through cache of recently read blocks
+     * @param cid - block identifier
+     * @return block bytes
+     */
+    outcome::result<common::Buffer> getBlock(const CID &cid) const;
 
     /**
-     * @brief Fetch graph internal recursive implementation
-     * @param root - leaf, for which we should extract child nodes
-     * @param links - links to the child nodes of this leaf
-     * @param depth_limit - status of the depth control
-     * @param max_depth - e.g. "1" means "Fetch only root node with all
-     * children, but without children of their children"
-     * @param current_depth - value of the depth during current operation
-     * @return operation result
+     * @brief Build graph from given root node, nodes are walked depth-first
+     * @param cid - identifier of the root node
+     * @param depth - limit of the depth to fetch, none means unlimited
+     * @return root leaf
      */
-    outcome::result<void> buildGraph(
-        const std::shared_ptr<LeafImpl> &root,
-        const std::vector<std::reference_wrapper<const IPLDLink>> &links,
-        bool depth_limit,
-        size_t max_depth,
-        size_t current_depth = 0) const;
+    outcome::result<std::shared_ptr<Leaf>> buildGraph(
+        const CID &cid, boost::optional<uint64_t> depth) const;
   };
 }  // namespace fc::storage::ipfs::merkledag
 
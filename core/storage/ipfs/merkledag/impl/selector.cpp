@@ -0,0 +1,137 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/merkledag/selector.hpp"
+
+#include "codec/cbor/cbor_decode_stream.hpp"
+#include "common/outcome_throw.hpp"
+
+namespace fc::storage::ipfs::merkledag {
+  using codec::cbor::CborDecodeStream;
+
+  namespace {
+    /// Decodes selector and advances stream to the next element
+    SelectorPtr decode(CborDecodeStream &stream, bool in_recursion);
+
+    /// Decodes selector in field of selector body
+    SelectorPtr decodeField(std::map<std::string, CborDecodeStream> &body,
+                            const std::string &field,
+                            bool in_recursion) {
+      auto it = body.find(field);
+      if (it == body.end()) {
+        outcome::raise(SelectorError::UNKNOWN_KIND);
+      }
+      return decode(it->second, in_recursion);
+    }
+
+    SelectorPtr decode(CborDecodeStream &stream, bool in_recursion) {
+      using Kind = Selector::Kind;
+      auto union_map = stream.map();
+      if (union_map.size() != 1) {
+        outcome::raise(SelectorError::UNKNOWN_KIND);
+      }
+      const auto &key = union_map.begin()->first;
+      auto &value = union_map.begin()->second;
+      auto selector = std::make_shared<Selector>();
+      if (key == ".") {
+        selector->kind = Kind::MATCHER;
+      } else if (key == "@") {
+        if (!in_recursion) {
+          outcome::raise(SelectorError::EDGE_OUTSIDE_RECURSION);
+        }
+        selector->kind = Kind::RECURSIVE_EDGE;
+      } else if (key == "|") {
+        selector->kind = Kind::EXPLORE_UNION;
+        auto n = value.listLength();
+        auto items = value.list();
+        for (size_t i = 0; i < n; ++i) {
+          selector->selectors.push_back(decode(items, in_recursion));
+        }
+      } else {
+        auto body = value.map();
+        if (key == "a") {
+          selector->kind = Kind::EXPLORE_ALL;
+          selector->next = decodeField(body, ">", in_recursion);
+        } else if (key == "f") {
+          selector->kind = Kind::EXPLORE_FIELDS;
+          auto fields = body.find("f>");
+          if (fields == body.end()) {
+            outcome::raise(SelectorError::UNKNOWN_KIND);
+          }
+          for (auto &[name, field] : fields->second.map()) {
+            selector->fields.emplace(name, decode(field, in_recursion));
+          }
+        } else if (key == "i") {
+          selector->kind = Kind::EXPLORE_INDEX;
+          auto index = body.find("i");
+          if (index == body.end()) {
+            outcome::raise(SelectorError::UNKNOWN_KIND);
+          }
+          index->second >> selector->index;
+          selector->next = decodeField(body, ">", in_recursion);
+        } else if (key == "R") {
+          selector->kind = Kind::EXPLORE_RECURSIVE;
+          auto limit = body.find("l");
+          if (limit == body.end()) {
+            outcome::raise(SelectorError::INVALID_LIMIT);
+          }
+          auto limit_map = limit->second.map();
+          if (auto depth = limit_map.find("depth"); depth != limit_map.end()) {
+            size_t max_depth{};
+            depth->second >> max_depth;
+            selector->depth = max_depth;
+          } else if (limit_map.find("none") == limit_map.end()) {
+            outcome::raise(SelectorError::INVALID_LIMIT);
+          }
+          selector->next = decodeField(body, ":>", true);
+        } else {
+          outcome::raise(SelectorError::UNKNOWN_KIND);
+        }
+      }
+      return selector;
+    }
+  }  // namespace
+
+  outcome::result<SelectorPtr> decodeSelector(gsl::span<const uint8_t> bytes) {
+    try {
+      CborDecodeStream stream{bytes};
+      return decode(stream, false);
+    } catch (std::system_error &e) {
+      return outcome::failure(e.code());
+    }
+  }
+
+  SelectorPtr directLinksSelector() {
+    using Kind = Selector::Kind;
+    static const SelectorPtr selector = [] {
+      auto matcher = std::make_shared<Selector>();
+      matcher->kind = Kind::MATCHER;
+      auto hash = std::make_shared<Selector>();
+      hash->kind = Kind::EXPLORE_FIELDS;
+      hash->fields.emplace("Hash", matcher);
+      auto all = std::make_shared<Selector>();
+      all->kind = Kind::EXPLORE_ALL;
+      all->next = hash;
+      auto links = std::make_shared<Selector>();
+      links->kind = Kind::EXPLORE_FIELDS;
+      links->fields.emplace("Links", all);
+      return links;
+    }();
+    return selector;
+  }
+}  // namespace fc::storage::ipfs::merkledag
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::ipfs::merkledag, SelectorError, e) {
+  using fc::storage::ipfs::merkledag::SelectorError;
+  switch (e) {
+    case (SelectorError::UNKNOWN_KIND):
+      return "IPLD selector: unknown selector kind";
+    case (SelectorError::INVALID_LIMIT):
+      return "IPLD selector: invalid recursion limit";
+    case (SelectorError::EDGE_OUTSIDE_RECURSION):
+      return "IPLD selector: recursion edge outside of recursion";
+  }
+  return "IPLD selector: unknown error";
+}
@@ -8,15 +8,33 @@
 
 #include <memory>
 
+#include <boost/optional.hpp>
+
 #include "common/outcome.hpp"
 #include "storage/ipfs/merkledag/leaf.hpp"
 #include "storage/ipld/ipld_node.hpp"
 
 namespace fc::storage::ipfs::merkledag {
+  using ipld::IPLDBlock;
   using ipld::IPLDNode;
 
   class MerkleDagService {
    public:
+    /**
+     * @brief Order of visiting nodes during graph walk
+     */
+    enum class WalkOrder {
+      DEPTH_FIRST,   // children are visited before siblings, in link order
+      BREADTH_FIRST  // nodes are visited level by level
+    };
+
+    /**
+     * @brief Receiver of walked node and its depth, root has depth 0,
+     * returns false to stop walk
+     */
+    using WalkHandler = std::function<bool(
+        std::shared_ptr<const IPLDNode> node, uint64_t depth)>;
+
     /**
      * @brief Destructor
      */
@@ -45,17 +63,20 @@ namespace fc::storage::ipfs::merkledag {
     virtual outcome::result<void> removeNode(const CID &cid) = 0;
 
     /**
-     * @brief Get nodes with IPLD-selector
+     * @brief Get blocks with IPLD-selector, DAG-PB and DAG-CBOR blocks are
+     * explored, DAG-PB nodes as maps of "Data" and "Links"
      * @param root_cid - bytes of the root Node CID
-     * @param selector - IPLD-selector raw bytes
-     * @param handler - receiver of the selected Nodes, should return false to
-     * break receiving process
-     * @return count of the received by handler Nodes
+     * @param selector - IPLD-selector raw bytes, empty selector selects root
+     * and nodes it links to
+     * @param handler - receiver of the selected blocks in traversal order,
+     * called as blocks are loaded, should return false to break receiving
+     * process
+     * @return count of the received by handler blocks
      */
     virtual outcome::result<size_t> select(
         gsl::span<const uint8_t> root_cid,
         gsl::span<const uint8_t> selector,
-        std::function<bool(std::shared_ptr<const IPLDNode> node)> handler)
+        std::function<bool(std::shared_ptr<const IPLDBlock> block)> handler)
         const = 0;
 
     /**
@@ -75,6 +96,21 @@ namespace fc::storage::ipfs::merkledag {
      */
     virtual outcome::result<std::shared_ptr<Leaf>> fetchGraphOnDepth(
         const CID &cid, uint64_t depth) const = 0;
+
+    /**
+     * @brief Walk graph from given root node, handing nodes to handler as
+     *        they are loaded instead of building graph in memory. Node is
+     *        visited once per path
+     * @param cid - identifier of the root node
+     * @param depth - limit of the depth to walk, none means unlimited
+     * @param order - order of visiting nodes
+     * @param handler - receiver of the nodes
+     * @return count of the received by handler nodes
+     */
+    virtual outcome::result<size_t> walkGraph(const CID &cid,
+                                              boost::optional<uint64_t> depth,
+                                              WalkOrder order,
+                                              WalkHandler handler) const = 0;
   };
 
   /**
@@ -0,0 +1,83 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FILECOIN_STORAGE_IPFS_MERKLEDAG_SELECTOR_HPP
+#define FILECOIN_STORAGE_IPFS_MERKLEDAG_SELECTOR_HPP
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
+#include <gsl/span>
+
+#include "common/outcome.hpp"
+
+namespace fc::storage::ipfs::merkledag {
+
+  struct Selector;
+
+  using SelectorPtr = std::shared_ptr<const Selector>;
+
+  /**
+   * @struct Decoded IPLD selector, see
+   * https://github.com/ipld/specs/blob/master/selectors/selectors.md
+   */
+  struct Selector {
+    enum class Kind {
+      MATCHER,            // "." - selects current node, stops traversal
+      EXPLORE_ALL,        // "a" - explores all map values or list items
+      EXPLORE_FIELDS,     // "f" - explores given map fields
+      EXPLORE_INDEX,      // "i" - explores one list item
+      EXPLORE_UNION,      // "|" - explores with each of selectors
+      EXPLORE_RECURSIVE,  // "R" - repeats sequence up to depth limit
+      RECURSIVE_EDGE,     // "@" - restarts sequence of enclosing recursion
+    };
+
+    Kind kind;
+
+    /// Selector to apply to explored values, or recursion sequence
+    SelectorPtr next;
+
+    /// Selectors of explored fields for EXPLORE_FIELDS
+    std::map<std::string, SelectorPtr> fields;
+
+    /// Selectors of union for EXPLORE_UNION
+    std::vector<SelectorPtr> selectors;
+
+    /// Explored list index for EXPLORE_INDEX
+    size_t index{};
+
+    /// Max times recursion sequence is applied, none means unlimited
+    boost::optional<size_t> depth;
+  };
+
+  /**
+   * @brief Decodes DAG-CBOR encoded selector
+   * @param bytes - selector bytes
+   * @return selector tree
+   */
+  outcome::result<SelectorPtr> decodeSelector(gsl::span<const uint8_t> bytes);
+
+  /**
+   * @brief Selector of node and nodes it links to, used when request has no
+   * selector
+   */
+  SelectorPtr directLinksSelector();
+
+  /**
+   * @class Possible selector decoding errors
+   */
+  enum class SelectorError {
+    UNKNOWN_KIND = 1,        // selector is not one of supported kinds
+    INVALID_LIMIT,           // recursion limit is neither depth nor none
+    EDGE_OUTSIDE_RECURSION,  // recursion edge is not within recursion
+  };
+}  // namespace fc::storage::ipfs::merkledag
+
+OUTCOME_HPP_DECLARE_ERROR(fc::storage::ipfs::merkledag, SelectorError)
+
+#endif
@@ -9,16 +9,14 @@
 #include <libp2p/multi/content_identifier_codec.hpp>
 #include <libp2p/multi/multibase_codec/codecs/base58.hpp>
 #include <libp2p/multi/multihash.hpp>
-#include "ipld_node.pb.h"
-#include "storage/ipld/impl/ipld_node_decoder_pb.hpp"
+#include "storage/ipld/impl/ipld_node_reader_pb.hpp"
+#include "storage/ipld/impl/ipld_node_writer_pb.hpp"
 
 using libp2p::common::Hash256;
 using libp2p::multi::ContentIdentifierCodec;
 using libp2p::multi::HashType;
 using libp2p::multi::MulticodecType;
 using libp2p::multi::Multihash;
-using protobuf::ipld::node::PBLink;
-using protobuf::ipld::node::PBNode;
 using Version = libp2p::multi::ContentIdentifier::Version;
 
 namespace fc::storage::ipld {
@@ -84,24 +82,25 @@ namespace fc::storage::ipld {
 
   outcome::result<std::shared_ptr<IPLDNode>> IPLDNodeImpl::createFromRawBytes(
       gsl::span<const uint8_t> input) {
-    IPLDNodeDecoderPB decoder;
-    if (auto result = decoder.decode(input); result.has_error()) {
-      return result.error();
-    }
-    auto node = createFromString(decoder.getContent());
-    for (size_t i = 0; i < decoder.getLinksCount(); ++i) {
-      std::vector<uint8_t> link_cid_bytes{decoder.getLinkCID(i).begin(),
-                                          decoder.getLinkCID(i).end()};
-      OUTCOME_TRY(link_cid, ContentIdentifierCodec::decode(link_cid_bytes));
-      IPLDLinkImpl link{
-          std::move(link_cid), decoder.getLinkName(i), decoder.getLinkSize(i)};
-      node->addLink(link);
+    OUTCOME_TRY(reader, PBNodeReader::read(input));
+    auto node = std::make_shared<IPLDNodeImpl>();
+    node->assign(common::Buffer{reader.content()});
+    for (const auto &link : reader) {
+      OUTCOME_TRY(link_cid, ContentIdentifierCodec::decode(link.cid));
+      std::string name{link.name};
+      node->links_.emplace(
+          name, IPLDLinkImpl{std::move(link_cid), name, link.size});
     }
     return node;
   }
 
   outcome::result<std::vector<uint8_t>> IPLDNodeImpl::getBlockContent() const {
-    return IPLDNodeEncoderPB::encode(content_, links_);
+    PBNodeWriter writer;
+    for (const auto &[name, link] : links_) {
+      OUTCOME_TRY(cid_bytes, link.getCID().toBytes());
+      writer.addLink(cid_bytes, name, link.getSize());
+    }
+    return writer.finish(content_);
   }
 }  // namespace fc::storage::ipld
 
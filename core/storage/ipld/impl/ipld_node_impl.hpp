@@ -13,7 +13,6 @@
 
 #include <boost/optional.hpp>
 #include "storage/ipld/impl/ipld_link_impl.hpp"
-#include "storage/ipld/impl/ipld_node_encoder_pb.hpp"
 #include "storage/ipld/ipld_block_common.hpp"
 #include "storage/ipld/ipld_node.hpp"
 
@@ -51,7 +50,6 @@ namespace fc::storage::ipld {
    private:
     common::Buffer content_;
     std::map<std::string, IPLDLinkImpl> links_;
-    IPLDNodeEncoderPB pb_node_codec_;
     size_t child_nodes_size_{};
 
     outcome::result<std::vector<uint8_t>> getBlockContent() const override;
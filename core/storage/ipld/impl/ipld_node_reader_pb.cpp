@@ -0,0 +1,214 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipld/impl/ipld_node_reader_pb.hpp"
+
+#include "storage/ipld/ipld_node.hpp"
+
+namespace fc::storage::ipld {
+  namespace {
+    // Protobuf wire types
+    enum class PBFieldType : uint8_t {
+      VARINT = 0,
+      BITS_64,
+      LENGTH_DELIMITED,
+      START_GROUP,
+      END_GROUP,
+      BITS_32
+    };
+
+    enum PBLinkOrder : uint64_t { HASH = 1, NAME, SIZE };
+
+    enum PBNodeOrder : uint64_t { DATA = 1, LINKS };
+
+    /// Protobuf field, length-delimited value references input
+    struct PBField {
+      uint64_t order{};
+      PBFieldType type{};
+      uint64_t varint{};
+      gsl::span<const uint8_t> bytes;
+    };
+
+    /// Reads varint and advances input
+    bool readVarint(gsl::span<const uint8_t> &input, uint64_t &value) {
+      value = 0;
+      for (size_t shift = 0; shift < 64; shift += 7) {
+        if (input.empty()) {
+          return false;
+        }
+        uint8_t byte = input[0];
+        input = input.subspan(1);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /// Skips fixed size value and advances input
+    bool skip(gsl::span<const uint8_t> &input, size_t size) {
+      if (static_cast<size_t>(input.size()) < size) {
+        return false;
+      }
+      input = input.subspan(size);
+      return true;
+    }
+
+    /// Reads field and advances input, groups are not supported
+    bool readField(gsl::span<const uint8_t> &input, PBField &field) {
+      uint64_t tag{};
+      if (!readVarint(input, tag)) {
+        return false;
+      }
+      field.order = tag >> 3;
+      field.type = static_cast<PBFieldType>(tag & 7);
+      if (field.order == 0) {
+        return false;
+      }
+      switch (field.type) {
+        case PBFieldType::VARINT:
+          return readVarint(input, field.varint);
+        case PBFieldType::BITS_64:
+          return skip(input, 8);
+        case PBFieldType::LENGTH_DELIMITED: {
+          uint64_t length{};
+          if (!readVarint(input, length)
+              || length > static_cast<size_t>(input.size())) {
+            return false;
+          }
+          field.bytes = input.subspan(0, length);
+          input = input.subspan(length);
+          return true;
+        }
+        case PBFieldType::BITS_32:
+          return skip(input, 4);
+        default:
+          return false;
+      }
+    }
+
+    /// Reads link fields, unknown fields are skipped
+    bool readLink(gsl::span<const uint8_t> input, PBLinkView &link) {
+      link = {};
+      PBField field;
+      while (!input.empty()) {
+        if (!readField(input, field)) {
+          return false;
+        }
+        bool bytes = field.type == PBFieldType::LENGTH_DELIMITED;
+        switch (field.order) {
+          case PBLinkOrder::HASH:
+            if (!bytes) {
+              return false;
+            }
+            link.cid = field.bytes;
+            break;
+          case PBLinkOrder::NAME:
+            if (!bytes) {
+              return false;
+            }
+            link.name = {reinterpret_cast<const char *>(field.bytes.data()),
+                         static_cast<size_t>(field.bytes.size())};
+            break;
+          case PBLinkOrder::SIZE:
+            if (field.type != PBFieldType::VARINT) {
+              return false;
+            }
+            link.size = field.varint;
+            break;
+          default:
+            break;
+        }
+      }
+      return true;
+    }
+  }  // namespace
+
+  PBNodeReader::LinkIterator::LinkIterator(gsl::span<const uint8_t> input)
+      : rest_{input} {
+    ++*this;
+  }
+
+  PBNodeReader::LinkIterator::reference PBNodeReader::LinkIterator::operator*()
+      const {
+    return link_;
+  }
+
+  PBNodeReader::LinkIterator::pointer PBNodeReader::LinkIterator::operator->()
+      const {
+    return &link_;
+  }
+
+  PBNodeReader::LinkIterator &PBNodeReader::LinkIterator::operator++() {
+    // node is checked by reader, so fields are read without errors
+    PBField field;
+    while (!rest_.empty()) {
+      position_ = rest_.data();
+      readField(rest_, field);
+      if (field.order == PBNodeOrder::LINKS) {
+        readLink(field.bytes, link_);
+        return *this;
+      }
+    }
+    position_ = nullptr;
+    return *this;
+  }
+
+  bool PBNodeReader::LinkIterator::operator==(const LinkIterator &other) const {
+    return position_ == other.position_;
+  }
+
+  bool PBNodeReader::LinkIterator::operator!=(const LinkIterator &other) const {
+    return !(*this == other);
+  }
+
+  outcome::result<PBNodeReader> PBNodeReader::read(
+      gsl::span<const uint8_t> input) {
+    PBNodeReader reader;
+    reader.input_ = input;
+    PBField field;
+    PBLinkView link;
+    while (!input.empty()) {
+      if (!readField(input, field)) {
+        return IPLDNodeError::INVALID_RAW_DATA;
+      }
+      bool bytes = field.type == PBFieldType::LENGTH_DELIMITED;
+      switch (field.order) {
+        case PBNodeOrder::DATA:
+          if (!bytes) {
+            return IPLDNodeError::INVALID_RAW_DATA;
+          }
+          reader.content_ = field.bytes;
+          break;
+        case PBNodeOrder::LINKS:
+          if (!bytes || !readLink(field.bytes, link)) {
+            return IPLDNodeError::INVALID_RAW_DATA;
+          }
+          ++reader.links_count_;
+          break;
+        default:
+          break;
+      }
+    }
+    return reader;
+  }
+
+  gsl::span<const uint8_t> PBNodeReader::content() const {
+    return content_;
+  }
+
+  size_t PBNodeReader::linksCount() const {
+    return links_count_;
+  }
+
+  PBNodeReader::LinkIterator PBNodeReader::begin() const {
+    return LinkIterator{input_};
+  }
+
+  PBNodeReader::LinkIterator PBNodeReader::end() const {
+    return LinkIterator{};
+  }
+}  // namespace fc::storage::ipld
@@ -0,0 +1,103 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FILECOIN_STORAGE_IPLD_NODE_PB_READER
+#define FILECOIN_STORAGE_IPLD_NODE_PB_READER
+
+#include <iterator>
+#include <string_view>
+
+#include <gsl/span>
+#include "common/outcome.hpp"
+
+namespace fc::storage::ipld {
+  /**
+   * @struct Link of Protobuf-encoded Node, references bytes of the Node
+   */
+  struct PBLinkView {
+    // CID bytes of the children
+    gsl::span<const uint8_t> cid;
+
+    // Link name
+    std::string_view name;
+
+    // Cumulative size of the children
+    uint64_t size{};
+  };
+
+  /**
+   * @class Reader of Protobuf-encoded Node, content and links are read
+   *        directly from the Node bytes without copying them
+   */
+  class PBNodeReader {
+   public:
+    /**
+     * @class Input iterator over links in order of encoding
+     */
+    class LinkIterator {
+     public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = PBLinkView;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const PBLinkView *;
+      using reference = const PBLinkView &;
+
+      LinkIterator() = default;
+
+      reference operator*() const;
+
+      pointer operator->() const;
+
+      LinkIterator &operator++();
+
+      bool operator==(const LinkIterator &other) const;
+
+      bool operator!=(const LinkIterator &other) const;
+
+     private:
+      friend class PBNodeReader;
+
+      explicit LinkIterator(gsl::span<const uint8_t> input);
+
+      // Position of the current link field, nullptr at the end
+      const uint8_t *position_{};
+
+      // Node fields after the current link
+      gsl::span<const uint8_t> rest_;
+
+      PBLinkView link_;
+    };
+
+    /**
+     * @brief Check input bytes as Protobuf-encoded Node
+     * @param input - bytes to read, referenced by reader and its links
+     * @return reader or error if bytes are not a valid Node
+     */
+    static outcome::result<PBNodeReader> read(gsl::span<const uint8_t> input);
+
+    /**
+     * @brief Get Node content
+     * @return content data
+     */
+    gsl::span<const uint8_t> content() const;
+
+    /**
+     * @brief Get count of the children
+     * @return Links num
+     */
+    size_t linksCount() const;
+
+    LinkIterator begin() const;
+
+    LinkIterator end() const;
+
+   private:
+    gsl::span<const uint8_t> input_;
+    gsl::span<const uint8_t> content_;
+    size_t links_count_{};
+  };
+}  // namespace fc::storage::ipld
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipld/impl/ipld_node_writer_pb.hpp"
+
+namespace fc::storage::ipld {
+  namespace {
+    // Tags of length-delimited fields and of varint link size
+    constexpr uint8_t kDataTag = (1 << 3) | 2;
+    constexpr uint8_t kLinksTag = (2 << 3) | 2;
+    constexpr uint8_t kHashTag = (1 << 3) | 2;
+    constexpr uint8_t kNameTag = (2 << 3) | 2;
+    constexpr uint8_t kSizeTag = (3 << 3) | 0;
+
+    size_t varintSize(uint64_t value) {
+      size_t size = 1;
+      while (value >= 0x80) {
+        value >>= 7;
+        ++size;
+      }
+      return size;
+    }
+
+    void writeVarint(std::vector<uint8_t> &out, uint64_t value) {
+      while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+      }
+      out.push_back(static_cast<uint8_t>(value));
+    }
+
+    /// Writes tag and length-delimited value
+    void writeBytes(std::vector<uint8_t> &out,
+                    uint8_t tag,
+                    const uint8_t *data,
+                    size_t size) {
+      out.push_back(tag);
+      writeVarint(out, size);
+      out.insert(out.end(), data, data + size);
+    }
+  }  // namespace
+
+  void PBNodeWriter::addLink(gsl::span<const uint8_t> cid,
+                             std::string_view name,
+                             uint64_t size) {
+    size_t cid_size = cid.size();
+    size_t link_size = 1 + varintSize(cid_size) + cid_size + 1
+                       + varintSize(name.size()) + name.size() + 1
+                       + varintSize(size);
+    buffer_.push_back(kLinksTag);
+    writeVarint(buffer_, link_size);
+    writeBytes(buffer_, kHashTag, cid.data(), cid_size);
+    writeBytes(buffer_,
+               kNameTag,
+               reinterpret_cast<const uint8_t *>(name.data()),
+               name.size());
+    buffer_.push_back(kSizeTag);
+    writeVarint(buffer_, size);
+  }
+
+  std::vector<uint8_t> PBNodeWriter::finish(gsl::span<const uint8_t> content) {
+    if (!content.empty()) {
+      writeBytes(buffer_, kDataTag, content.data(), content.size());
+    }
+    std::vector<uint8_t> result;
+    result.swap(buffer_);
+    return result;
+  }
+}  // namespace fc::storage::ipld
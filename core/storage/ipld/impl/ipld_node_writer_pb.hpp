@@ -0,0 +1,46 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FILECOIN_STORAGE_IPLD_NODE_PB_WRITER
+#define FILECOIN_STORAGE_IPLD_NODE_PB_WRITER
+
+#include <string_view>
+#include <vector>
+
+#include <gsl/span>
+
+namespace fc::storage::ipld {
+  /**
+   * @class Writer of Protobuf-encoded Node
+   * @details Encoding is canonical, as in reference golang implementation:
+   *          links go first in order of names, then content if not empty.
+   *          Every link has hash, name and size fields
+   */
+  class PBNodeWriter {
+   public:
+    /**
+     * @brief Append link, links must be added in order of names
+     * @param cid - CID bytes of the children
+     * @param name - link name
+     * @param size - cumulative size of the children
+     */
+    void addLink(gsl::span<const uint8_t> cid,
+                 std::string_view name,
+                 uint64_t size);
+
+    /**
+     * @brief Append content and take encoded Node, writer becomes empty
+     * @param content - Node data
+     * @return Protobuf-encoded data
+     */
+    std::vector<uint8_t> finish(gsl::span<const uint8_t> content);
+
+   private:
+    // Serialized links
+    std::vector<uint8_t> buffer_;
+  };
+}  // namespace fc::storage::ipld
+
+#endif
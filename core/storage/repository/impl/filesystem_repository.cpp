@@ -5,21 +5,25 @@
 
 #include "storage/repository/impl/filesystem_repository.hpp"
 
+#include <algorithm>
 #include <utility>
 
 #include "boost/filesystem.hpp"
 #include "crypto/bls/impl/bls_provider_impl.hpp"
-#include "crypto/secp256k1/secp256k1_provider.hpp"
+#include "crypto/secp256k1/impl/caching_secp256k1_provider.hpp"
 #include "storage/ipfs/impl/datastore_leveldb.hpp"
+#include "storage/ipfs/impl/ipfs_block_service.hpp"
 #include "storage/keystore/impl/filesystem/filesystem_keystore.hpp"
 #include "storage/repository/repository_error.hpp"
 
 using fc::crypto::bls::BlsProviderImpl;
+using fc::storage::ipfs::IpfsBlockService;
 using fc::storage::ipfs::LeveldbDatastore;
 using fc::storage::keystore::FileSystemKeyStore;
 using fc::storage::repository::FileSystemRepository;
 using fc::storage::repository::Repository;
 using fc::storage::repository::RepositoryError;
+using fc::crypto::secp256k1::CachingSecp256k1Provider;
 using libp2p::crypto::secp256k1::Secp256k1ProviderImpl;
 using Version = fc::storage::repository::Repository::Version;
 
@@ -86,8 +90,17 @@ fc::outcome::result<std::shared_ptr<Repository>> FileSystemRepository::create(
   // create datastore
   auto datastore_path =
       repo_path + fc::storage::filestore::DELIMITER + kDatastore;
-  OUTCOME_TRY(ipfs_datastore,
+  OUTCOME_TRY(leveldb_datastore,
               LeveldbDatastore::create(datastore_path, leveldb_options));
+  // writes of blocks already stored, e.g. unchanged state tree nodes, are
+  // skipped by filter sized and seeded from stored keys
+  size_t stored_blocks{};
+  leveldb_datastore->forEachCid([&](const fc::CID &) { ++stored_blocks; });
+  auto ipfs_datastore = std::make_shared<IpfsBlockService>(
+      leveldb_datastore,
+      std::max(2 * stored_blocks, IpfsBlockService::kDefaultExpectedBlocks));
+  leveldb_datastore->forEachCid(
+      [&](const fc::CID &cid) { ipfs_datastore->seedStored(cid); });
 
   // create keystore
   auto keystore_path =
@@ -96,7 +109,8 @@ fc::outcome::result<std::shared_ptr<Repository>> FileSystemRepository::create(
   auto keystore = std::make_shared<FileSystemKeyStore>(
       keystore_path,
       std::make_shared<BlsProviderImpl>(),
-      std::make_shared<Secp256k1ProviderImpl>());
+      std::make_shared<CachingSecp256k1Provider>(
+          std::make_shared<Secp256k1ProviderImpl>()));
 
   return std::make_shared<FileSystemRepository>(
       ipfs_datastore, keystore, config, repo_path, std::move(fs_locker));
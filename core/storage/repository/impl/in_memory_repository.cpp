@@ -6,7 +6,7 @@
 #include "storage/repository/impl/in_memory_repository.hpp"
 
 #include "crypto/bls/impl/bls_provider_impl.hpp"
-#include "crypto/secp256k1/secp256k1_provider.hpp"
+#include "crypto/secp256k1/impl/caching_secp256k1_provider.hpp"
 #include "storage/ipfs/impl/in_memory_datastore.hpp"
 #include "storage/keystore/impl/in_memory/in_memory_keystore.hpp"
 
@@ -15,13 +15,15 @@ using fc::storage::ipfs::InMemoryDatastore;
 using fc::storage::keystore::InMemoryKeyStore;
 using fc::storage::repository::InMemoryRepository;
 using fc::storage::repository::Repository;
+using fc::crypto::secp256k1::CachingSecp256k1Provider;
 using libp2p::crypto::secp256k1::Secp256k1ProviderImpl;
 
 InMemoryRepository::InMemoryRepository()
     : Repository(std::make_shared<InMemoryDatastore>(),
                  std::make_shared<InMemoryKeyStore>(
                      std::make_shared<BlsProviderImpl>(),
-                     std::make_shared<Secp256k1ProviderImpl>()),
+                     std::make_shared<CachingSecp256k1Provider>(
+                         std::make_shared<Secp256k1ProviderImpl>())),
                  std::make_shared<Config>()) {}
 
 fc::outcome::result<std::shared_ptr<Repository>> InMemoryRepository::create(
@@ -0,0 +1,212 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Replays historical tipsets from LevelDB repository outside the node.
+ *
+ * Usage: vm_replay <leveldb path> [--read-only] <from>:<to> [<from>:<to>...]
+ *
+ * Every range is replayed in a separate thread. In read-only mode produced
+ * state is kept in memory and the repository is never modified.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include "blockchain/impl/weight_calculator_impl.hpp"
+#include "common/logger.hpp"
+#include "storage/chain/impl/chain_data_store_impl.hpp"
+#include "storage/chain/impl/chain_store_impl.hpp"
+#include "storage/ipfs/impl/datastore_leveldb.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "storage/ipfs/impl/ipfs_block_service.hpp"
+#include "storage/ipfs/impl/overlay_datastore.hpp"
+#include "tools/vm_replay/tipset_replayer.hpp"
+#include "vm/indices/impl/indices_impl.hpp"
+#include "vm/interpreter/impl/interpreter_impl.hpp"
+
+namespace {
+  using fc::blockchain::weight::WeightCalculatorImpl;
+  using fc::storage::blockchain::ChainDataStoreImpl;
+  using fc::storage::blockchain::ChainStoreImpl;
+  using fc::storage::ipfs::InMemoryDatastore;
+  using fc::storage::ipfs::IpfsBlockService;
+  using fc::storage::ipfs::IpfsDatastore;
+  using fc::storage::ipfs::LeveldbDatastore;
+  using fc::storage::ipfs::OverlayDatastore;
+  using fc::tools::vm_replay::ReplayStats;
+  using fc::tools::vm_replay::TipsetReplayer;
+  using fc::tools::vm_replay::TrustedBlockValidator;
+  using fc::vm::indices::IndicesImpl;
+  using fc::vm::interpreter::InterpreterImpl;
+
+  struct Range {
+    uint64_t from{};
+    uint64_t to{};
+  };
+
+  struct RangeResult {
+    uint64_t tipsets{};
+    uint64_t messages{};
+    uint64_t mismatches{};
+    std::chrono::microseconds duration{};
+    bool failed{};
+  };
+
+  bool parseRange(const std::string &arg, Range &range) {
+    auto colon = arg.find(':');
+    if (colon == std::string::npos) {
+      return false;
+    }
+    try {
+      range.from = std::stoull(arg.substr(0, colon));
+      range.to = std::stoull(arg.substr(colon + 1));
+    } catch (const std::exception &) {
+      return false;
+    }
+    return range.from <= range.to;
+  }
+
+  double perSecond(uint64_t count, std::chrono::microseconds duration) {
+    if (duration.count() == 0) {
+      return 0;
+    }
+    return static_cast<double>(count) * 1e6
+           / static_cast<double>(duration.count());
+  }
+
+  fc::outcome::result<RangeResult> replayRange(
+      const std::shared_ptr<IpfsDatastore> &repository,
+      bool read_only,
+      const Range &range,
+      const fc::common::Logger &logger) {
+    std::shared_ptr<IpfsDatastore> store = repository;
+    if (read_only) {
+      store = std::make_shared<OverlayDatastore>(
+          repository, std::make_shared<InMemoryDatastore>());
+    }
+    OUTCOME_TRY(chain_store,
+                ChainStoreImpl::create(
+                    std::make_shared<IpfsBlockService>(store),
+                    std::make_shared<ChainDataStoreImpl>(store),
+                    std::make_shared<TrustedBlockValidator>(),
+                    std::make_shared<WeightCalculatorImpl>(store)));
+    OUTCOME_TRY(chain_store->load());
+    OUTCOME_TRY(head, chain_store->heaviestTipset());
+
+    TipsetReplayer replayer{store,
+                            chain_store,
+                            std::make_shared<InterpreterImpl>(),
+                            std::make_shared<IndicesImpl>()};
+    RangeResult result;
+    OUTCOME_TRY(replayer.replay(
+        head, range.from, range.to, [&](const ReplayStats &stats) {
+          std::string state_root{"unverified"};
+          if (stats.state_root_matches) {
+            state_root = *stats.state_root_matches ? "ok" : "MISMATCH";
+          }
+          logger->info(
+              "height {}: blocks {}, messages {}, {} us, {:.1f} msg/s, "
+              "store gets {} ({} bytes), puts {} ({} bytes), "
+              "state root {}",
+              stats.height,
+              stats.blocks,
+              stats.messages,
+              stats.duration.count(),
+              perSecond(stats.messages, stats.duration),
+              stats.store.blocks_read,
+              stats.store.bytes_read,
+              stats.store.blocks_written,
+              stats.store.bytes_written,
+              state_root);
+          ++result.tipsets;
+          result.messages += stats.messages;
+          result.duration += stats.duration;
+          if (stats.state_root_matches && !*stats.state_root_matches) {
+            ++result.mismatches;
+          }
+        }));
+    return result;
+  }
+}  // namespace
+
+int main(int argc, char **argv) {
+  auto logger = fc::common::createLogger("vm replay");
+
+  std::string path;
+  bool read_only{false};
+  std::vector<Range> ranges;
+  for (auto i = 1; i < argc; ++i) {
+    std::string arg{argv[i]};
+    Range range;
+    if (arg == "--read-only") {
+      read_only = true;
+    } else if (path.empty()) {
+      path = arg;
+    } else if (parseRange(arg, range)) {
+      ranges.push_back(range);
+    } else {
+      path.clear();
+      break;
+    }
+  }
+  if (path.empty() || ranges.empty()) {
+    std::cerr << "Usage: " << argv[0]
+              << " <leveldb path> [--read-only] <from>:<to> [<from>:<to>...]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  auto repository = LeveldbDatastore::create(path, leveldb::Options{});
+  if (!repository) {
+    logger->error("cannot open repository {}: {}",
+                  path,
+                  repository.error().message());
+    return EXIT_FAILURE;
+  }
+
+  std::vector<RangeResult> results(ranges.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    threads.emplace_back([&, i] {
+      auto &range = ranges[i];
+      auto result =
+          replayRange(repository.value(), read_only, range, logger);
+      if (!result) {
+        logger->error("range {}:{} failed: {}",
+                      range.from,
+                      range.to,
+                      result.error().message());
+        results[i].failed = true;
+        return;
+      }
+      results[i] = result.value();
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  auto code = EXIT_SUCCESS;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    auto &result = results[i];
+    if (result.failed || result.mismatches != 0) {
+      code = EXIT_FAILURE;
+    }
+    logger->info(
+        "range {}:{}: tipsets {}, messages {}, {} us, {:.1f} msg/s, "
+        "state root mismatches {}{}",
+        ranges[i].from,
+        ranges[i].to,
+        result.tipsets,
+        result.messages,
+        result.duration.count(),
+        perSecond(result.messages, result.duration),
+        result.mismatches,
+        result.failed ? ", failed" : "");
+  }
+  return code;
+}
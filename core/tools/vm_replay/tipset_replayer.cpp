@@ -0,0 +1,115 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "tools/vm_replay/tipset_replayer.hpp"
+
+#include "storage/amt/amt.hpp"
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::tools::vm_replay, ReplayError, e) {
+  using E = fc::tools::vm_replay::ReplayError;
+  switch (e) {
+    case E::EMPTY_RANGE:
+      return "No tipsets in requested range";
+  }
+  return "ReplayError: unknown error";
+}
+
+namespace fc::tools::vm_replay {
+  using primitives::block::MsgMeta;
+  using storage::amt::Amt;
+
+  outcome::result<void> TrustedBlockValidator::validateBlock(
+      const BlockHeader &header, Scenario scenario) const {
+    return outcome::success();
+  }
+
+  outcome::result<void> TrustedBlockValidator::validateTipset(
+      const std::vector<BlockHeader> &headers, Scenario scenario) const {
+    return outcome::success();
+  }
+
+  TipsetReplayer::TipsetReplayer(std::shared_ptr<IpfsDatastore> store,
+                                 std::shared_ptr<ChainStore> chain_store,
+                                 std::shared_ptr<Interpreter> interpreter,
+                                 std::shared_ptr<Indices> indices)
+      : store_{std::make_shared<ChargingIpfsDatastore>(std::move(store),
+                                                       stats_)},
+        chain_store_{std::move(chain_store)},
+        interpreter_{std::move(interpreter)},
+        indices_{std::move(indices)} {
+    BOOST_ASSERT_MSG(chain_store_ != nullptr, "chain store is nullptr");
+    BOOST_ASSERT_MSG(interpreter_ != nullptr, "interpreter is nullptr");
+    BOOST_ASSERT_MSG(indices_ != nullptr, "indices is nullptr");
+  }
+
+  outcome::result<std::vector<ReplayStats>> TipsetReplayer::replay(
+      const Tipset &head,
+      uint64_t from,
+      uint64_t to,
+      const Callback &callback) {
+    // tipsets in range with state roots expected after their execution
+    std::vector<std::pair<Tipset, boost::optional<CID>>> tipsets;
+    boost::optional<CID> expected_state_root;
+    auto tipset = head;
+    while (true) {
+      if (tipset.height >= from && tipset.height <= to) {
+        tipsets.emplace_back(tipset, expected_state_root);
+      }
+      if (tipset.height <= from || tipset.blks[0].parents.empty()) {
+        break;
+      }
+      expected_state_root = tipset.getParentStateRoot();
+      OUTCOME_TRY(parents, tipset.getParents());
+      OUTCOME_TRY(parent, chain_store_->loadTipset(parents));
+      tipset = std::move(parent);
+    }
+    if (tipsets.empty()) {
+      return ReplayError::EMPTY_RANGE;
+    }
+
+    std::vector<ReplayStats> result;
+    result.reserve(tipsets.size());
+    for (auto it = tipsets.rbegin(); it != tipsets.rend(); ++it) {
+      auto &[replayed, expected] = *it;
+      ReplayStats stats;
+      stats.height = replayed.height;
+      stats.blocks = replayed.blks.size();
+      OUTCOME_TRY(messages, countMessages(replayed));
+      stats.messages = messages;
+
+      stats_ = {};
+      auto start = std::chrono::steady_clock::now();
+      OUTCOME_TRY(interpreted,
+                  interpreter_->interpret(store_, replayed, indices_));
+      stats.duration = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start);
+      stats.store.blocks_read = stats_.blocks_read;
+      stats.store.bytes_read = stats_.bytes_read;
+      stats.store.blocks_written = stats_.blocks_written;
+      stats.store.bytes_written = stats_.bytes_written;
+      if (expected) {
+        stats.state_root_matches = interpreted.state_root == *expected;
+      }
+
+      if (callback) {
+        callback(stats);
+      }
+      result.push_back(stats);
+    }
+    return result;
+  }
+
+  outcome::result<uint64_t> TipsetReplayer::countMessages(
+      const Tipset &tipset) const {
+    uint64_t messages{0};
+    for (auto &block : tipset.blks) {
+      OUTCOME_TRY(meta, store_->getCbor<MsgMeta>(block.messages));
+      OUTCOME_TRY(bls_count, Amt(store_, meta.bls_messages).count());
+      OUTCOME_TRY(secp_count, Amt(store_, meta.secpk_messages).count());
+      messages += bls_count + secp_count;
+    }
+    return messages;
+  }
+}  // namespace fc::tools::vm_replay
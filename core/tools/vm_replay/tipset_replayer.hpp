@@ -0,0 +1,112 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_TOOLS_VM_REPLAY_TIPSET_REPLAYER_HPP
+#define CPP_FILECOIN_CORE_TOOLS_VM_REPLAY_TIPSET_REPLAYER_HPP
+
+#include <chrono>
+#include <functional>
+
+#include <boost/optional.hpp>
+
+#include "blockchain/block_validator/block_validator.hpp"
+#include "storage/chain/chain_store.hpp"
+#include "storage/ipfs/datastore.hpp"
+#include "vm/interpreter/interpreter.hpp"
+#include "vm/runtime/impl/charging_ipfs_datastore.hpp"
+
+namespace fc::tools::vm_replay {
+  using blockchain::block_validator::BlockValidator;
+  using blockchain::block_validator::scenarios::Scenario;
+  using primitives::block::BlockHeader;
+  using primitives::tipset::Tipset;
+  using storage::blockchain::ChainStore;
+  using storage::ipfs::IpfsDatastore;
+  using vm::indices::Indices;
+  using vm::interpreter::Interpreter;
+  using vm::runtime::ChargingIpfsDatastore;
+  using vm::runtime::IpldStats;
+
+  enum class ReplayError {
+    EMPTY_RANGE = 1,
+  };
+
+  /**
+   * @class TrustedBlockValidator accepts blocks of replayed repository, they
+   * were validated when stored and replay verifies state roots instead
+   */
+  class TrustedBlockValidator : public BlockValidator {
+   public:
+    outcome::result<void> validateBlock(
+        const BlockHeader &header, Scenario scenario) const override;
+
+    outcome::result<void> validateTipset(
+        const std::vector<BlockHeader> &headers,
+        Scenario scenario) const override;
+  };
+
+  /**
+   * Result of single tipset replay
+   */
+  struct ReplayStats {
+    uint64_t height{};
+    size_t blocks{};
+    uint64_t messages{};
+    std::chrono::microseconds duration{};
+    /// none if there is no child tipset to take expected state root from
+    boost::optional<bool> state_root_matches;
+    /// IPLD store traffic of tipset execution
+    IpldStats store;
+  };
+
+  /**
+   * @class TipsetReplayer re-executes chain tipsets and verifies resulting
+   * state roots against parent_state_root of the child tipsets
+   */
+  class TipsetReplayer {
+   public:
+    using Callback = std::function<void(const ReplayStats &)>;
+
+    /**
+     * @param store - state store, traffic of tipset execution is counted
+     * @param chain_store - chain store to look parent tipsets up
+     * @param interpreter - interpreter to execute tipsets
+     * @param indices - indices to execute tipsets with
+     */
+    TipsetReplayer(std::shared_ptr<IpfsDatastore> store,
+                   std::shared_ptr<ChainStore> chain_store,
+                   std::shared_ptr<Interpreter> interpreter,
+                   std::shared_ptr<Indices> indices);
+
+    /// Counting store references stats of replayer
+    TipsetReplayer(const TipsetReplayer &) = delete;
+    TipsetReplayer &operator=(const TipsetReplayer &) = delete;
+
+    /**
+     * @brief replays tipsets of chain ending with head in [from, to] heights
+     * range, in ascending height order
+     * @param head - chain head to look tipsets up from
+     * @param callback - receives stats of every replayed tipset
+     * @return stats of all replayed tipsets
+     */
+    outcome::result<std::vector<ReplayStats>> replay(const Tipset &head,
+                                                     uint64_t from,
+                                                     uint64_t to,
+                                                     const Callback &callback);
+
+   private:
+    outcome::result<uint64_t> countMessages(const Tipset &tipset) const;
+
+    IpldStats stats_;
+    std::shared_ptr<ChargingIpfsDatastore> store_;
+    std::shared_ptr<ChainStore> chain_store_;
+    std::shared_ptr<Interpreter> interpreter_;
+    std::shared_ptr<Indices> indices_;
+  };
+}  // namespace fc::tools::vm_replay
+
+OUTCOME_HPP_DECLARE_ERROR(fc::tools::vm_replay, ReplayError);
+
+#endif  // CPP_FILECOIN_CORE_TOOLS_VM_REPLAY_TIPSET_REPLAYER_HPP
@@ -2,3 +2,20 @@
  * Copyright Soramitsu Co., Ltd. All Rights Reserved.
  * SPDX-License-Identifier: Apache-2.0
  */
+
+#include "vm/indices/impl/indices_impl.hpp"
+
+namespace fc::vm::indices {
+
+  fc::power::Power IndicesImpl::consensusPowerForStorageWeight(
+      SectorStorageWeightDesc storage_weight_desc) {
+    // From spec: power of sector is its size
+    return storage_weight_desc.sector_size;
+  }
+
+  fc::power::Power IndicesImpl::storagePowerConsensusMinMinerPower() {
+    // From spec: 100 TiB, same as kConsensusMinerMinPower of power actor
+    return 100 * (primitives::BigInt(1) << 40);
+  }
+
+}  // namespace fc::vm::indices
@@ -0,0 +1,31 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_VM_INDICES_IMPL_INDICES_IMPL_HPP
+#define CPP_FILECOIN_VM_INDICES_IMPL_INDICES_IMPL_HPP
+
+#include "vm/indices/indices.hpp"
+
+namespace fc::vm::indices {
+
+  /**
+   * @class IndicesImpl implements global parameterization functions as
+   * defined by spec
+   */
+  class IndicesImpl : public Indices {
+   public:
+    ~IndicesImpl() override = default;
+
+    /** \copydoc Indices::consensusPowerForStorageWeight() */
+    fc::power::Power consensusPowerForStorageWeight(
+        SectorStorageWeightDesc storage_weight_desc) override;
+
+    /** \copydoc Indices::storagePowerConsensusMinMinerPower() */
+    fc::power::Power storagePowerConsensusMinMinerPower() override;
+  };
+
+}  // namespace fc::vm::indices
+
+#endif  // CPP_FILECOIN_VM_INDICES_IMPL_INDICES_IMPL_HPP
@@ -0,0 +1,78 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_VM_RUNTIME_ACTOR_STATE_CACHE_HPP
+#define CPP_FILECOIN_CORE_VM_RUNTIME_ACTOR_STATE_CACHE_HPP
+
+#include <any>
+#include <map>
+
+#include <boost/optional.hpp>
+
+#include "primitives/cid/cid.hpp"
+
+namespace fc::vm::runtime {
+
+  /**
+   * Decoded actor states by head CID. Lets consecutive calls to the same actor
+   * skip loading and decoding of unchanged state. Only flushed states are
+   * cached, so copies never share unflushed HAMT/AMT nodes. Encoded size is
+   * kept, so gas is charged as if state was loaded.
+   */
+  class ActorStateCache {
+   public:
+    /// Cached state with its encoded size
+    template <typename T>
+    struct Entry {
+      T state;
+      size_t size;
+    };
+
+    /// Max number of cached states, cache is cleared when exceeded
+    static constexpr size_t kMaxSize = 1024;
+
+    /**
+     * Get copy of decoded state
+     * @tparam T - state type
+     * @param head - actor state CID
+     * @return state or none if not cached or cached with another type
+     */
+    template <typename T>
+    boost::optional<Entry<T>> get(const CID &head) const {
+      auto it = states_.find(head);
+      if (it == states_.end()) {
+        return boost::none;
+      }
+      if (auto state = std::any_cast<T>(&it->second.first)) {
+        return Entry<T>{*state, it->second.second};
+      }
+      return boost::none;
+    }
+
+    /**
+     * Cache decoded state
+     * @param head - actor state CID
+     * @param state - state decoded from head or encoded to head
+     * @param size - encoded size of state
+     */
+    template <typename T>
+    void put(const CID &head, const T &state, size_t size) {
+      if (states_.size() >= kMaxSize) {
+        states_.clear();
+      }
+      states_.insert_or_assign(head, std::make_pair(std::any{state}, size));
+    }
+
+    void clear() {
+      states_.clear();
+    }
+
+   private:
+    std::map<CID, std::pair<std::any, size_t>> states_;
+  };
+
+}  // namespace fc::vm::runtime
+
+#endif  // CPP_FILECOIN_CORE_VM_RUNTIME_ACTOR_STATE_CACHE_HPP
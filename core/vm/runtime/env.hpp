@@ -7,14 +7,18 @@
 #define FILECOIN_CORE_VM_RUNTIME_ENV_HPP
 
 #include "crypto/randomness/randomness_provider.hpp"
+#include "primitives/types.hpp"
 #include "vm/actor/invoker.hpp"
 #include "vm/indices/indices.hpp"
+#include "vm/runtime/actor_state_cache.hpp"
+#include "vm/runtime/runtime_types.hpp"
 #include "vm/state/state_tree.hpp"
 
 namespace fc::vm::runtime {
   using actor::Invoker;
   using crypto::randomness::RandomnessProvider;
   using indices::Indices;
+  using primitives::GasAmount;
   using state::StateTree;
 
   /// Environment contains objects that are shared by runtime contexts
@@ -35,7 +39,7 @@ namespace fc::vm::runtime {
     outcome::result<MessageReceipt> applyMessage(
         const UnsignedMessage &message);
 
-    outcome::result<InvocationOutput> send(BigInt &gas_used,
+    outcome::result<InvocationOutput> send(GasAmount &gas_used,
                                            const Address &origin,
                                            const UnsignedMessage &message);
 
@@ -45,6 +49,11 @@ namespace fc::vm::runtime {
     std::shared_ptr<Invoker> invoker;
     ChainEpoch chain_epoch;
     Address block_miner;
+    /// Decoded actor states shared by all messages applied in environment
+    std::shared_ptr<ActorStateCache> state_cache{
+        std::make_shared<ActorStateCache>()};
+    /// IPLD traffic of the last applied message
+    IpldStats ipld_stats;
   };
 }  // namespace fc::vm::runtime
 
@@ -6,18 +6,18 @@
 #ifndef CPP_FILECOIN_CORE_VM_RUNTIME_GAS_COST_HPP
 #define CPP_FILECOIN_CORE_VM_RUNTIME_GAS_COST_HPP
 
-#include "primitives/big_int.hpp"
+#include "primitives/types.hpp"
 
 namespace fc::vm::runtime {
 
-  using primitives::BigInt;
+  using primitives::GasAmount;
 
-  inline static const BigInt kInfiniteGas{-1};
+  constexpr GasAmount kInfiniteGas{-1};
 
   // TODO (a.chernyshov) https://soramitsu.atlassian.net/browse/FIL-131 Assign
   // after spec is updated. All constants that are not defined in Lotus are
   // initialized with this value.
-  inline static const BigInt kGasAmountPlaceholder{0};
+  constexpr GasAmount kGasAmountPlaceholder{0};
 
   /**
    * Gas cost charged to the originator of an on-chain message (regardless of
@@ -27,15 +27,15 @@ namespace fc::vm::runtime {
    * up to but excluding any actual processing by the VM.
    * This is the cost a block producer burns when including an invalid message.
    */
-  inline static const BigInt kOnChainMessageBaseGasCost{kGasAmountPlaceholder};
-  inline static const BigInt kOnChainMessagePerByteGasCharge{2};
+  constexpr GasAmount kOnChainMessageBaseGasCost{kGasAmountPlaceholder};
+  constexpr GasAmount kOnChainMessagePerByteGasCharge{2};
 
   /**
    * Gas cost charged to the originator of a non-nil return value produced by an
    * on-chain message is given by:
    *   len(return value)*OnChainReturnValuePerByte
    */
-  inline static const BigInt kOnChainReturnValuePerByteGasCost{
+  constexpr GasAmount kOnChainReturnValuePerByteGasCost{
       kGasAmountPlaceholder};
 
   /**
@@ -45,28 +45,28 @@ namespace fc::vm::runtime {
    * sender's sequence number. Load and store of actor sub-state is charged
    * separately.
    */
-  inline static const BigInt kSendBaseGasCost{kGasAmountPlaceholder};
+  constexpr GasAmount kSendBaseGasCost{kGasAmountPlaceholder};
 
   /**
    * Gas cost charged, in addition to SendBase, if a message send is accompanied
    * by any nonzero currency amount. Accounts for writing receiver's new balance
    * (the sender's state is already accounted for).
    */
-  inline static const BigInt kSendTransferFundsGasCost{10};
+  constexpr GasAmount kSendTransferFundsGasCost{10};
 
   /**
    * Gas cost charged, in addition to SendBase, if a message invokes a method on
    * the receiver. Accounts for the cost of loading receiver code and method
    * dispatch.
    */
-  inline static const BigInt kSendInvokeMethodGasCost{5};
+  constexpr GasAmount kSendInvokeMethodGasCost{5};
 
   /**
    * Gas cost (Base + len * PerByte) for any Get operation to the IPLD store in
    * the runtime VM context.
    */
-  inline static const BigInt kIpldGetBaseGasCost{10};
-  inline static const BigInt kIpldGetPerByteGasCost{1};
+  constexpr GasAmount kIpldGetBaseGasCost{10};
+  constexpr GasAmount kIpldGetPerByteGasCost{1};
 
   /**
    * Gas cost (Base + len * PerByte) for any Put operation to the IPLD store in
@@ -75,39 +75,39 @@ namespace fc::vm::runtime {
    * operations, since they reflect not only serialization/deserialization but
    * also persistent storage of chain data.
    */
-  inline static const BigInt kIpldPutBaseGasCost{20};
-  inline static const BigInt kIpldPutPerByteGasCost{2};
+  constexpr GasAmount kIpldPutBaseGasCost{20};
+  constexpr GasAmount kIpldPutPerByteGasCost{2};
 
   /**
    * Gas cost for updating an actor's substate (i.e., UpdateRelease). This is in
    * addition to a per-byte fee for the state as for IPLD Get/Put.
    */
-  inline static const BigInt kUpdateActorSubstateGasCost{kGasAmountPlaceholder};
+  constexpr GasAmount kUpdateActorSubstateGasCost{kGasAmountPlaceholder};
 
   /**
    * Gas cost for creating a new actor (via InitActor's Exec method). Actor
    * sub-state is charged separately.
    */
-  inline static const BigInt kExecNewActorGasCost{kGasAmountPlaceholder};
+  constexpr GasAmount kExecNewActorGasCost{kGasAmountPlaceholder};
 
   /**
    * Gas cost for deleting an actor.
    */
-  inline static const BigInt kDeleteActorGasCost{kGasAmountPlaceholder};
+  constexpr GasAmount kDeleteActorGasCost{kGasAmountPlaceholder};
 
   /**
    * Gas cost charged per public-key cryptography operation (e.g., signature
    * verification).
    */
-  inline static const BigInt kPublicKeyCryptoOperationGasCost{
+  constexpr GasAmount kPublicKeyCryptoOperationGasCost{
       kGasAmountPlaceholder};
 
   /**
    * Gas cost of new state commit
    */
-  inline static const BigInt kCommitGasCost{50};
+  constexpr GasAmount kCommitGasCost{50};
 
-  inline static const BigInt kInitActorExecCost{100};
+  constexpr GasAmount kInitActorExecCost{100};
 }  // namespace fc::vm::runtime
 
 #endif  // CPP_FILECOIN_CORE_VM_RUNTIME_GAS_COST_HPP
@@ -0,0 +1,64 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/runtime/impl/charging_ipfs_datastore.hpp"
+
+namespace fc::vm::runtime {
+
+  ChargingIpfsDatastore::ChargingIpfsDatastore(
+      std::shared_ptr<IpfsDatastore> store, Runtime &runtime, IpldStats &stats)
+      : store_{std::move(store)}, runtime_{&runtime}, stats_{&stats} {
+    BOOST_ASSERT_MSG(store_ != nullptr, "store is nullptr");
+  }
+
+  ChargingIpfsDatastore::ChargingIpfsDatastore(
+      std::shared_ptr<IpfsDatastore> store, IpldStats &stats)
+      : store_{std::move(store)}, runtime_{nullptr}, stats_{&stats} {
+    BOOST_ASSERT_MSG(store_ != nullptr, "store is nullptr");
+  }
+
+  outcome::result<bool> ChargingIpfsDatastore::contains(const CID &key) const {
+    return store_->contains(key);
+  }
+
+  outcome::result<void> ChargingIpfsDatastore::set(const CID &key,
+                                                   Value value) {
+    if (runtime_ != nullptr) {
+      OUTCOME_TRY(runtime_->chargeIpldPut(value.size()));
+    }
+    if (stats_ == nullptr) {
+      return store_->set(key, std::move(value));
+    }
+    if (!stats_->written.insert(key).second) {
+      return outcome::success();
+    }
+    ++stats_->blocks_written;
+    stats_->bytes_written += value.size();
+    return store_->set(key, std::move(value));
+  }
+
+  outcome::result<ChargingIpfsDatastore::Value> ChargingIpfsDatastore::get(
+      const CID &key) const {
+    OUTCOME_TRY(value, store_->get(key));
+    if (runtime_ != nullptr) {
+      OUTCOME_TRY(runtime_->chargeIpldGet(value.size()));
+    }
+    if (stats_ != nullptr) {
+      ++stats_->blocks_read;
+      stats_->bytes_read += value.size();
+    }
+    return std::move(value);
+  }
+
+  outcome::result<void> ChargingIpfsDatastore::remove(const CID &key) {
+    return store_->remove(key);
+  }
+
+  void ChargingIpfsDatastore::detach() {
+    runtime_ = nullptr;
+    stats_ = nullptr;
+  }
+
+}  // namespace fc::vm::runtime
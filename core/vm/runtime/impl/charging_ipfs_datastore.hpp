@@ -0,0 +1,63 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_VM_RUNTIME_IMPL_CHARGING_IPFS_DATASTORE_HPP
+#define CPP_FILECOIN_CORE_VM_RUNTIME_IMPL_CHARGING_IPFS_DATASTORE_HPP
+
+#include "storage/ipfs/datastore.hpp"
+#include "vm/runtime/runtime.hpp"
+
+namespace fc::vm::runtime {
+
+  /**
+   * @class ChargingIpfsDatastore charges runtime gas for IPLD gets and puts
+   * of actors and counts store traffic of applied message. Identical puts
+   * within message are charged, but written only once. Without runtime it
+   * only counts traffic, e.g. of replayed tipsets.
+   */
+  class ChargingIpfsDatastore : public IpfsDatastore {
+   public:
+    /**
+     * @param store - state store
+     * @param runtime - runtime to charge gas, must outlive datastore or detach
+     * it
+     * @param stats - IPLD stats of applied message
+     */
+    ChargingIpfsDatastore(std::shared_ptr<IpfsDatastore> store,
+                          Runtime &runtime,
+                          IpldStats &stats);
+
+    /**
+     * @param store - store to count traffic of
+     * @param stats - traffic counters, must outlive datastore or detach it
+     */
+    ChargingIpfsDatastore(std::shared_ptr<IpfsDatastore> store,
+                          IpldStats &stats);
+
+    ~ChargingIpfsDatastore() override = default;
+
+    outcome::result<bool> contains(const CID &key) const override;
+
+    outcome::result<void> set(const CID &key, Value value) override;
+
+    outcome::result<Value> get(const CID &key) const override;
+
+    outcome::result<void> remove(const CID &key) override;
+
+    /**
+     * Stop charging and counting, called when runtime is destroyed while
+     * datastore is still referenced (e.g. by cached actor state)
+     */
+    void detach();
+
+   private:
+    std::shared_ptr<IpfsDatastore> store_;
+    Runtime *runtime_;
+    IpldStats *stats_;
+  };
+
+}  // namespace fc::vm::runtime
+
+#endif  // CPP_FILECOIN_CORE_VM_RUNTIME_IMPL_CHARGING_IPFS_DATASTORE_HPP
@@ -5,6 +5,8 @@
 
 #include "vm/runtime/env.hpp"
 
+#include <limits>
+
 #include "vm/actor/builtin/account/account_actor.hpp"
 #include "vm/exit_code/exit_code.hpp"
 #include "vm/runtime/gas_cost.hpp"
@@ -16,8 +18,24 @@ namespace fc::vm::runtime {
   using actor::builtin::account::AccountActor;
   using storage::hamt::HamtError;
 
+  namespace {
+    /**
+     * Convert message gas limit to machine gas amount. Limits outside int64
+     * range are rejected, so refund and miner payment are computed from the
+     * same limit that was charged up-front
+     */
+    outcome::result<GasAmount> toGasAmount(const BigInt &gas_limit) {
+      if (gas_limit < 0 || gas_limit > std::numeric_limits<GasAmount>::max()) {
+        return RuntimeError::INVALID_GAS_LIMIT;
+      }
+      return static_cast<GasAmount>(gas_limit);
+    }
+  }  // namespace
+
   outcome::result<MessageReceipt> Env::applyMessage(
       const UnsignedMessage &message) {
+    ipld_stats = {};
+    OUTCOME_TRY(gas_limit, toGasAmount(message.gasLimit));
     BigInt gas_cost = message.gasLimit * message.gasPrice;
     BigInt total_cost = gas_cost + message.value;
 
@@ -34,28 +52,29 @@ namespace fc::vm::runtime {
     OUTCOME_TRY(state_tree->set(message.from, from_actor));
 
     OUTCOME_TRY(serialized_message, codec::cbor::encode(message));
-    BigInt gas_used =
+    GasAmount gas_used =
         kOnChainMessageBaseGasCost
-        + serialized_message.size() * kOnChainMessagePerByteGasCharge;
+        + static_cast<GasAmount>(serialized_message.size())
+              * kOnChainMessagePerByteGasCharge;
 
     auto result = send(gas_used, message.from, message);
     if (!result) {
       if (!isVMExitCode(result.error())) {
         return result.error();
       }
-      gas_used = message.gasLimit;
+      gas_used = gas_limit;
     } else {
       OUTCOME_TRY(from_actor_2, state_tree->get(message.from));
       OUTCOME_TRY(RuntimeImpl::transfer(
           gas_holder,
           from_actor_2,
-          (message.gasLimit - gas_used) * message.gasPrice));
+          BigInt{gas_limit - gas_used} * message.gasPrice));
       OUTCOME_TRY(state_tree->set(message.from, from_actor_2));
     }
 
     OUTCOME_TRY(miner_actor, state_tree->get(block_miner));
     OUTCOME_TRY(RuntimeImpl::transfer(
-        gas_holder, miner_actor, gas_used * message.gasPrice));
+        gas_holder, miner_actor, BigInt{gas_used} * message.gasPrice));
     OUTCOME_TRY(state_tree->set(block_miner, miner_actor));
 
     OUTCOME_TRY(ret_code, getRetCode(result));
@@ -66,7 +85,7 @@ namespace fc::vm::runtime {
     };
   }
 
-  outcome::result<InvocationOutput> Env::send(BigInt &gas_used,
+  outcome::result<InvocationOutput> Env::send(GasAmount &gas_used,
                                               const Address &origin,
                                               const UnsignedMessage &message) {
     Actor to_actor;
@@ -80,10 +99,11 @@ namespace fc::vm::runtime {
     } else {
       to_actor = maybe_to_actor.value();
     }
+    OUTCOME_TRY(gas_limit, toGasAmount(message.gasLimit));
     RuntimeImpl runtime{shared_from_this(),
                         message,
                         origin,
-                        message.gasLimit,
+                        gas_limit,
                         gas_used,
                         to_actor.head};
 
@@ -21,6 +21,8 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::vm::runtime, RuntimeError, e) {
       return "RuntimeError: not enough funds";
     case RuntimeError::NOT_ENOUGH_GAS:
       return "RuntimeError: not enough gas";
+    case RuntimeError::INVALID_GAS_LIMIT:
+      return "RuntimeError: gas limit is out of range";
     case RuntimeError::UNKNOWN:
       break;
   }
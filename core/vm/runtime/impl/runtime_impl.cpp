@@ -5,9 +5,12 @@
 
 #include "vm/runtime/impl/runtime_impl.hpp"
 
+#include <limits>
+
 #include "codec/cbor/cbor.hpp"
 #include "proofs/proofs.hpp"
 #include "vm/actor/builtin/account/account_actor.hpp"
+#include "vm/runtime/impl/charging_ipfs_datastore.hpp"
 #include "vm/runtime/gas_cost.hpp"
 #include "vm/runtime/impl/actor_state_handle_impl.hpp"
 #include "vm/runtime/runtime_error.hpp"
@@ -33,17 +36,23 @@ namespace fc::vm::runtime {
   RuntimeImpl::RuntimeImpl(std::shared_ptr<Env> env,
                            UnsignedMessage message,
                            Address origin,
-                           BigInt gas_available,
-                           BigInt gas_used,
+                           GasAmount gas_available,
+                           GasAmount gas_used,
                            ActorSubstateCID current_actor_state)
       : env_{std::move(env)},
         state_tree_{env_->state_tree},
         message_{std::move(message)},
         origin_{std::move(origin)},
-        gas_available_{std::move(gas_available)},
-        gas_used_{std::move(gas_used)},
+        gas_available_{gas_available},
+        gas_used_{gas_used},
         current_actor_state_{std::move(current_actor_state)} {}
 
+  RuntimeImpl::~RuntimeImpl() {
+    if (ipld_) {
+      ipld_->detach();
+    }
+  }
+
   ChainEpoch RuntimeImpl::getCurrentEpoch() const {
     return env_->chain_epoch;
   }
@@ -134,8 +143,11 @@ namespace fc::vm::runtime {
   }
 
   std::shared_ptr<IpfsDatastore> RuntimeImpl::getIpfsDatastore() {
-    // TODO(turuslan): FIL-131 charging store
-    return state_tree_->getStore();
+    if (!ipld_) {
+      ipld_ = std::make_shared<ChargingIpfsDatastore>(
+          state_tree_->getStore(), *this, env_->ipld_stats);
+    }
+    return ipld_;
   }
 
   std::reference_wrapper<const UnsignedMessage> RuntimeImpl::getMessage() {
@@ -146,6 +158,10 @@ namespace fc::vm::runtime {
     return current_actor_state_;
   }
 
+  std::shared_ptr<ActorStateCache> RuntimeImpl::getActorStateCache() {
+    return env_->state_cache;
+  }
+
   fc::outcome::result<void> RuntimeImpl::commit(
       const ActorSubstateCID &new_state) {
     OUTCOME_TRY(chargeGas(kCommitGasCost));
@@ -153,7 +169,7 @@ namespace fc::vm::runtime {
     return outcome::success();
   }
 
-  BigInt RuntimeImpl::gasUsed() const {
+  GasAmount RuntimeImpl::gasUsed() const {
     return gas_used_;
   }
 
@@ -201,8 +217,12 @@ namespace fc::vm::runtime {
     return RuntimeError::UNKNOWN;
   }
 
-  fc::outcome::result<void> RuntimeImpl::chargeGas(const BigInt &amount) {
-    gas_used_ = gas_used_ + amount;
+  fc::outcome::result<void> RuntimeImpl::chargeGas(GasAmount amount) {
+    // gas used is never negative, so the bound itself can not overflow
+    if (amount > std::numeric_limits<GasAmount>::max() - gas_used_) {
+      return RuntimeError::NOT_ENOUGH_GAS;
+    }
+    gas_used_ += amount;
     if (gas_available_ != kInfiniteGas && gas_available_ < gas_used_) {
       return RuntimeError::NOT_ENOUGH_GAS;
     }
@@ -15,12 +15,15 @@
 #include "primitives/chain_epoch/chain_epoch.hpp"
 #include "primitives/piece/piece.hpp"
 #include "primitives/sector/sector.hpp"
+#include "primitives/types.hpp"
 #include "storage/ipfs/datastore.hpp"
 #include "vm/actor/actor_encoding.hpp"
 #include "vm/exit_code/exit_code.hpp"
 #include "vm/indices/indices.hpp"
 #include "vm/message/message.hpp"
+#include "vm/runtime/actor_state_cache.hpp"
 #include "vm/runtime/actor_state_handle.hpp"
+#include "vm/runtime/gas_cost.hpp"
 #include "vm/runtime/runtime_types.hpp"
 
 namespace fc::vm::runtime {
@@ -37,6 +40,7 @@ namespace fc::vm::runtime {
   using indices::Indices;
   using message::UnsignedMessage;
   using primitives::ChainEpoch;
+  using primitives::GasAmount;
   using primitives::TokenAmount;
   using primitives::address::Address;
   using primitives::block::BlockHeader;
@@ -142,11 +146,28 @@ namespace fc::vm::runtime {
     virtual std::reference_wrapper<const UnsignedMessage> getMessage() = 0;
 
     /// Try to charge gas or throw if there is not enoght gas
-    virtual outcome::result<void> chargeGas(const BigInt &amount) = 0;
+    virtual outcome::result<void> chargeGas(GasAmount amount) = 0;
+
+    /// Charge gas of IPLD get of value of given size
+    outcome::result<void> chargeIpldGet(size_t size) {
+      return chargeGas(kIpldGetBaseGasCost
+                       + static_cast<GasAmount>(size) * kIpldGetPerByteGasCost);
+    }
+
+    /// Charge gas of IPLD put of value of given size
+    outcome::result<void> chargeIpldPut(size_t size) {
+      return chargeGas(kIpldPutBaseGasCost
+                       + static_cast<GasAmount>(size) * kIpldPutPerByteGasCost);
+    }
 
     /// Get current actor state root CID
     virtual ActorSubstateCID getCurrentActorState() = 0;
 
+    /// Get cache of decoded actor states, if runtime has one
+    virtual std::shared_ptr<ActorStateCache> getActorStateCache() {
+      return nullptr;
+    }
+
     /// Update actor state CID
     virtual outcome::result<void> commit(const ActorSubstateCID &new_state) = 0;
 
@@ -222,19 +243,48 @@ namespace fc::vm::runtime {
     /// Get decoded current actor state
     template <typename T>
     outcome::result<T> getCurrentActorStateCbor() {
-      return getIpfsDatastore()->getCbor<T>(getCurrentActorState());
+      auto cache = getActorStateCache();
+      auto head = getCurrentActorState();
+      if (cache) {
+        if (auto cached = cache->get<T>(head)) {
+          // cache is node-local, so read is charged as if it was not cached
+          OUTCOME_TRY(chargeIpldGet(cached->size));
+          return std::move(cached->state);
+        }
+      }
+      OUTCOME_TRY(bytes, getIpfsDatastore()->get(head));
+      OUTCOME_TRY(state, codec::cbor::decode<T>(bytes));
+      if (cache) {
+        cache->put(head, state, bytes.size());
+      }
+      return std::move(state);
     }
 
     /**
-     * Commit actor state
+     * Commit actor state. With state cache, unchanged state is not written to
+     * store again and committed state is cached for next calls. Gas is charged
+     * as without cache.
      * @tparam T - POD state type
      * @param state - actor state structure
      * @return error in case of failure
      */
     template <typename T>
     outcome::result<void> commitState(const T &state) {
-      OUTCOME_TRY(state_cid, getIpfsDatastore()->setCbor(state));
+      auto cache = getActorStateCache();
+      if (!cache) {
+        OUTCOME_TRY(state_cid, getIpfsDatastore()->setCbor(state));
+        OUTCOME_TRY(commit(ActorSubstateCID{state_cid}));
+        return outcome::success();
+      }
+      OUTCOME_TRY(bytes, codec::cbor::encode(state));
+      OUTCOME_TRY(state_cid, common::getCidOf(bytes));
+      if (state_cid == getCurrentActorState()) {
+        OUTCOME_TRY(chargeIpldPut(bytes.size()));
+      } else {
+        OUTCOME_TRY(getIpfsDatastore()->set(state_cid, Buffer(bytes)));
+      }
       OUTCOME_TRY(commit(ActorSubstateCID{state_cid}));
+      cache->put(state_cid, state, bytes.size());
       return outcome::success();
     }
 
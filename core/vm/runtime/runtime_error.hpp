@@ -20,6 +20,7 @@ namespace fc::vm::runtime {
     ACTOR_NOT_FOUND,
     NOT_ENOUGH_FUNDS,
     NOT_ENOUGH_GAS,
+    INVALID_GAS_LIMIT,
     UNKNOWN = 1000
   };
 
@@ -6,6 +6,8 @@
 #ifndef CPP_FILECOIN_CORE_VM_RUNTIME_RUNTIME_TYPES_HPP
 #define CPP_FILECOIN_CORE_VM_RUNTIME_RUNTIME_TYPES_HPP
 
+#include <set>
+
 #include "codec/cbor/streams_annotation.hpp"
 #include "common/buffer.hpp"
 #include "primitives/address/address.hpp"
@@ -48,6 +50,18 @@ namespace fc::vm::runtime {
 
   CBOR_TUPLE(MessageReceipt, exit_code, return_value, gas_used)
 
+  /**
+   * IPLD store traffic of actors during message application
+   */
+  struct IpldStats {
+    uint64_t blocks_read{};
+    uint64_t bytes_read{};
+    uint64_t blocks_written{};
+    uint64_t bytes_written{};
+    /// Blocks already written by current message, repeated puts are skipped
+    std::set<CID> written;
+  };
+
   struct ExecutionResult {
     UnsignedMessage message;
     MessageReceipt receipt;
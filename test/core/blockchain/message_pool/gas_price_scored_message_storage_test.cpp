@@ -7,19 +7,36 @@
 
 #include "blockchain/message_pool/impl/gas_price_scored_message_storage.hpp"
 #include "blockchain/message_pool/message_pool_error.hpp"
+#include "primitives/block/block.hpp"
+#include "storage/amt/amt.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
 #include "testutil/literals.hpp"
+#include "testutil/mocks/blockchain/message_pool/message_pre_executor_mock.hpp"
+#include "testutil/mocks/storage/chain/chain_store_mock.hpp"
 #include "testutil/outcome.hpp"
 #include "testutil/vm/message/message_test_util.hpp"
 
 using fc::blockchain::message_pool::GasPriceScoredMessageStorage;
 using fc::blockchain::message_pool::MessagePoolError;
+using fc::blockchain::message_pool::MessagePreExecutorMock;
+using fc::blockchain::message_pool::NonceStatus;
+using fc::blockchain::message_pool::PreExecutionResult;
 using fc::primitives::BigInt;
 using fc::primitives::address::Address;
 using fc::primitives::address::Network;
+using fc::primitives::block::BlockHeader;
+using fc::primitives::block::MsgMeta;
+using fc::primitives::tipset::HeadChange;
+using fc::primitives::tipset::HeadChangeType;
+using fc::primitives::tipset::Tipset;
+using fc::storage::amt::Amt;
+using fc::storage::ipfs::InMemoryDatastore;
 using fc::vm::message::MethodNumber;
 using fc::vm::message::MethodParams;
 using fc::vm::message::SignedMessage;
 using fc::vm::message::UnsignedMessage;
+using fc::vm::message::size;
+using testing::_;
 using PrivateKey = std::array<uint8_t, 32>;
 
 class GasPricedScoredMessageStorageTest : public testing::Test {
@@ -42,6 +59,13 @@ class GasPricedScoredMessageStorageTest : public testing::Test {
       "8e8c5263df0022d8e29cab943d57d851722c38ee1dbe7f8c29c0498156496f29"_blob32;
   SignedMessage message =
       signMessageBls(unsigned_message, bls_private_key).value();
+
+  SignedMessage makeMessage(uint64_t nonce, const BigInt &gas_price) {
+    auto unsigned_copy = unsigned_message;
+    unsigned_copy.nonce = nonce;
+    unsigned_copy.gasPrice = gas_price;
+    return signMessageBls(unsigned_copy, bls_private_key).value();
+  }
 };
 
 /**
@@ -86,9 +110,10 @@ TEST_F(GasPricedScoredMessageStorageTest, GetMoreThanExists) {
 }
 
 /**
- * @given MessageStorage populated with messages with different gas price
+ * @given MessageStorage populated with messages of one sender with different
+ * gas price
  * @when get scored is called
- * @then returned messages scored on gas price
+ * @then returned messages keep nonce order of sender
  */
 TEST_F(GasPricedScoredMessageStorageTest, SunnyDay) {
   // populate
@@ -153,7 +178,295 @@ TEST_F(GasPricedScoredMessageStorageTest, SunnyDay) {
 
   auto top = message_storage.getTopScored(3);
   ASSERT_EQ(top.size(), 3);
-  ASSERT_EQ(top[0].message.gasPrice, gas_price3);
-  ASSERT_EQ(top[1].message.gasPrice, gas_price2);
-  ASSERT_EQ(top[2].message.gasPrice, gas_price1);
+  ASSERT_EQ(top[0].message.nonce, 0);
+  ASSERT_EQ(top[1].message.nonce, 1);
+  ASSERT_EQ(top[2].message.nonce, 2);
+}
+
+/**
+ * @given messages of two senders and nonce gap of first sender
+ * @when get scored is called
+ * @then best queue head is taken each time and messages after gap are skipped
+ */
+TEST_F(GasPricedScoredMessageStorageTest, ScoresQueueHeads) {
+  auto first0 = makeMessage(0, 1);
+  auto first1 = makeMessage(1, 5);
+  auto first3 = makeMessage(3, 9);
+  unsigned_message.from = to;
+  auto second0 = makeMessage(0, 3);
+  for (auto &message : {first0, first1, first3, second0}) {
+    EXPECT_OUTCOME_TRUE_1(message_storage.put(message));
+  }
+
+  auto top = message_storage.getTopScored(4);
+  ASSERT_EQ(top.size(), 3);
+  EXPECT_EQ(top[0].message, second0.message);
+  EXPECT_EQ(top[1].message, first0.message);
+  EXPECT_EQ(top[2].message, first1.message);
+
+  message_storage.remove(first0);
+  top = message_storage.getTopScored(1);
+  ASSERT_EQ(top.size(), 1);
+  EXPECT_EQ(top[0].message, first1.message);
+}
+
+/**
+ * @given MessageStorage with pre-executor
+ * @when messages failing on head state or with stale nonce are put
+ * @then messages are rejected
+ */
+TEST_F(GasPricedScoredMessageStorageTest, PreExecutionDropsFailing) {
+  auto pre_executor = std::make_shared<MessagePreExecutorMock>();
+  GasPriceScoredMessageStorage storage{pre_executor};
+  auto failing = makeMessage(0, 1);
+  auto stale = makeMessage(1, 1);
+  EXPECT_CALL(*pre_executor, preExecute(failing.message))
+      .WillOnce(testing::Return(
+          PreExecutionResult{NonceStatus::VALID, 10, 1}));
+  EXPECT_CALL(*pre_executor, preExecute(stale.message))
+      .WillOnce(testing::Return(PreExecutionResult{NonceStatus::STALE}));
+
+  EXPECT_OUTCOME_ERROR(MessagePoolError::MESSAGE_WILL_FAIL,
+                       storage.put(failing));
+  EXPECT_OUTCOME_ERROR(MessagePoolError::MESSAGE_WILL_FAIL, storage.put(stale));
+  ASSERT_TRUE(storage.getTopScored(2).empty());
+}
+
+/**
+ * @given MessageStorage with pre-executor
+ * @when message with valid nonce and message with future nonce and higher gas
+ * price are put
+ * @then message with valid nonce is scored first and its gas used is cached
+ */
+TEST_F(GasPricedScoredMessageStorageTest, PreExecutionDeprioritizesFuture) {
+  auto pre_executor = std::make_shared<MessagePreExecutorMock>();
+  GasPriceScoredMessageStorage storage{pre_executor};
+  auto valid = makeMessage(0, 1);
+  auto future = makeMessage(1, 2);
+  EXPECT_CALL(*pre_executor, preExecute(valid.message))
+      .WillOnce(testing::Return(
+          PreExecutionResult{NonceStatus::VALID, 10, 0}));
+  EXPECT_CALL(*pre_executor, preExecute(future.message))
+      .WillOnce(testing::Return(PreExecutionResult{NonceStatus::FUTURE}));
+
+  EXPECT_OUTCOME_TRUE_1(storage.put(valid));
+  EXPECT_OUTCOME_TRUE_1(storage.put(future));
+  auto top = storage.getTopScored(2);
+  ASSERT_EQ(top.size(), 2);
+  EXPECT_EQ(top[0].message, valid.message);
+  EXPECT_EQ(top[1].message, future.message);
+  EXPECT_EQ(storage.getPreExecutionResult(valid)->gas_used, 10);
+}
+
+/**
+ * @given MessageStorage with pre-executor, sender whose queue head has future
+ * nonce and another sender with valid nonce
+ * @when top scored messages are requested
+ * @then only messages of sender with valid nonce are returned
+ */
+TEST_F(GasPricedScoredMessageStorageTest, PreExecutionSkipsFutureHeads) {
+  auto pre_executor = std::make_shared<MessagePreExecutorMock>();
+  GasPriceScoredMessageStorage storage{pre_executor};
+  auto future = makeMessage(5, 3);
+  auto future_next = makeMessage(6, 3);
+  auto unsigned_valid = unsigned_message;
+  unsigned_valid.from = Address{Network::TESTNET, 1003};
+  unsigned_valid.gasPrice = 1;
+  auto valid = signMessageBls(unsigned_valid, bls_private_key).value();
+  EXPECT_CALL(*pre_executor, preExecute(_))
+      .WillRepeatedly(testing::Return(PreExecutionResult{NonceStatus::FUTURE}));
+  EXPECT_CALL(*pre_executor, preExecute(valid.message))
+      .WillOnce(testing::Return(
+          PreExecutionResult{NonceStatus::VALID, 10, 0}));
+
+  EXPECT_OUTCOME_TRUE_1(storage.put(future));
+  EXPECT_OUTCOME_TRUE_1(storage.put(future_next));
+  EXPECT_OUTCOME_TRUE_1(storage.put(valid));
+  auto top = storage.getTopScored(3);
+  ASSERT_EQ(top.size(), 1);
+  EXPECT_EQ(top[0].message, valid.message);
+}
+
+/**
+ * @given MessageStorage with pre-executor and messages with future nonces
+ * @when head changes
+ * @then cached results are dropped, queue head is pre-executed again on new
+ * head and dropped when it became stale
+ */
+TEST_F(GasPricedScoredMessageStorageTest, PreExecutionRefreshedOnHeadChange) {
+  auto pre_executor = std::make_shared<MessagePreExecutorMock>();
+  GasPriceScoredMessageStorage storage{pre_executor};
+  auto first = makeMessage(1, 1);
+  auto second = makeMessage(2, 1);
+  EXPECT_CALL(*pre_executor, preExecute(first.message))
+      .WillOnce(testing::Return(PreExecutionResult{NonceStatus::FUTURE}))
+      .WillOnce(testing::Return(
+          PreExecutionResult{NonceStatus::VALID, 10, 0}))
+      .WillOnce(testing::Return(PreExecutionResult{NonceStatus::STALE}));
+  EXPECT_CALL(*pre_executor, preExecute(second.message))
+      .WillOnce(testing::Return(PreExecutionResult{NonceStatus::FUTURE}))
+      .WillOnce(testing::Return(
+          PreExecutionResult{NonceStatus::VALID, 20, 0}));
+  EXPECT_OUTCOME_TRUE_1(storage.put(first));
+  EXPECT_OUTCOME_TRUE_1(storage.put(second));
+
+  EXPECT_OUTCOME_TRUE_1(
+      storage.onHeadChange(HeadChange{HeadChangeType::CURRENT, Tipset{}}));
+  EXPECT_EQ(storage.getPreExecutionResult(first)->gas_used, 10);
+  EXPECT_FALSE(storage.getPreExecutionResult(second));
+
+  EXPECT_OUTCOME_TRUE_1(
+      storage.onHeadChange(HeadChange{HeadChangeType::CURRENT, Tipset{}}));
+  EXPECT_FALSE(storage.getPreExecutionResult(first));
+  EXPECT_EQ(storage.getPreExecutionResult(second)->gas_used, 20);
+  auto top = storage.getTopScored(2);
+  ASSERT_EQ(top.size(), 1);
+  EXPECT_EQ(top[0].message, second.message);
+}
+
+/**
+ * @given MessageStorage with budget for two messages and two messages of one
+ * sender
+ * @when better scored message of another sender is put
+ * @then highest nonce of worst sender is evicted, and message that would be
+ * evicted right away is rejected
+ */
+TEST_F(GasPricedScoredMessageStorageTest, EvictsOverBudget) {
+  auto first0 = makeMessage(0, 1);
+  auto first1 = makeMessage(1, 1);
+  auto first2 = makeMessage(2, 1);
+  unsigned_message.from = to;
+  auto second0 = makeMessage(0, 5);
+  EXPECT_OUTCOME_TRUE(message_size, size(first0));
+  GasPriceScoredMessageStorage storage{nullptr, nullptr, 2 * message_size};
+
+  EXPECT_OUTCOME_TRUE_1(storage.put(first0));
+  EXPECT_OUTCOME_TRUE_1(storage.put(first1));
+  EXPECT_OUTCOME_TRUE_1(storage.put(second0));
+  EXPECT_EQ(storage.bytes(), 2 * message_size);
+  auto top = storage.getTopScored(3);
+  ASSERT_EQ(top.size(), 2);
+  EXPECT_EQ(top[0].message, second0.message);
+  EXPECT_EQ(top[1].message, first0.message);
+
+  EXPECT_OUTCOME_ERROR(MessagePoolError::POOL_FULL, storage.put(first2));
+  EXPECT_EQ(storage.getTopScored(3).size(), 2);
+}
+
+/**
+ * @given MessageStorage with budget for two messages, holding messages of two
+ * senders
+ * @when message too big to fit after evicting worse scored sender is put
+ * @then it is rejected and no other message is evicted
+ */
+TEST_F(GasPricedScoredMessageStorageTest, RejectsWithoutEvicting) {
+  auto first0 = makeMessage(0, 1);
+  unsigned_message.from = to;
+  auto second0 = makeMessage(0, 5);
+  EXPECT_OUTCOME_TRUE(message_size, size(first0));
+  unsigned_message.params = MethodParams(message_size, 0);
+  auto second1 = makeMessage(1, 5);
+  GasPriceScoredMessageStorage storage{nullptr, nullptr, 2 * message_size};
+
+  EXPECT_OUTCOME_TRUE_1(storage.put(first0));
+  EXPECT_OUTCOME_TRUE_1(storage.put(second0));
+  EXPECT_OUTCOME_ERROR(MessagePoolError::POOL_FULL, storage.put(second1));
+  EXPECT_EQ(storage.bytes(), 2 * message_size);
+  auto top = storage.getTopScored(3);
+  ASSERT_EQ(top.size(), 2);
+  EXPECT_EQ(top[0].message, second0.message);
+  EXPECT_EQ(top[1].message, first0.message);
+}
+
+/**
+ * @given MessageStorage subscribed to head changes of chain store
+ * @when chain store reports applied tipset including pending message
+ * @then message is removed from pool
+ */
+TEST_F(GasPricedScoredMessageStorageTest, SubscribedToHeadChanges) {
+  using fc::storage::blockchain::ChainStore;
+  using fc::storage::blockchain::ChainStoreMock;
+  auto ipld = std::make_shared<InMemoryDatastore>();
+  auto storage = std::make_shared<GasPriceScoredMessageStorage>(nullptr, ipld);
+  ChainStoreMock chain_store;
+  ChainStore::HeadChangeHandler handler;
+  EXPECT_CALL(chain_store, subscribeHeadChanges(_))
+      .WillOnce(testing::SaveArg<0>(&handler));
+  fc::blockchain::message_pool::subscribeHeadChanges(chain_store, storage);
+
+  EXPECT_OUTCOME_TRUE_1(storage->put(message));
+  EXPECT_OUTCOME_TRUE(message_cid, ipld->setCbor(message.message));
+  Amt bls_messages{ipld};
+  EXPECT_OUTCOME_TRUE_1(bls_messages.setCbor(0, message_cid));
+  EXPECT_OUTCOME_TRUE(bls_root, bls_messages.flush());
+  EXPECT_OUTCOME_TRUE(secp_root, Amt{ipld}.flush());
+  MsgMeta meta{};
+  meta.bls_messages = bls_root;
+  meta.secpk_messages = secp_root;
+  EXPECT_OUTCOME_TRUE(meta_cid, ipld->setCbor(meta));
+  BlockHeader block;
+  block.miner = Address::makeFromId(0);
+  block.messages = meta_cid;
+  Tipset tipset{{}, {block}, {}};
+
+  handler(HeadChange{HeadChangeType::APPLY, tipset});
+  EXPECT_TRUE(storage->getTopScored(1).empty());
+}
+
+/**
+ * @given MessageStorage with three messages of one sender and tipset including
+ * second of them
+ * @when tipset is applied and then reverted
+ * @then apply removes included message and preceding nonce, revert puts
+ * included message again
+ */
+TEST_F(GasPricedScoredMessageStorageTest, HeadChangeApplyRevert) {
+  auto ipld = std::make_shared<InMemoryDatastore>();
+  GasPriceScoredMessageStorage storage{nullptr, ipld};
+  auto message0 = makeMessage(0, 1);
+  auto message1 = makeMessage(1, 1);
+  auto message2 = makeMessage(2, 1);
+  for (auto &message : {message0, message1, message2}) {
+    EXPECT_OUTCOME_TRUE_1(storage.put(message));
+  }
+
+  EXPECT_OUTCOME_TRUE(message_cid, ipld->setCbor(message1.message));
+  Amt bls_messages{ipld};
+  EXPECT_OUTCOME_TRUE_1(bls_messages.setCbor(0, message_cid));
+  EXPECT_OUTCOME_TRUE(bls_root, bls_messages.flush());
+  EXPECT_OUTCOME_TRUE(secp_root, Amt{ipld}.flush());
+  MsgMeta meta{};
+  meta.bls_messages = bls_root;
+  meta.secpk_messages = secp_root;
+  EXPECT_OUTCOME_TRUE(meta_cid, ipld->setCbor(meta));
+  Tipset tipset{{},
+                {BlockHeader{
+                    Address::makeFromId(0),
+                    {},
+                    {},
+                    {},
+                    {},
+                    {},
+                    meta_cid,
+                    meta_cid,
+                    meta_cid,
+                    {},
+                    {},
+                    {},
+                    {},
+                }},
+                {}};
+
+  EXPECT_OUTCOME_TRUE_1(
+      storage.onHeadChange(HeadChange{HeadChangeType::APPLY, tipset}));
+  auto top = storage.getTopScored(3);
+  ASSERT_EQ(top.size(), 1);
+  EXPECT_EQ(top[0].message, message2.message);
+
+  EXPECT_OUTCOME_TRUE_1(
+      storage.onHeadChange(HeadChange{HeadChangeType::REVERT, tipset}));
+  top = storage.getTopScored(3);
+  ASSERT_EQ(top.size(), 2);
+  EXPECT_EQ(top[0].message, message1.message);
+  EXPECT_EQ(top[1].message, message2.message);
 }
@@ -0,0 +1,138 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/message_pool/impl/message_pre_executor_impl.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/mocks/crypto/randomness/randomness_provider_mock.hpp"
+#include "testutil/mocks/storage/chain/chain_store_mock.hpp"
+#include "testutil/mocks/vm/indices/indices_mock.hpp"
+#include "testutil/mocks/vm/interpreter/interpreter_mock.hpp"
+#include "testutil/outcome.hpp"
+#include "vm/actor/actor.hpp"
+#include "vm/state/impl/state_tree_impl.hpp"
+
+using fc::CID;
+using fc::blockchain::message_pool::MessagePreExecutorImpl;
+using fc::blockchain::message_pool::NonceStatus;
+using fc::crypto::randomness::MockRandomnessProvider;
+using fc::primitives::BigInt;
+using fc::primitives::address::Address;
+using fc::primitives::block::BlockHeader;
+using fc::primitives::tipset::Tipset;
+using fc::storage::blockchain::ChainStoreMock;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::vm::actor::Actor;
+using fc::vm::actor::kAccountCodeCid;
+using fc::vm::actor::kSystemActorAddress;
+using fc::vm::indices::MockIndices;
+using fc::vm::interpreter::InterpreterMock;
+using fc::vm::interpreter::Result;
+using fc::vm::message::UnsignedMessage;
+using fc::vm::state::StateTreeImpl;
+using testing::_;
+using testing::Return;
+
+class MessagePreExecutorTest : public testing::Test {
+ public:
+  void SetUp() override {
+    parent_state_root = makeState(0);
+    head_state_root = makeState(1);
+    BlockHeader header{
+        Address::makeFromId(1),
+        {},
+        {},
+        {},
+        {},
+        5,
+        parent_state_root,
+        "010001020001"_cid,
+        "010001020001"_cid,
+        {},
+        {},
+        {},
+        {},
+    };
+    std::vector<BlockHeader> headers{header};
+    EXPECT_OUTCOME_TRUE(tipset, Tipset::create(headers));
+    head = tipset;
+    EXPECT_CALL(*chain_store, heaviestTipset()).WillRepeatedly(Return(head));
+  }
+
+  /// Makes state with sender of given nonce, receiver and system actor
+  CID makeState(uint64_t nonce) {
+    StateTreeImpl tree{store};
+    EXPECT_OUTCOME_TRUE_1(
+        tree.set(from, Actor{kAccountCodeCid, {}, nonce, BigInt{100}}));
+    EXPECT_OUTCOME_TRUE_1(tree.set(to, Actor{kAccountCodeCid, {}, 0, 0}));
+    EXPECT_OUTCOME_TRUE_1(
+        tree.set(kSystemActorAddress, Actor{kAccountCodeCid, {}, 0, 0}));
+    EXPECT_OUTCOME_TRUE(root, tree.flush());
+    return root;
+  }
+
+  UnsignedMessage makeMessage(uint64_t nonce) {
+    return UnsignedMessage{to, from, nonce, 10, 0, 1000, 0, {}};
+  }
+
+  std::shared_ptr<InMemoryDatastore> store{
+      std::make_shared<InMemoryDatastore>()};
+  std::shared_ptr<ChainStoreMock> chain_store{
+      std::make_shared<ChainStoreMock>()};
+  std::shared_ptr<InterpreterMock> interpreter{
+      std::make_shared<InterpreterMock>()};
+  Address from{Address::makeFromId(100)};
+  Address to{Address::makeFromId(101)};
+  CID parent_state_root;
+  CID head_state_root;
+  Tipset head;
+  MessagePreExecutorImpl pre_executor{
+      store,
+      chain_store,
+      interpreter,
+      std::make_shared<MockRandomnessProvider>(),
+      std::make_shared<MockIndices>()};
+};
+
+/**
+ * @given head whose execution increments sender nonce
+ * @when messages are pre-executed
+ * @then nonces are classified against state after head execution, head is
+ * executed once and node store is not modified
+ */
+TEST_F(MessagePreExecutorTest, UsesHeadResultingState) {
+  EXPECT_CALL(*interpreter, interpret(_, head, testing::NotNull()))
+      .WillOnce(Return(Result{head_state_root, "010001020001"_cid}));
+
+  EXPECT_OUTCOME_TRUE(stale, pre_executor.preExecute(makeMessage(0)));
+  EXPECT_EQ(stale.nonce_status, NonceStatus::STALE);
+  EXPECT_OUTCOME_TRUE(future, pre_executor.preExecute(makeMessage(2)));
+  EXPECT_EQ(future.nonce_status, NonceStatus::FUTURE);
+  EXPECT_OUTCOME_TRUE(valid, pre_executor.preExecute(makeMessage(1)));
+  EXPECT_EQ(valid.nonce_status, NonceStatus::VALID);
+  EXPECT_EQ(valid.exit_code, 0);
+  EXPECT_GT(valid.gas_used, 0);
+
+  StateTreeImpl tree{store, head_state_root};
+  EXPECT_OUTCOME_TRUE(sender, tree.get(from));
+  EXPECT_EQ(sender.nonce, 1);
+  EXPECT_EQ(sender.balance, 100);
+}
+
+/**
+ * @given head that can not be executed
+ * @when message is pre-executed
+ * @then error is returned
+ */
+TEST_F(MessagePreExecutorTest, HeadExecutionFails) {
+  EXPECT_CALL(*interpreter, interpret(_, head, _))
+      .WillOnce(Return(fc::outcome::failure(
+          fc::vm::interpreter::InterpreterError::DUPLICATE_MINER)));
+
+  EXPECT_OUTCOME_FALSE_1(pre_executor.preExecute(makeMessage(1)));
+}
@@ -0,0 +1,107 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/impl/header_syncer.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/ipfs/ipfs_datastore_error.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/mocks/blockchain/block_validator/block_validator_mock.hpp"
+#include "testutil/mocks/blockchain/header_fetcher_mock.hpp"
+#include "testutil/mocks/storage/chain/chain_store_mock.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::blockchain::HeaderFetcherMock;
+using fc::blockchain::block_validator::BlockValidatorMock;
+using fc::blockchain::sync_manager::HeaderSyncer;
+using fc::blockchain::sync_manager::HeaderSyncerError;
+using fc::primitives::address::Address;
+using fc::primitives::block::BlockHeader;
+using fc::primitives::tipset::Tipset;
+using fc::primitives::tipset::TipsetKey;
+using fc::storage::blockchain::ChainStoreMock;
+using fc::storage::ipfs::IpfsDatastoreError;
+using testing::_;
+using testing::Return;
+
+class HeaderSyncerTest : public testing::Test {
+ public:
+  void SetUp() override {
+    std::vector<fc::CID> parents;
+    for (uint64_t height = 0; height < 5; ++height) {
+      BlockHeader header{
+          Address::makeFromId(height),
+          {},
+          {},
+          parents,
+          {},
+          height,
+          "010001020001"_cid,
+          "010001020001"_cid,
+          "010001020001"_cid,
+          {},
+          {},
+          {},
+          {},
+      };
+      std::vector<BlockHeader> headers{header};
+      EXPECT_OUTCOME_TRUE(tipset, Tipset::create(headers));
+      parents = tipset.cids;
+      chain.push_back(std::move(tipset));
+    }
+    EXPECT_CALL(*chain_store, loadTipset(_))
+        .WillRepeatedly(
+            Return(fc::outcome::failure(IpfsDatastoreError::NOT_FOUND)));
+    EXPECT_CALL(*chain_store, loadTipset(key(1)))
+        .WillRepeatedly(Return(chain[1]));
+  }
+
+  TipsetKey key(size_t height) {
+    return chain[height].makeKey().value();
+  }
+
+  std::vector<Tipset> chain;
+  std::shared_ptr<HeaderFetcherMock> fetcher =
+      std::make_shared<HeaderFetcherMock>();
+  std::shared_ptr<ChainStoreMock> chain_store =
+      std::make_shared<ChainStoreMock>();
+  std::shared_ptr<BlockValidatorMock> validator =
+      std::make_shared<BlockValidatorMock>();
+  HeaderSyncer syncer{fetcher, chain_store, validator, 2, 2};
+};
+
+/**
+ * @given chain store knowing tipset at height 1 and sync target at height 4
+ * @when headers are synced
+ * @then missing tipsets are fetched in batches, validated and added oldest
+ * first
+ */
+TEST_F(HeaderSyncerTest, FetchesUpToKnownTipset) {
+  std::vector<Tipset> batch{chain[3], chain[2]};
+  std::vector<Tipset> added{chain[2], chain[3], chain[4]};
+  EXPECT_CALL(*fetcher, getTipsets(key(3), 2)).WillOnce(Return(batch));
+  EXPECT_CALL(*validator, validateBlock(_, _))
+      .Times(3)
+      .WillRepeatedly(Return(fc::outcome::success()));
+  EXPECT_CALL(*chain_store, addTipsets(added))
+      .WillOnce(Return(fc::outcome::success()));
+
+  EXPECT_OUTCOME_TRUE_1(syncer.syncHeaders(chain[4]));
+}
+
+/**
+ * @given sync target at height 4
+ * @when peer returns tipset which is not parent of target
+ * @then sync fails and nothing is added
+ */
+TEST_F(HeaderSyncerTest, RejectsUnlinkedHeaders) {
+  std::vector<Tipset> batch{chain[2]};
+  EXPECT_CALL(*fetcher, getTipsets(key(3), 2)).WillOnce(Return(batch));
+  EXPECT_CALL(*chain_store, addTipsets(_)).Times(0);
+
+  EXPECT_OUTCOME_ERROR(HeaderSyncerError::UNLINKED_HEADERS,
+                       syncer.syncHeaders(chain[4]));
+}
@@ -11,7 +11,8 @@ using namespace fc::blockchain;
 
 /** @brief we need this struct only to access the buckets */
 struct SyncBucketSetMock : public sync_manager::SyncBucketSet {
-  using SyncBucketSet::SyncBucketSet;
+  explicit SyncBucketSetMock(SyncBucketSet set)
+      : SyncBucketSet(std::move(set)) {}
 
   auto &getBuckets() {
     return buckets_;
@@ -33,9 +34,12 @@ struct SyncBucketSetTest : public SyncTargetBucketTest {
 
   void SetUp() override {
     SyncTargetBucketTest::SetUp();
-    empty_bucket = SyncBucketSetMock(std::vector<Tipset>({}));
-    bucket_set1 = SyncBucketSetMock(std::vector<Tipset>({tipset1}));
-    bucket_set2 = SyncBucketSetMock(std::vector<Tipset>({tipset1, tipset2}));
+    EXPECT_OUTCOME_TRUE(set0, SyncBucketSet::create({}));
+    EXPECT_OUTCOME_TRUE(set1, SyncBucketSet::create({tipset1}));
+    EXPECT_OUTCOME_TRUE(set2, SyncBucketSet::create({tipset1, tipset2}));
+    empty_bucket = SyncBucketSetMock(std::move(set0));
+    bucket_set1 = SyncBucketSetMock(std::move(set1));
+    bucket_set2 = SyncBucketSetMock(std::move(set2));
   }
 
   boost::optional<SyncBucketSetMock> empty_bucket;
@@ -45,14 +49,32 @@ struct SyncBucketSetTest : public SyncTargetBucketTest {
 
 /** check insert tipset */
 TEST_F(SyncBucketSetTest, InsertTipsetSuccess) {
-  bucket_set1->insert(tipset2);
+  auto child_block = bh1;
+  child_block.parents = tipset1.cids;
+  child_block.height = 5;
+  std::vector<BlockHeader> child_blocks{child_block};
+  EXPECT_OUTCOME_TRUE(child, Tipset::create(child_blocks));
+  EXPECT_OUTCOME_TRUE_1(bucket_set1->insert(child));
   auto &bs = bucket_set1->getBuckets();
   ASSERT_EQ(bs.size(), 1);
-  ASSERT_EQ(bs[0].tipsets.size(), 2);
+  ASSERT_EQ(bs[0].getSize(), 2);
+}
+
+/** unrelated tipset is inserted to new bucket */
+TEST_F(SyncBucketSetTest, InsertUnrelatedTipset) {
+  EXPECT_OUTCOME_TRUE_1(bucket_set1->insert(tipset2));
+  auto &bs = bucket_set1->getBuckets();
+  ASSERT_EQ(bs.size(), 2);
+  EXPECT_OUTCOME_TRUE(related, bucket_set1->isRelatedToAny(tipset2));
+  ASSERT_TRUE(related);
+  EXPECT_OUTCOME_TRUE(popped, bucket_set1->popRelated(tipset2));
+  ASSERT_NE(popped, boost::none);
+  ASSERT_EQ(*popped->getHeaviestTipset(), tipset2);
+  ASSERT_EQ(bs.size(), 1);
 }
 
 TEST_F(SyncBucketSetTest, AppendTipsetSuccess) {
-  SyncTargetBucket b{{tipset1, tipset2}};
+  EXPECT_OUTCOME_TRUE(b, SyncTargetBucket::create({tipset1, tipset2}));
   auto &bs = bucket_set1->getBuckets();
   ASSERT_EQ(bs.size(), 1);
   bucket_set1->append(b);
@@ -98,8 +98,10 @@ struct SyncTargetBucketTest : public ::testing::Test {
     EXPECT_OUTCOME_TRUE(ts2, Tipset::create({bh1, bh2}));
     tipset1 = std::move(ts1);
     tipset2 = std::move(ts2);
-    bucket1 = {{tipset1}};
-    bucket2 = {{tipset1, tipset2}};
+    EXPECT_OUTCOME_TRUE(b1, SyncTargetBucket::create({tipset1}));
+    EXPECT_OUTCOME_TRUE(b2, SyncTargetBucket::create({tipset1, tipset2}));
+    bucket1 = std::move(b1);
+    bucket2 = std::move(b2);
   }
 
   BlockHeader bh1;
@@ -8,7 +8,14 @@
 #include <gtest/gtest.h>
 #include "blockchain/block_validator/impl/block_validator_impl.hpp"
 #include "clock/impl/chain_epoch_clock_impl.hpp"
+#include "codec/cbor/cbor.hpp"
+#include "crypto/bls/impl/bls_provider_impl.hpp"
+#include "crypto/secp256k1/impl/caching_secp256k1_provider.hpp"
 #include "power/impl/power_table_impl.hpp"
+#include "storage/amt/amt.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "vm/message/message.hpp"
+#include "vm/state/impl/state_tree_impl.hpp"
 #include "testutil/literals.hpp"
 #include "testutil/mocks/blockchain/weight_calculator_mock.hpp"
 #include "testutil/mocks/clock/utc_clock_mock.hpp"
@@ -35,7 +42,11 @@ class BlockValidatorTest : public testing::Test {
   using WeightCalculator = fc::blockchain::weight::WeightCalculatorMock;
   using PowerTable = fc::power::PowerTableImpl;
   using BlsProvider = fc::crypto::bls::BlsProviderMock;
+  using BlsProviderImpl = fc::crypto::bls::BlsProviderImpl;
   using Secp256k1Provider = fc::crypto::secp256k1::Secp256k1ProviderMock;
+  using Secp256k1ProviderImpl = fc::crypto::secp256k1::Secp256k1ProviderImpl;
+  using CachingSecp256k1Provider =
+      fc::crypto::secp256k1::CachingSecp256k1Provider;
   using Indices = fc::vm::indices::MockIndices;
   using Interpreter = fc::vm::interpreter::InterpreterMock;
   using BlockHeader = fc::primitives::block::BlockHeader;
@@ -43,13 +54,20 @@ class BlockValidatorTest : public testing::Test {
   using Ticket = fc::primitives::ticket::Ticket;
   using Signature = fc::crypto::signature::Signature;
   using Secp256k1Signature = fc::crypto::signature::Secp256k1Signature;
+  using ThreadPool = boost::asio::thread_pool;
 
   BlockValidatorTest() : validator_{createValidator()} {}
 
+  std::shared_ptr<ThreadPool> pool_{std::make_shared<ThreadPool>(2)};
   std::shared_ptr<BlockValidator> validator_;
 
-  std::shared_ptr<BlockValidator> createValidator() {
-    auto datastore = std::make_shared<DataStore>();
+  std::shared_ptr<BlockValidator> createValidator(
+      std::shared_ptr<fc::crypto::bls::BlsProvider> bls_provider =
+          std::make_shared<BlsProvider>(),
+      std::shared_ptr<fc::storage::ipfs::IpfsDatastore> datastore =
+          std::make_shared<DataStore>(),
+      std::shared_ptr<fc::crypto::secp256k1::Secp256k1Provider> secp_provider =
+          std::make_shared<Secp256k1Provider>()) {
     auto utc_clock = std::make_shared<UTCClockMock>();
     std::chrono::duration<uint64_t> genesis_time{config::kGenesisTime};
     auto epoch_clock = std::make_shared<EpochClock>(Time{genesis_time});
@@ -58,8 +76,6 @@ class BlockValidatorTest : public testing::Test {
     auto result = power_table->setMinerPower(
         Address::makeFromId(config::kMinerId), config::kMinerPower);
     BOOST_ASSERT(!result.has_error());
-    auto bls_provider = std::make_shared<BlsProvider>();
-    auto secp_provider = std::make_shared<Secp256k1Provider>();
     auto vm_interpreter = std::make_shared<Interpreter>();
     auto vm_indices = std::make_shared<Indices>();
     return std::make_shared<BlockValidator>(datastore,
@@ -68,9 +84,12 @@ class BlockValidatorTest : public testing::Test {
                                             weight_calculator,
                                             power_table,
                                             bls_provider,
-                                            secp_provider,
+                                            std::make_shared<
+                                                CachingSecp256k1Provider>(
+                                                secp_provider),
                                             vm_interpreter,
-                                            vm_indices);
+                                            vm_indices,
+                                            pool_);
   }
 
   BlockHeader getCorrectBlockHeader() const {
@@ -100,3 +119,179 @@ TEST_F(BlockValidatorTest, ValidateCorrectBlock) {
       getCorrectBlockHeader(),
       {fc::blockchain::block_validator::scenarios::Stage::SYNTAX_BV0}));
 }
+
+/**
+ * @given Tipset of correct block and block without parents
+ * @when Validating tipset syntax
+ * @then Correct blocks pass, tipset with invalid block fails
+ */
+TEST_F(BlockValidatorTest, ValidateTipset) {
+  using fc::blockchain::block_validator::scenarios::Stage;
+  auto block = getCorrectBlockHeader();
+  auto invalid_block = block;
+  invalid_block.parents.clear();
+
+  std::vector<BlockHeader> tipset{block, block};
+  std::vector<BlockHeader> invalid_tipset{block, invalid_block};
+
+  EXPECT_OUTCOME_TRUE_1(
+      validator_->validateTipset(tipset, {Stage::SYNTAX_BV0}));
+  EXPECT_OUTCOME_FALSE_1(
+      validator_->validateTipset(invalid_tipset, {Stage::SYNTAX_BV0}));
+}
+
+/**
+ * @given Block signed by BLS key of its miner over header without signature
+ * @when Validating block signature
+ * @then Signed block passes, modified or unsigned block fails
+ */
+TEST_F(BlockValidatorTest, BlockSignature) {
+  using fc::blockchain::block_validator::ValidatorError;
+  using fc::blockchain::block_validator::scenarios::Stage;
+  auto bls_provider = std::make_shared<BlsProviderImpl>();
+  auto validator = createValidator(bls_provider);
+  EXPECT_OUTCOME_TRUE(key_pair, bls_provider->generateKeyPair());
+  auto block = getCorrectBlockHeader();
+  block.miner = Address::makeBls(key_pair.public_key);
+  block.block_sig = boost::none;
+  EXPECT_OUTCOME_TRUE(unsigned_bytes, fc::codec::cbor::encode(block));
+  EXPECT_OUTCOME_TRUE(signature,
+                      bls_provider->sign(unsigned_bytes, key_pair.private_key));
+  block.block_sig = Signature{signature};
+
+  EXPECT_OUTCOME_TRUE_1(
+      validator->validateBlock(block, {Stage::BLOCK_SIGNATURE_BV2}));
+
+  auto modified_block = block;
+  ++modified_block.timestamp;
+  EXPECT_OUTCOME_ERROR(
+      ValidatorError::INVALID_BLOCK_SIGNATURE,
+      validator->validateBlock(modified_block, {Stage::BLOCK_SIGNATURE_BV2}));
+
+  auto unsigned_block = block;
+  unsigned_block.block_sig = boost::none;
+  EXPECT_OUTCOME_ERROR(
+      ValidatorError::UNKNOWN_BLOCK_SIGNATURE,
+      validator->validateBlock(unsigned_block, {Stage::BLOCK_SIGNATURE_BV2}));
+}
+
+/**
+ * @given Block with BLS messages from two senders and their aggregate, and
+ * secp256k1 signed message
+ * @when Validating message signatures
+ * @then Valid signatures pass, wrong aggregate, non-BLS sender and wrong
+ * secp256k1 signature fail
+ */
+TEST_F(BlockValidatorTest, MessageSignature) {
+  using fc::CID;
+  using fc::blockchain::block_validator::ValidatorError;
+  using fc::blockchain::block_validator::scenarios::Stage;
+  using fc::primitives::block::MsgMeta;
+  using fc::storage::amt::Amt;
+  using fc::vm::message::SignedMessage;
+  using fc::vm::message::UnsignedMessage;
+  auto bls_provider = std::make_shared<BlsProviderImpl>();
+  auto secp_provider = std::make_shared<Secp256k1ProviderImpl>();
+  auto store = std::make_shared<fc::storage::ipfs::InMemoryDatastore>();
+  auto validator = createValidator(bls_provider, store, secp_provider);
+  EXPECT_OUTCOME_TRUE(key1, bls_provider->generateKeyPair());
+  EXPECT_OUTCOME_TRUE(key2, bls_provider->generateKeyPair());
+  EXPECT_OUTCOME_TRUE(empty_state,
+                      fc::vm::state::StateTreeImpl{store}.flush());
+
+  // stores block messages, returns header referencing them
+  auto make_block = [&](const std::vector<UnsignedMessage> &messages,
+                        const std::vector<SignedMessage> &secp_messages = {}) {
+    Amt amt{store};
+    for (size_t i = 0; i < messages.size(); ++i) {
+      EXPECT_OUTCOME_TRUE(cid, store->setCbor(messages[i]));
+      EXPECT_OUTCOME_TRUE_1(amt.setCbor(i, cid));
+    }
+    Amt secp_amt{store};
+    for (size_t i = 0; i < secp_messages.size(); ++i) {
+      EXPECT_OUTCOME_TRUE(cid, store->setCbor(secp_messages[i]));
+      EXPECT_OUTCOME_TRUE_1(secp_amt.setCbor(i, cid));
+    }
+    MsgMeta meta{};
+    EXPECT_OUTCOME_TRUE(bls_messages, amt.flush());
+    meta.bls_messages = bls_messages;
+    EXPECT_OUTCOME_TRUE(secpk_messages, secp_amt.flush());
+    meta.secpk_messages = secpk_messages;
+    EXPECT_OUTCOME_TRUE(meta_cid, store->setCbor(meta));
+    auto block = getCorrectBlockHeader();
+    block.parent_state_root = empty_state;
+    block.messages = meta_cid;
+    return block;
+  };
+  auto sign = [&](const UnsignedMessage &message,
+                  const fc::crypto::bls::PrivateKey &key) {
+    EXPECT_OUTCOME_TRUE(cid, store->setCbor(message));
+    EXPECT_OUTCOME_TRUE(bytes, cid.toBytes());
+    EXPECT_OUTCOME_TRUE(signature, bls_provider->sign(bytes, key));
+    return signature;
+  };
+
+  auto make_message = [](const Address &from, uint64_t value) {
+    return UnsignedMessage{
+        Address::makeFromId(1), from, 0, value, 1, 1, 0, {}};
+  };
+
+  auto message1 = make_message(Address::makeBls(key1.public_key), 1);
+  auto message2 = make_message(Address::makeBls(key2.public_key), 2);
+  auto block = make_block({message1, message2});
+  auto signature1 = sign(message1, key1.private_key);
+  auto signature2 = sign(message2, key2.private_key);
+  EXPECT_OUTCOME_TRUE(
+      aggregate, bls_provider->aggregateSignatures({signature1, signature2}));
+  block.bls_aggregate = aggregate;
+  EXPECT_OUTCOME_TRUE_1(
+      validator->validateBlock(block, {Stage::MESSAGE_SIGNATURE_BV4}));
+
+  // aggregate of first message only
+  block.bls_aggregate = signature1;
+  EXPECT_OUTCOME_ERROR(
+      ValidatorError::INVALID_MESSAGE_SIGNATURE,
+      validator->validateBlock(block, {Stage::MESSAGE_SIGNATURE_BV4}));
+
+  auto secp_message = make_message(
+      Address::makeSecp256k1(fc::primitives::address::Sec256k1PublicKey{}),
+      3);
+  auto secp_block = make_block({message1, secp_message});
+  secp_block.bls_aggregate = aggregate;
+  EXPECT_OUTCOME_ERROR(
+      ValidatorError::INVALID_MESSAGE_SIGNATURE,
+      validator->validateBlock(secp_block, {Stage::MESSAGE_SIGNATURE_BV4}));
+
+  EXPECT_OUTCOME_TRUE(secp_key, secp_provider->generate());
+  EXPECT_OUTCOME_TRUE(other_key, secp_provider->generate());
+  auto secp_sign = [&](const UnsignedMessage &message,
+                       const fc::crypto::secp256k1::PrivateKey &key) {
+    EXPECT_OUTCOME_TRUE(cid, store->setCbor(message));
+    EXPECT_OUTCOME_TRUE(bytes, cid.toBytes());
+    EXPECT_OUTCOME_TRUE(signature, secp_provider->sign(bytes, key));
+    return SignedMessage{message, Signature{signature}};
+  };
+  auto message3 = make_message(Address::makeSecp256k1(secp_key.public_key), 3);
+  block = make_block({message1, message2},
+                     {secp_sign(message3, secp_key.private_key)});
+  block.bls_aggregate = aggregate;
+  EXPECT_OUTCOME_TRUE_1(
+      validator->validateBlock(block, {Stage::MESSAGE_SIGNATURE_BV4}));
+
+  // signed by key other than sender's
+  block = make_block({message1, message2},
+                     {secp_sign(message3, other_key.private_key)});
+  block.bls_aggregate = aggregate;
+  EXPECT_OUTCOME_ERROR(
+      ValidatorError::INVALID_MESSAGE_SIGNATURE,
+      validator->validateBlock(block, {Stage::MESSAGE_SIGNATURE_BV4}));
+
+  // signature of other message
+  auto forged = secp_sign(message3, secp_key.private_key);
+  forged.message.value = 4;
+  block = make_block({message1, message2}, {forged});
+  block.bls_aggregate = aggregate;
+  EXPECT_OUTCOME_ERROR(
+      ValidatorError::INVALID_MESSAGE_SIGNATURE,
+      validator->validateBlock(block, {Stage::MESSAGE_SIGNATURE_BV4}));
+}
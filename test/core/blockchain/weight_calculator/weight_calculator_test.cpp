@@ -35,8 +35,8 @@ struct Params {
   Weight expected_weight;
 };
 
-fc::outcome::result<Weight> calculateWeight(const Params &params) {
-  auto ipld = std::make_shared<InMemoryDatastore>();
+Tipset makeTipset(const std::shared_ptr<InMemoryDatastore> &ipld,
+                  const Params &params) {
   auto some_cid = "010001020001"_cid;
   EXPECT_OUTCOME_TRUE(state_cid,
                       ipld->setCbor(StoragePowerActorState{
@@ -75,8 +75,12 @@ fc::outcome::result<Weight> calculateWeight(const Params &params) {
                      {},
                  }},
                 {}};
+  return tipset;
+}
 
-  return WeightCalculatorImpl{ipld}.calculateWeight(tipset);
+fc::outcome::result<Weight> calculateWeight(const Params &params) {
+  auto ipld = std::make_shared<InMemoryDatastore>();
+  return WeightCalculatorImpl{ipld}.calculateWeight(makeTipset(ipld, params));
 }
 
 struct WeightCalculatorTest : ::testing::TestWithParam<Params> {};
@@ -91,6 +95,27 @@ TEST_P(WeightCalculatorTest, Success) {
   EXPECT_OUTCOME_EQ(calculateWeight(params), params.expected_weight);
 }
 
+/**
+ * @given weight of tipset calculated
+ * @when state is removed from store and weight of same tipset and of another
+ * tipset with same parent state is calculated
+ * @then weight and network power are taken from cache
+ */
+TEST_F(WeightCalculatorTest, Memoized) {
+  auto ipld = std::make_shared<InMemoryDatastore>();
+  auto tipset = makeTipset(ipld, {100, 200, 1, 2071});
+  tipset.cids = {"010001020002"_cid};
+  auto sibling = tipset;
+  sibling.cids = {"010001020003"_cid};
+  sibling.blks.push_back(tipset.blks[0]);
+  WeightCalculatorImpl calculator{ipld};
+
+  EXPECT_OUTCOME_EQ(calculator.calculateWeight(tipset), 2071);
+  EXPECT_OUTCOME_TRUE_1(ipld->remove(tipset.getParentStateRoot()));
+  EXPECT_OUTCOME_EQ(calculator.calculateWeight(tipset), 2071);
+  EXPECT_OUTCOME_EQ(calculator.calculateWeight(sibling), 2250);
+}
+
 INSTANTIATE_TEST_CASE_P(WeightCalculatorTestCases,
                         WeightCalculatorTest,
                         ::testing::Values(Params{100, 200, 1, 2071},
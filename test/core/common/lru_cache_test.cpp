@@ -0,0 +1,48 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/lru_cache.hpp"
+
+#include <gtest/gtest.h>
+
+using fc::common::LruCache;
+using fc::common::ShardedLruCache;
+
+/**
+ * @given cache of capacity 2 with two values
+ * @when first value is read and third value is put
+ * @then second, least recently used, value is evicted
+ */
+TEST(LruCacheTest, EvictsLeastRecentlyUsed) {
+  LruCache<int, int> cache{2};
+  cache.put(1, 10);
+  cache.put(2, 20);
+  EXPECT_EQ(cache.get(1), 10);
+  cache.put(3, 30);
+
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_EQ(cache.get(1), 10);
+  EXPECT_EQ(cache.get(2), boost::none);
+  EXPECT_EQ(cache.get(3), 30);
+}
+
+/**
+ * @given sharded cache
+ * @when values are put, replaced and removed
+ * @then cache returns latest values and total size is bounded by capacity
+ */
+TEST(LruCacheTest, Sharded) {
+  ShardedLruCache<int, int> cache{8, 4};
+  for (auto i = 0; i < 100; ++i) {
+    cache.put(i, i);
+  }
+  EXPECT_LE(cache.size(), 8u);
+
+  cache.put(100, 1);
+  cache.put(100, 2);
+  EXPECT_EQ(cache.get(100), 2);
+  cache.remove(100);
+  EXPECT_EQ(cache.get(100), boost::none);
+}
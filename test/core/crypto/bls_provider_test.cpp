@@ -82,3 +82,32 @@ TEST_F(BlsProviderTest, DifferentMessageVerificationFailure) {
                           different_message, signature, key_pair.public_key));
   ASSERT_FALSE(signature_status);
 }
+
+/**
+ * @given Two messages signed by different keys
+ * @when Verifying aggregated signature
+ * @then Aggregate is valid for signed messages and invalid for swapped keys
+ */
+TEST_F(BlsProviderTest, VerifyAggregateSignature) {
+  std::vector<uint8_t> second_message{message_};
+  std::reverse(second_message.begin(), second_message.end());
+  EXPECT_OUTCOME_TRUE(key_pair, provider_.generateKeyPair());
+  EXPECT_OUTCOME_TRUE(key_pair_second, provider_.generateKeyPair());
+  EXPECT_OUTCOME_TRUE(signature,
+                      provider_.sign(message_, key_pair.private_key));
+  EXPECT_OUTCOME_TRUE(
+      signature_second,
+      provider_.sign(second_message, key_pair_second.private_key));
+  std::vector<Signature> signatures{signature, signature_second};
+  EXPECT_OUTCOME_TRUE(aggregate, provider_.aggregateSignatures(signatures));
+
+  std::vector<gsl::span<const uint8_t>> messages{message_, second_message};
+  std::vector<PublicKey> keys{key_pair.public_key, key_pair_second.public_key};
+  std::vector<PublicKey> swapped_keys{key_pair_second.public_key,
+                                      key_pair.public_key};
+  EXPECT_OUTCOME_EQ(
+      provider_.verifyAggregateSignature(messages, keys, aggregate), true);
+  EXPECT_OUTCOME_EQ(
+      provider_.verifyAggregateSignature(messages, swapped_keys, aggregate),
+      false);
+}
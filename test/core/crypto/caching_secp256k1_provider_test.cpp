@@ -0,0 +1,88 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "crypto/secp256k1/impl/caching_secp256k1_provider.hpp"
+
+#include <gtest/gtest.h>
+#include "testutil/mocks/crypto/secp256k1/secp256k1_provider_mock.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::crypto::secp256k1::CachingSecp256k1Provider;
+using fc::crypto::secp256k1::PublicKey;
+using fc::crypto::secp256k1::Secp256k1ProviderMock;
+using fc::crypto::secp256k1::Signature;
+using testing::_;
+using testing::Return;
+
+class CachingSecp256k1ProviderTest : public ::testing::Test {
+ protected:
+  std::shared_ptr<Secp256k1ProviderMock> mock_ =
+      std::make_shared<Secp256k1ProviderMock>();
+  std::shared_ptr<boost::asio::thread_pool> pool_ =
+      std::make_shared<boost::asio::thread_pool>(2);
+  CachingSecp256k1Provider provider_{mock_, 16, pool_};
+  std::vector<uint8_t> message_{4, 8, 15, 16, 23, 42};
+  Signature signature_{1, 2, 3};
+  Signature invalid_signature_{3, 2, 1};
+  PublicKey public_key_{};
+};
+
+/**
+ * @given valid and invalid signatures
+ * @when verifying each of them twice
+ * @then valid signature is verified by underlying provider once, invalid one
+ * every time
+ */
+TEST_F(CachingSecp256k1ProviderTest, CachesValidSignatures) {
+  EXPECT_CALL(*mock_, verify(_, signature_, public_key_))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*mock_, verify(_, invalid_signature_, public_key_))
+      .Times(2)
+      .WillRepeatedly(Return(false));
+
+  for (auto i = 0; i < 2; ++i) {
+    EXPECT_OUTCOME_EQ(provider_.verify(message_, signature_, public_key_),
+                      true);
+    EXPECT_OUTCOME_EQ(
+        provider_.verify(message_, invalid_signature_, public_key_), false);
+  }
+}
+
+/**
+ * @given batch of valid and invalid signatures
+ * @when verifying batch
+ * @then status of each signature is returned in order
+ */
+TEST_F(CachingSecp256k1ProviderTest, VerifyBatch) {
+  EXPECT_CALL(*mock_, verify(_, signature_, public_key_))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*mock_, verify(_, invalid_signature_, public_key_))
+      .WillOnce(Return(false));
+
+  std::vector<CachingSecp256k1Provider::VerifyRequest> requests{
+      {message_, invalid_signature_, public_key_},
+      {message_, signature_, public_key_}};
+  std::vector<bool> expected{false, true};
+  EXPECT_OUTCOME_EQ(provider_.verifyBatch(requests), expected);
+}
+
+/**
+ * @given provider without worker pool
+ * @when verifying batch
+ * @then signatures are verified on calling thread in order
+ */
+TEST_F(CachingSecp256k1ProviderTest, VerifyBatchWithoutPool) {
+  CachingSecp256k1Provider provider{mock_, 16};
+  EXPECT_CALL(*mock_, verify(_, signature_, public_key_))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*mock_, verify(_, invalid_signature_, public_key_))
+      .WillOnce(Return(false));
+
+  std::vector<CachingSecp256k1Provider::VerifyRequest> requests{
+      {message_, signature_, public_key_},
+      {message_, invalid_signature_, public_key_}};
+  std::vector<bool> expected{true, false};
+  EXPECT_OUTCOME_EQ(provider.verifyBatch(requests), expected);
+}
@@ -152,6 +152,27 @@ TEST_F(TipsetTest, CreateSuccess) {
   ASSERT_FALSE(ts.contains(cid3));
 }
 
+/**
+ * @given tipset created from headers
+ * @when its cids are replaced
+ * @then keys made before and after match current cids and parents
+ */
+TEST_F(TipsetTest, MakeKeyFollowsCids) {
+  std::vector<BlockHeader> headers{bh1};
+  EXPECT_OUTCOME_TRUE(ts, Tipset::create(headers));
+  EXPECT_OUTCOME_TRUE(key, ts.makeKey());
+  ASSERT_EQ(key.cids, ts.cids);
+  EXPECT_OUTCOME_TRUE(parents, ts.getParents());
+  ASSERT_EQ(parents.cids, bh1.parents);
+
+  ts.cids = {cid3};
+  EXPECT_OUTCOME_TRUE(new_key, ts.makeKey());
+  EXPECT_OUTCOME_TRUE(expected_key,
+                      fc::primitives::tipset::TipsetKey::create(ts.cids));
+  ASSERT_EQ(new_key, expected_key);
+  ASSERT_EQ(new_key.hash, expected_key.hash);
+}
+
 /**
  * @given tipset and its serialized representation from go
  * @when encode @and decode the tipset
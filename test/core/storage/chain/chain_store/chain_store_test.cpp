@@ -24,6 +24,8 @@ using fc::crypto::signature::Signature;
 using fc::primitives::BigInt;
 using fc::primitives::block::BlockHeader;
 using fc::primitives::ticket::Ticket;
+using fc::primitives::tipset::Tipset;
+using fc::primitives::tipset::TipsetKey;
 using fc::storage::blockchain::ChainDataStoreImpl;
 using fc::storage::blockchain::ChainStoreImpl;
 using fc::storage::ipfs::InMemoryDatastore;
@@ -69,7 +71,7 @@ struct ChainStoreTest : public ::testing::Test {
     auto data_store = std::make_shared<ChainDataStoreImpl>(
         std::make_shared<InMemoryDatastore>());
     auto block_validator = std::make_shared<BlockValidatorMock>();
-    auto weight_calculator = std::make_shared<WeightCalculatorMock>();
+    weight_calculator = std::make_shared<WeightCalculatorMock>();
 
     EXPECT_CALL(*weight_calculator, calculateWeight(testing::_))
         .WillRepeatedly(testing::Return(1));
@@ -78,12 +80,13 @@ struct ChainStoreTest : public ::testing::Test {
                         ChainStoreImpl::create(std::move(block_service),
                                                std::move(data_store),
                                                std::move(block_validator),
-                                               std::move(weight_calculator)));
+                                               weight_calculator));
     chain_store = std::move(store);
 
     block = makeBlock();
   }
 
+  std::shared_ptr<WeightCalculatorMock> weight_calculator;
   std::shared_ptr<ChainStoreImpl> chain_store;
   BlockHeader block;
 };
@@ -103,3 +106,208 @@ TEST_F(ChainStoreTest, AddBlockSuccess) {
   EXPECT_OUTCOME_TRUE(stored_block, chain_store->getBlock(block_cid));
   ASSERT_EQ(block, stored_block);
 }
+
+/**
+ * @given chain of tipsets at heights 0, 1 and 3 added to store
+ * @when look back from head to heights of tipsets and of null round
+ * @then tipset at or before requested height is returned
+ */
+TEST_F(ChainStoreTest, LoadTipsetByHeight) {
+  EXPECT_CALL(*weight_calculator, calculateWeight(_))
+      .WillRepeatedly(testing::Invoke(
+          [](const Tipset &tipset) { return BigInt(tipset.height); }));
+
+  std::vector<CID> parents;
+  std::vector<Tipset> chain;
+  for (auto height : {0, 1, 3}) {
+    block.height = height;
+    block.parents = parents;
+    EXPECT_OUTCOME_TRUE_1(chain_store->addBlock(block));
+    EXPECT_OUTCOME_TRUE(block_cid, getCidOfCbor(block));
+    parents = {block_cid};
+    EXPECT_OUTCOME_TRUE(key, TipsetKey::create(parents));
+    EXPECT_OUTCOME_TRUE(tipset, chain_store->loadTipset(key));
+    chain.push_back(tipset);
+  }
+  EXPECT_OUTCOME_EQ(chain_store->heaviestTipset(), chain[2]);
+
+  EXPECT_OUTCOME_EQ(chain_store->loadTipsetByHeight(chain[2], 3), chain[2]);
+  EXPECT_OUTCOME_EQ(chain_store->loadTipsetByHeight(chain[2], 2), chain[1]);
+  EXPECT_OUTCOME_EQ(chain_store->loadTipsetByHeight(chain[2], 1), chain[1]);
+  EXPECT_OUTCOME_EQ(chain_store->loadTipsetByHeight(chain[2], 0), chain[0]);
+}
+
+/**
+ * @given chain of tipsets at heights 0, 1, 3 and lighter fork at height 2
+ * @when look back from fork
+ * @then ancestors of fork are found by ancestor links
+ */
+TEST_F(ChainStoreTest, LoadTipsetByHeightFromFork) {
+  EXPECT_CALL(*weight_calculator, calculateWeight(_))
+      .WillRepeatedly(testing::Invoke(
+          [](const Tipset &tipset) { return BigInt(tipset.height); }));
+
+  std::vector<CID> parents;
+  std::vector<Tipset> chain;
+  for (auto height : {0, 1, 3}) {
+    block.height = height;
+    block.parents = parents;
+    EXPECT_OUTCOME_TRUE_1(chain_store->addBlock(block));
+    EXPECT_OUTCOME_TRUE(block_cid, getCidOfCbor(block));
+    EXPECT_OUTCOME_TRUE(tipset, Tipset::create({block}));
+    chain.push_back(tipset);
+    parents = {block_cid};
+  }
+  block.height = 2;
+  block.miner = fc::primitives::address::Address::makeFromId(2);
+  block.parents = chain[1].cids;
+  EXPECT_OUTCOME_TRUE_1(chain_store->addBlock(block));
+  EXPECT_OUTCOME_TRUE(fork, Tipset::create({block}));
+  EXPECT_OUTCOME_EQ(chain_store->heaviestTipset(), chain[2]);
+
+  EXPECT_OUTCOME_EQ(chain_store->loadTipsetByHeight(fork, 2), fork);
+  EXPECT_OUTCOME_EQ(chain_store->loadTipsetByHeight(fork, 1), chain[1]);
+  EXPECT_OUTCOME_EQ(chain_store->loadTipsetByHeight(fork, 0), chain[0]);
+}
+
+/**
+ * @given chain of tipsets at heights 0 to 3 and heavier fork of tipset at
+ * height 1 whose ancestor is not stored yet
+ * @when look back from fork before and after its ancestor is stored, then
+ * after fork is extended
+ * @then height index entries of abandoned chain are not returned
+ */
+TEST_F(ChainStoreTest, LoadTipsetByHeightAfterReorgToUnsyncedFork) {
+  EXPECT_CALL(*weight_calculator, calculateWeight(_))
+      .WillRepeatedly(testing::Invoke(
+          [](const Tipset &tipset) { return BigInt(tipset.height); }));
+
+  std::vector<Tipset> chain;
+  for (auto height : {0, 1, 2, 3}) {
+    block.height = height;
+    block.parents = chain.empty() ? std::vector<CID>{} : chain.back().cids;
+    EXPECT_OUTCOME_TRUE_1(chain_store->addBlock(block));
+    EXPECT_OUTCOME_TRUE(tipset, Tipset::create({block}));
+    chain.push_back(tipset);
+  }
+
+  block.miner = fc::primitives::address::Address::makeFromId(2);
+  block.height = 9;
+  block.parents = chain[1].cids;
+  auto missing = block;
+  EXPECT_OUTCOME_TRUE(missing_tipset, Tipset::create({missing}));
+  block.height = 10;
+  block.parents = missing_tipset.cids;
+  EXPECT_OUTCOME_TRUE_1(chain_store->addBlock(block));
+  EXPECT_OUTCOME_TRUE(fork, Tipset::create({block}));
+  EXPECT_OUTCOME_EQ(chain_store->heaviestTipset(), fork);
+
+  // ancestors of fork are unknown
+  EXPECT_OUTCOME_FALSE_1(chain_store->loadTipsetByHeight(fork, 3));
+
+  EXPECT_OUTCOME_TRUE_1(chain_store->addBlock(missing));
+  EXPECT_OUTCOME_EQ(chain_store->loadTipsetByHeight(fork, 3), chain[1]);
+
+  block.height = 11;
+  block.parents = fork.cids;
+  EXPECT_OUTCOME_TRUE_1(chain_store->addBlock(block));
+  EXPECT_OUTCOME_TRUE(head, Tipset::create({block}));
+  EXPECT_OUTCOME_EQ(chain_store->heaviestTipset(), head);
+  EXPECT_OUTCOME_EQ(chain_store->loadTipsetByHeight(head, 9), missing_tipset);
+  EXPECT_OUTCOME_EQ(chain_store->loadTipsetByHeight(head, 3), chain[1]);
+  EXPECT_OUTCOME_EQ(chain_store->loadTipsetByHeight(head, 0), chain[0]);
+}
+
+/**
+ * @given blocks of two miners with same parents
+ * @when blocks are added one by one
+ * @then second block is expanded to tipset with first one
+ */
+TEST_F(ChainStoreTest, AddBlockExpandsTipset) {
+  EXPECT_CALL(*weight_calculator, calculateWeight(_))
+      .WillRepeatedly(testing::Invoke(
+          [](const Tipset &tipset) { return BigInt(tipset.blks.size()); }));
+
+  auto sibling = block;
+  sibling.miner = fc::primitives::address::Address::makeFromId(2);
+  EXPECT_OUTCOME_TRUE_1(chain_store->addBlock(block));
+  EXPECT_OUTCOME_TRUE_1(chain_store->addBlock(sibling));
+  std::vector<BlockHeader> blocks{block, sibling};
+  EXPECT_OUTCOME_TRUE(tipset, Tipset::create(blocks));
+  EXPECT_OUTCOME_EQ(chain_store->heaviestTipset(), tipset);
+}
+
+/**
+ * @given chain of tipsets at heights 0, 1 and 2
+ * @when chain is added at once
+ * @then its head becomes heaviest and its tipsets can be looked up
+ */
+TEST_F(ChainStoreTest, AddTipsets) {
+  EXPECT_CALL(*weight_calculator, calculateWeight(_))
+      .WillRepeatedly(testing::Invoke(
+          [](const Tipset &tipset) { return BigInt(tipset.height); }));
+
+  std::vector<CID> parents;
+  std::vector<Tipset> chain;
+  for (auto height : {0, 1, 2}) {
+    block.height = height;
+    block.parents = parents;
+    EXPECT_OUTCOME_TRUE(tipset, Tipset::create({block}));
+    parents = tipset.cids;
+    chain.push_back(tipset);
+  }
+  EXPECT_OUTCOME_TRUE_1(chain_store->addTipsets(chain));
+
+  EXPECT_OUTCOME_EQ(chain_store->heaviestTipset(), chain[2]);
+  EXPECT_OUTCOME_EQ(chain_store->getBlock(chain[1].cids[0]), chain[1].blks[0]);
+  EXPECT_OUTCOME_EQ(chain_store->loadTipsetByHeight(chain[2], 1), chain[1]);
+}
+
+/**
+ * @given subscriber of chain store with chain at heights 0 and 1
+ * @when heavier fork of genesis and then heavier extension of first chain are
+ * added
+ * @then subscriber gets current head, then reverts of abandoned tipsets and
+ * applies of new ones, oldest first
+ */
+TEST_F(ChainStoreTest, NotifiesHeadChanges) {
+  using fc::primitives::tipset::HeadChange;
+  using fc::primitives::tipset::HeadChangeType;
+  EXPECT_CALL(*weight_calculator, calculateWeight(_))
+      .WillRepeatedly(testing::Invoke(
+          [](const Tipset &tipset) { return BigInt(tipset.height); }));
+
+  std::vector<Tipset> chain;
+  for (auto height : {0, 1}) {
+    block.height = height;
+    block.parents = chain.empty() ? std::vector<CID>{} : chain.back().cids;
+    EXPECT_OUTCOME_TRUE_1(chain_store->addBlock(block));
+    EXPECT_OUTCOME_TRUE(tipset, Tipset::create({block}));
+    chain.push_back(tipset);
+  }
+  std::vector<std::pair<HeadChangeType, Tipset>> changes;
+  chain_store->subscribeHeadChanges([&](const HeadChange &change) {
+    changes.emplace_back(change.type, change.value);
+  });
+
+  auto fork_block = block;
+  fork_block.height = 2;
+  fork_block.miner = fc::primitives::address::Address::makeFromId(2);
+  fork_block.parents = chain[0].cids;
+  EXPECT_OUTCOME_TRUE_1(chain_store->addBlock(fork_block));
+  EXPECT_OUTCOME_TRUE(fork, Tipset::create({fork_block}));
+  block.height = 3;
+  block.parents = chain[1].cids;
+  EXPECT_OUTCOME_TRUE_1(chain_store->addBlock(block));
+  EXPECT_OUTCOME_TRUE(head, Tipset::create({block}));
+
+  std::vector<std::pair<HeadChangeType, Tipset>> expected{
+      {HeadChangeType::CURRENT, chain[1]},
+      {HeadChangeType::REVERT, chain[1]},
+      {HeadChangeType::APPLY, fork},
+      {HeadChangeType::REVERT, fork},
+      {HeadChangeType::APPLY, chain[1]},
+      {HeadChangeType::APPLY, head},
+  };
+  EXPECT_EQ(changes, expected);
+}
@@ -3,6 +3,8 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
+
 #include <gtest/gtest.h>
 
 #include <boost/filesystem.hpp>
@@ -149,3 +151,19 @@ TEST_F(DatastoreIntegrationTest, PersistentStorage) {
                       LeveldbDatastore::create(leveldb_path.string(), options));
   EXPECT_OUTCOME_EQ(open_again->contains(cid1), true);
 }
+
+/**
+ * @given datastore with two values stored
+ * @when visiting CIDs of values
+ * @then both CIDs are visited
+ */
+TEST_F(DatastoreIntegrationTest, ForEachCid) {
+  EXPECT_OUTCOME_TRUE_1(datastore->set(cid1, value));
+  EXPECT_OUTCOME_TRUE_1(datastore->set(cid2, value));
+
+  std::vector<CID> cids;
+  datastore->forEachCid([&](const CID &cid) { cids.push_back(cid); });
+  ASSERT_EQ(cids.size(), 2);
+  EXPECT_NE(std::find(cids.begin(), cids.end(), cid1), cids.end());
+  EXPECT_NE(std::find(cids.begin(), cids.end(), cid2), cids.end());
+}
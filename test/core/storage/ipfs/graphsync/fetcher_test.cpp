@@ -0,0 +1,247 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/graphsync/fetcher.hpp"
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <gtest/gtest.h>
+#include <libp2p/multi/multihash.hpp>
+
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/mocks/storage/ipfs/graphsync/graphsync_mock.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::CID;
+using fc::common::Buffer;
+using fc::common::getCidOf;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::storage::ipfs::graphsync::Fetcher;
+using fc::storage::ipfs::graphsync::FetcherError;
+using fc::storage::ipfs::graphsync::GraphsyncMock;
+using fc::storage::ipfs::graphsync::Ingester;
+using fc::storage::ipfs::graphsync::RequestProgressCallback;
+using fc::storage::ipfs::graphsync::ResponseStatusCode;
+using fc::storage::ipfs::graphsync::Subscription;
+using libp2p::peer::PeerId;
+using testing::_;
+
+class FetcherTest : public testing::Test {
+ public:
+  /// Request made by fetcher
+  struct Sent {
+    PeerId peer;
+    CID cid;
+    bool has_selector;
+    RequestProgressCallback callback;
+  };
+
+  void SetUp() override {
+    graphsync_ = std::make_shared<GraphsyncMock>();
+    fetcher_ = std::make_shared<Fetcher>(graphsync_, Fetcher::Config{2, 2});
+    EXPECT_CALL(*graphsync_, makeRequest(_, _, _, _, _, _))
+        .WillRepeatedly(testing::Invoke([this](const PeerId &peer,
+                                               auto,
+                                               const CID &cid,
+                                               auto selector,
+                                               auto,
+                                               auto callback) {
+          sent_.push_back(
+              Sent{peer, cid, !selector.empty(), std::move(callback)});
+          return Subscription{};
+        }));
+  }
+
+  static PeerId makePeer(uint8_t seed) {
+    std::vector<uint8_t> digest(32, seed);
+    auto hash = libp2p::multi::Multihash::create(
+                    libp2p::multi::HashType::sha256, digest)
+                    .value();
+    return PeerId::fromHash(hash).value();
+  }
+
+  static CID makeCid(uint8_t seed) {
+    std::vector<uint8_t> bytes{seed};
+    return getCidOf(bytes).value();
+  }
+
+  /// Starts fetch of root with given children, split at root level
+  void fetch(std::vector<CID> children) {
+    fetcher_->fetch(
+        root_,
+        1,
+        [children](const CID &) -> fc::outcome::result<std::vector<CID>> {
+          return children;
+        },
+        {0xA1, 0x61, 0x2E, 0xA0},
+        [this](fc::outcome::result<void> result) {
+          results_.push_back(result);
+        });
+  }
+
+  /// Responds to request with given index
+  void respond(size_t index, ResponseStatusCode status) {
+    auto callback = sent_.at(index).callback;
+    callback(status, {});
+  }
+
+  std::shared_ptr<GraphsyncMock> graphsync_;
+  std::shared_ptr<Fetcher> fetcher_;
+  std::vector<Sent> sent_;
+  std::vector<fc::outcome::result<void>> results_;
+  CID root_ = makeCid(0);
+  PeerId peer1_ = makePeer(1);
+  PeerId peer2_ = makePeer(2);
+};
+
+/**
+ * @given fetcher without peers
+ * @when fetch is started
+ * @then fetch fails with no peers error
+ */
+TEST_F(FetcherTest, NoPeers) {
+  fetch({});
+  EXPECT_TRUE(sent_.empty());
+  ASSERT_EQ(results_.size(), 1);
+  EXPECT_OUTCOME_ERROR(FetcherError::NO_PEERS, results_[0]);
+}
+
+/**
+ * @given two peers and root with four subtrees
+ * @when root is fetched
+ * @then subtrees are requested with selector, two from each peer
+ * and fetch succeeds when all of them are fetched
+ */
+TEST_F(FetcherTest, StripesSubtrees) {
+  fetcher_->addPeer(peer1_, boost::none);
+  fetcher_->addPeer(peer2_, boost::none);
+  fetch({makeCid(1), makeCid(2), makeCid(3), makeCid(4)});
+
+  ASSERT_EQ(sent_.size(), 1);
+  EXPECT_EQ(sent_[0].cid, root_);
+  EXPECT_FALSE(sent_[0].has_selector);
+
+  respond(0, fc::storage::ipfs::graphsync::RS_FULL_CONTENT);
+  ASSERT_EQ(sent_.size(), 5);
+  EXPECT_EQ(fetcher_->inFlight(), 4);
+  size_t from_peer1 = 0;
+  for (size_t i = 1; i < sent_.size(); ++i) {
+    EXPECT_TRUE(sent_[i].has_selector);
+    if (sent_[i].peer == peer1_) {
+      ++from_peer1;
+    }
+  }
+  EXPECT_EQ(from_peer1, 2);
+
+  for (size_t i = 1; i < sent_.size(); ++i) {
+    EXPECT_TRUE(results_.empty());
+    respond(i, fc::storage::ipfs::graphsync::RS_FULL_CONTENT);
+  }
+  ASSERT_EQ(results_.size(), 1);
+  EXPECT_TRUE(results_[0]);
+}
+
+/**
+ * @given two peers and subtree in flight
+ * @when subtree request times out
+ * @then subtree is re-requested from other peer
+ */
+TEST_F(FetcherTest, RetriesOnOtherPeer) {
+  fetcher_->addPeer(peer1_, boost::none);
+  fetcher_->addPeer(peer2_, boost::none);
+  auto child = makeCid(1);
+  fetch({child});
+  respond(0, fc::storage::ipfs::graphsync::RS_FULL_CONTENT);
+  ASSERT_EQ(sent_.size(), 2);
+  auto first_peer = sent_[1].peer;
+
+  respond(1, fc::storage::ipfs::graphsync::RS_TIMEOUT);
+  ASSERT_EQ(sent_.size(), 3);
+  EXPECT_EQ(sent_[2].cid, child);
+  EXPECT_FALSE(sent_[2].peer == first_peer);
+
+  respond(2, fc::storage::ipfs::graphsync::RS_FULL_CONTENT);
+  ASSERT_EQ(results_.size(), 1);
+  EXPECT_TRUE(results_[0]);
+}
+
+/**
+ * @given subtree failed on max attempts peers
+ * @when last attempt fails
+ * @then fetch fails with attempts exceeded error
+ */
+TEST_F(FetcherTest, AttemptsExceeded) {
+  fetcher_->addPeer(peer1_, boost::none);
+  fetcher_->addPeer(peer2_, boost::none);
+  fetch({makeCid(1)});
+  respond(0, fc::storage::ipfs::graphsync::RS_FULL_CONTENT);
+  respond(1, fc::storage::ipfs::graphsync::RS_NOT_FOUND);
+  ASSERT_EQ(sent_.size(), 3);
+  respond(2, fc::storage::ipfs::graphsync::RS_NOT_FOUND);
+  ASSERT_EQ(results_.size(), 1);
+  EXPECT_OUTCOME_ERROR(FetcherError::ATTEMPTS_EXCEEDED, results_[0]);
+}
+
+/**
+ * @given paused fetcher with root fetched
+ * @when fetcher is resumed
+ * @then subtrees are requested only after resume
+ */
+TEST_F(FetcherTest, Paused) {
+  fetcher_->addPeer(peer1_, boost::none);
+  fetch({makeCid(1)});
+  fetcher_->setPaused(true);
+  respond(0, fc::storage::ipfs::graphsync::RS_FULL_CONTENT);
+  EXPECT_EQ(sent_.size(), 1);
+  EXPECT_TRUE(results_.empty());
+
+  fetcher_->setPaused(false);
+  ASSERT_EQ(sent_.size(), 2);
+  respond(1, fc::storage::ipfs::graphsync::RS_FULL_CONTENT);
+  ASSERT_EQ(results_.size(), 1);
+  EXPECT_TRUE(results_[0]);
+}
+
+/**
+ * @given fetcher splitting blocks written by ingester
+ * @when root is fetched while it is still queued in ingester
+ * @then root is split only after it is written to datastore
+ */
+TEST_F(FetcherTest, SplitsAfterIngesterFlush) {
+  auto io = std::make_shared<boost::asio::io_context>();
+  auto datastore = std::make_shared<InMemoryDatastore>();
+  auto ingester = std::make_shared<Ingester>(
+      io, datastore, Ingester::Config{1, 16, 1024}, [](bool) {});
+  fetcher_ =
+      std::make_shared<Fetcher>(graphsync_, Fetcher::Config{2, 2}, ingester);
+  fetcher_->addPeer(peer1_, boost::none);
+  auto child = makeCid(1);
+  fetcher_->fetch(
+      root_,
+      1,
+      [&](const CID &cid) -> fc::outcome::result<std::vector<CID>> {
+        OUTCOME_TRY(datastore->get(cid));
+        return std::vector<CID>{child};
+      },
+      {0xA1, 0x61, 0x2E, 0xA0},
+      [this](fc::outcome::result<void> result) {
+        results_.push_back(result);
+      });
+
+  ingester->push(root_, Buffer{0});
+  respond(0, fc::storage::ipfs::graphsync::RS_FULL_CONTENT);
+  auto work = boost::asio::make_work_guard(*io);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (sent_.size() < 2 && results_.empty()
+         && std::chrono::steady_clock::now() < deadline) {
+    io->run_one_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_TRUE(results_.empty());
+  ASSERT_EQ(sent_.size(), 2);
+  EXPECT_EQ(sent_[1].cid, child);
+
+  respond(1, fc::storage::ipfs::graphsync::RS_FULL_CONTENT);
+  ASSERT_EQ(results_.size(), 1);
+  EXPECT_TRUE(results_[0]);
+}
@@ -0,0 +1,124 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/graphsync/ingester.hpp"
+
+#include <gtest/gtest.h>
+
+#include "crypto/hasher/hasher.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::CID;
+using fc::common::Buffer;
+using fc::common::getCidOf;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::storage::ipfs::graphsync::Ingester;
+using fc::storage::ipfs::graphsync::IngesterError;
+using fc::storage::ipfs::graphsync::verifyBlock;
+
+class IngesterTest : public testing::Test {
+ public:
+  void SetUp() override {
+    io_ = std::make_shared<boost::asio::io_context>();
+    datastore_ = std::make_shared<InMemoryDatastore>();
+  }
+
+  void makeIngester(Ingester::Config config) {
+    ingester_ = std::make_shared<Ingester>(
+        io_,
+        datastore_,
+        config,
+        [this](bool full) { backpressure_.push_back(full); },
+        [this](const CID &cid, std::error_code) { errors_.push_back(cid); });
+  }
+
+  /// Flushes ingester and runs event loop until flush completes
+  fc::outcome::result<void> flush() {
+    fc::outcome::result<void> flushed = IngesterError::HASH_MISMATCH;
+    bool done = false;
+    ingester_->flush([&](fc::outcome::result<void> result) {
+      flushed = result;
+      done = true;
+      io_->stop();
+    });
+    if (!done) {
+      io_->run_for(std::chrono::seconds(5));
+    }
+    EXPECT_TRUE(done);
+    return flushed;
+  }
+
+  std::shared_ptr<boost::asio::io_context> io_;
+  std::shared_ptr<InMemoryDatastore> datastore_;
+  std::shared_ptr<Ingester> ingester_;
+  std::vector<bool> backpressure_;
+  std::vector<CID> errors_;
+  Buffer data1_{1, 2, 3, 4};
+  Buffer data2_{5, 6, 7, 8};
+};
+
+/**
+ * @given blocks with blake2b-256, sha2-256 and unsupported hashes
+ * @when blocks are verified
+ * @then matching blocks pass, other blocks fail with corresponding errors
+ */
+TEST_F(IngesterTest, VerifyBlock) {
+  auto cid = getCidOf(data1_).value();
+  EXPECT_OUTCOME_TRUE_1(verifyBlock(cid, data1_));
+  EXPECT_OUTCOME_ERROR(IngesterError::HASH_MISMATCH, verifyBlock(cid, data2_));
+
+  CID sha{CID::Version::V1,
+          libp2p::multi::MulticodecType::DAG_CBOR,
+          fc::crypto::Hasher::sha2_256(data1_)};
+  EXPECT_OUTCOME_TRUE_1(verifyBlock(sha, data1_));
+
+  std::vector<uint8_t> digest(32, 1);
+  CID unsupported{CID::Version::V1,
+                  libp2p::multi::MulticodecType::DAG_CBOR,
+                  libp2p::multi::Multihash::create(
+                      libp2p::multi::HashType::sha512, digest)
+                      .value()};
+  EXPECT_OUTCOME_ERROR(IngesterError::UNSUPPORTED_HASH,
+                       verifyBlock(unsupported, data1_));
+}
+
+/**
+ * @given ingester with batches of two blocks
+ * @when valid and tampered blocks are pushed
+ * @then valid blocks are written, tampered block is dropped and reported
+ */
+TEST_F(IngesterTest, WritesVerifiedBlocks) {
+  makeIngester({2, 2, 1024});
+  auto cid1 = getCidOf(data1_).value();
+  auto cid2 = getCidOf(data2_).value();
+  auto tampered = getCidOf(Buffer{9}).value();
+  ingester_->push(cid1, data1_);
+  ingester_->push(tampered, data1_);
+  ingester_->push(cid2, data2_);
+
+  EXPECT_OUTCOME_ERROR(IngesterError::HASH_MISMATCH, flush());
+  EXPECT_OUTCOME_EQ(datastore_->get(cid1), data1_);
+  EXPECT_OUTCOME_EQ(datastore_->get(cid2), data2_);
+  EXPECT_OUTCOME_EQ(datastore_->contains(tampered), false);
+  ASSERT_EQ(errors_.size(), 1);
+  EXPECT_EQ(errors_[0], tampered);
+  EXPECT_EQ(ingester_->queuedBytes(), 0);
+  EXPECT_TRUE(backpressure_.empty());
+}
+
+/**
+ * @given ingester with queue limit less than block
+ * @when block is pushed and queue drains
+ * @then backpressure is set and then released
+ */
+TEST_F(IngesterTest, Backpressure) {
+  makeIngester({1, 16, 2});
+  ingester_->push(getCidOf(data1_).value(), data1_);
+
+  EXPECT_OUTCOME_TRUE_1(flush());
+  EXPECT_EQ(backpressure_, (std::vector<bool>{true, false}));
+  EXPECT_FALSE(ingester_->full());
+}
@@ -0,0 +1,66 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/graphsync/impl/network/marshalling/response_builder.hpp"
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+#include <libp2p/multi/uvarint.hpp>
+
+#include "storage/ipfs/graphsync/impl/network/marshalling/message_parser.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::common::Buffer;
+using fc::common::getCidOf;
+using fc::storage::ipfs::graphsync::ByteArray;
+using fc::storage::ipfs::graphsync::parseMessage;
+using fc::storage::ipfs::graphsync::ResponseBuilder;
+using fc::storage::ipfs::graphsync::SharedData;
+
+/**
+ * @given response with small and large data blocks
+ * @when response is serialized to segments
+ * @then large block is referenced by segment, not copied, and joined
+ * segments are parsed as the same response
+ */
+TEST(GraphsyncMarshalling, ResponseSegments) {
+  auto small = std::make_shared<const ByteArray>(100, 1);
+  auto large = std::make_shared<const ByteArray>(10000, 2);
+  EXPECT_OUTCOME_TRUE(small_cid, getCidOf(*small));
+  EXPECT_OUTCOME_TRUE(large_cid, getCidOf(*large));
+
+  ResponseBuilder builder;
+  builder.addDataBlock(small_cid, small);
+  builder.addDataBlock(large_cid, large);
+  builder.addResponse(1, fc::storage::ipfs::graphsync::RS_FULL_CONTENT, {});
+  auto size = builder.getSerializedSize();
+  EXPECT_OUTCOME_TRUE(segments, builder.serialize());
+
+  EXPECT_EQ(std::count(segments.begin(), segments.end(), large), 1);
+  EXPECT_EQ(std::count(segments.begin(), segments.end(), small), 0);
+
+  ByteArray bytes;
+  for (const auto &segment : segments) {
+    bytes.insert(bytes.end(), segment->begin(), segment->end());
+  }
+  auto prefix = libp2p::multi::UVarint::create(bytes);
+  ASSERT_TRUE(prefix);
+  EXPECT_EQ(prefix->toUInt64(), size);
+  ASSERT_EQ(bytes.size(), prefix->size() + size);
+
+  EXPECT_OUTCOME_TRUE(
+      message,
+      parseMessage(gsl::make_span(bytes).subspan(prefix->size())));
+  ASSERT_EQ(message.responses.size(), 1);
+  EXPECT_EQ(message.responses[0].id, 1);
+  EXPECT_EQ(message.responses[0].status,
+            fc::storage::ipfs::graphsync::RS_FULL_CONTENT);
+  ASSERT_EQ(message.data.size(), 2);
+  EXPECT_EQ(message.data[0].first, small_cid);
+  EXPECT_EQ(message.data[0].second, Buffer(*small));
+  EXPECT_EQ(message.data[1].first, large_cid);
+  EXPECT_EQ(message.data[1].second, Buffer(*large));
+}
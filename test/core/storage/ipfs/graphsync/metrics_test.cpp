@@ -0,0 +1,78 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/graphsync/metrics.hpp"
+
+#include <gtest/gtest.h>
+#include <libp2p/multi/multihash.hpp>
+
+using fc::storage::ipfs::graphsync::Metrics;
+using libp2p::peer::PeerId;
+
+class GraphsyncMetricsTest : public testing::Test {
+ public:
+  static PeerId makePeer(uint8_t seed) {
+    std::vector<uint8_t> digest(32, seed);
+    auto hash = libp2p::multi::Multihash::create(
+                    libp2p::multi::HashType::sha256, digest)
+                    .value();
+    return PeerId::fromHash(hash).value();
+  }
+
+  bool hasLine(const std::string &line) {
+    return metrics_.toPrometheus().find(line + "\n") != std::string::npos;
+  }
+
+  Metrics metrics_;
+  PeerId peer1_ = makePeer(1);
+  PeerId peer2_ = makePeer(2);
+};
+
+/**
+ * @given bytes and blocks counted for two peers
+ * @when one peer is closed due to slow stream
+ * @then totals keep bytes of closed peer, its series are removed and
+ * disconnect is counted
+ */
+TEST_F(GraphsyncMetricsTest, PeerCounters) {
+  metrics_.addBytesOut(peer1_, 100);
+  metrics_.addBytesOut(peer2_, 20);
+  metrics_.addBlocksIn(peer2_, 3);
+  metrics_.setQueueBytes(peer1_, 50);
+  metrics_.setQueueBytes(peer2_, 5);
+
+  auto peer1 = "{peer=\"" + peer1_.toBase58() + "\"}";
+  EXPECT_TRUE(hasLine("graphsync_sent_bytes_total 120"));
+  EXPECT_TRUE(hasLine("graphsync_sent_bytes_total" + peer1 + " 100"));
+  EXPECT_TRUE(hasLine("graphsync_received_blocks_total 3"));
+  EXPECT_TRUE(hasLine("graphsync_queue_bytes 55"));
+
+  metrics_.onPeerClosed(peer1_,
+                        fc::storage::ipfs::graphsync::RS_SLOW_STREAM);
+  EXPECT_TRUE(hasLine("graphsync_sent_bytes_total 120"));
+  EXPECT_FALSE(hasLine("graphsync_sent_bytes_total" + peer1 + " 100"));
+  EXPECT_TRUE(hasLine("graphsync_queue_bytes 5"));
+  EXPECT_TRUE(hasLine("graphsync_slow_stream_disconnects_total 1"));
+}
+
+/**
+ * @given durations observed
+ * @when metrics are rendered
+ * @then histogram buckets are cumulative and count all observations
+ */
+TEST_F(GraphsyncMetricsTest, Histograms) {
+  auto now = Metrics::Clock::now();
+  metrics_.observeSelect(now);
+  metrics_.observeSelect(now - std::chrono::seconds(2));
+  metrics_.observeSelect(now - std::chrono::seconds(100));
+
+  EXPECT_TRUE(hasLine("graphsync_select_duration_seconds_bucket{le=\"1\"} 1"));
+  EXPECT_TRUE(hasLine("graphsync_select_duration_seconds_bucket{le=\"5\"} 2"));
+  EXPECT_TRUE(
+      hasLine("graphsync_select_duration_seconds_bucket{le=\"+Inf\"} 3"));
+  EXPECT_TRUE(hasLine("graphsync_select_duration_seconds_count 3"));
+  EXPECT_TRUE(hasLine(
+      "graphsync_request_duration_seconds_count{side=\"local\"} 0"));
+}
@@ -0,0 +1,413 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/graphsync/impl/remote_requests.hpp"
+
+#include <atomic>
+
+#include <gtest/gtest.h>
+#include <libp2p/multi/multihash.hpp>
+#include <libp2p/protocol/common/asio/asio_scheduler.hpp>
+
+#include "storage/ipfs/graphsync/extension.hpp"
+#include "storage/ipfs/graphsync/metrics.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::CID;
+using fc::common::Buffer;
+using fc::common::getCidOf;
+using fc::storage::ipfs::graphsync::decodeResponseMetadata;
+using fc::storage::ipfs::graphsync::Extension;
+using fc::storage::ipfs::graphsync::kResponseMetadataProtocol;
+using fc::storage::ipfs::graphsync::MerkleDagBridge;
+using fc::storage::ipfs::graphsync::Message;
+using fc::storage::ipfs::graphsync::Metrics;
+using fc::storage::ipfs::graphsync::RemoteRequests;
+using fc::storage::ipfs::graphsync::RequestId;
+using fc::storage::ipfs::graphsync::ResponseMetadata;
+using fc::storage::ipfs::graphsync::ResponseSender;
+using fc::storage::ipfs::graphsync::ResponseStatusCode;
+using fc::storage::ipfs::graphsync::RS_FULL_CONTENT;
+using fc::storage::ipfs::graphsync::RS_PARTIAL_RESPONSE;
+using fc::storage::ipfs::graphsync::RS_SLOW_STREAM;
+using fc::storage::ipfs::graphsync::RS_TRY_AGAIN;
+using fc::storage::ipfs::graphsync::SharedData;
+using libp2p::peer::PeerId;
+
+/// Records blocks and responses sent by remote requests module
+class ResponseSenderFake : public ResponseSender {
+ public:
+  /// Block added to response or response sent
+  struct Event {
+    RequestId id;
+    boost::optional<CID> block;
+    ResponseStatusCode status;
+    std::vector<Extension> extensions;
+  };
+
+  bool addBlockToResponse(const PeerId &,
+                          RequestId request_id,
+                          const CID &cid,
+                          SharedData) override {
+    if (!accept) {
+      return false;
+    }
+    events.push_back({request_id, cid, {}, {}});
+    return true;
+  }
+
+  size_t getPendingBytes(const PeerId &peer) override {
+    return !slow_peer || peer == *slow_peer ? pending : 0;
+  }
+
+  void sendResponse(const PeerId &,
+                    RequestId request_id,
+                    ResponseStatusCode status,
+                    const std::vector<Extension> &extensions) override {
+    events.push_back({request_id, boost::none, status, extensions});
+  }
+
+  /// Final status of request, if response was sent
+  boost::optional<ResponseStatusCode> response(RequestId id) const {
+    for (const auto &event : events) {
+      if (!event.block && event.id == id) {
+        return event.status;
+      }
+    }
+    return boost::none;
+  }
+
+  /// Responses sent, in order
+  std::vector<ResponseStatusCode> responses() const {
+    std::vector<ResponseStatusCode> statuses;
+    for (const auto &event : events) {
+      if (!event.block) {
+        statuses.push_back(event.status);
+      }
+    }
+    return statuses;
+  }
+
+  bool accept = true;
+  /// Bytes pending write, of all peers or only of slow peer if set
+  size_t pending = 0;
+  boost::optional<PeerId> slow_peer;
+  std::vector<Event> events;
+};
+
+/// Passes the same blocks to handler for any selector
+class MerkleDagBridgeFake : public MerkleDagBridge {
+ public:
+  explicit MerkleDagBridgeFake(std::vector<std::pair<CID, Buffer>> blocks)
+      : blocks_(std::move(blocks)) {}
+
+  fc::outcome::result<size_t> select(
+      const CID &,
+      gsl::span<const uint8_t>,
+      std::function<bool(const CID &cid, const Buffer &data)> handler)
+      const override {
+    size_t count = 0;
+    for (const auto &[cid, data] : blocks_) {
+      ++entered;
+      if (!handler(cid, data)) {
+        break;
+      }
+      ++returned;
+      ++count;
+    }
+    finished = true;
+    return count;
+  }
+
+  mutable std::atomic<size_t> entered{0};
+  mutable std::atomic<size_t> returned{0};
+  mutable std::atomic<bool> finished{false};
+
+ private:
+  std::vector<std::pair<CID, Buffer>> blocks_;
+};
+
+class RemoteRequestsTest : public testing::Test {
+ public:
+  void SetUp() override {
+    io_ = std::make_shared<boost::asio::io_context>();
+    scheduler_ = std::make_shared<libp2p::protocol::AsioScheduler>(
+        *io_, libp2p::protocol::SchedulerConfig{});
+    sender_ = std::make_shared<ResponseSenderFake>();
+    for (uint8_t i = 0; i < 5; ++i) {
+      Buffer data{i, i, i, i};
+      blocks_.emplace_back(getCidOf(data).value(), data);
+    }
+    dag_ = std::make_shared<MerkleDagBridgeFake>(blocks_);
+  }
+
+  void TearDown() override {
+    remote_.reset();
+  }
+
+  void makeRemote(RemoteRequests::Config config) {
+    remote_ = std::make_shared<RemoteRequests>(
+        scheduler_, sender_, std::make_shared<Metrics>(), config);
+  }
+
+  static PeerId makePeer(uint8_t seed) {
+    std::vector<uint8_t> digest(32, seed);
+    auto hash = libp2p::multi::Multihash::create(
+                    libp2p::multi::HashType::sha256, digest)
+                    .value();
+    return PeerId::fromHash(hash).value();
+  }
+
+  void request(RequestId id,
+               std::shared_ptr<MerkleDagBridge> dag,
+               const PeerId &peer) {
+    Message::Request request;
+    request.id = id;
+    request.root_cid = blocks_.front().first;
+    remote_->newRequest(std::move(dag), peer, std::move(request));
+  }
+
+  void request(RequestId id, std::shared_ptr<MerkleDagBridge> dag) {
+    request(id, std::move(dag), peer_);
+  }
+
+  /// Runs event loop until condition holds, returns false on timeout
+  bool runUntil(const std::function<bool()> &condition) {
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        return false;
+      }
+      io_->restart();
+      io_->run_for(std::chrono::milliseconds(1));
+    }
+    return true;
+  }
+
+  /// Runs event loop until final response is sent
+  bool runUntilResponse(ResponseStatusCode status) {
+    return runUntil([&] {
+      auto responses = sender_->responses();
+      return !responses.empty() && responses.back() == status;
+    });
+  }
+
+  std::shared_ptr<boost::asio::io_context> io_;
+  std::shared_ptr<libp2p::protocol::Scheduler> scheduler_;
+  std::shared_ptr<ResponseSenderFake> sender_;
+  std::vector<std::pair<CID, Buffer>> blocks_;
+  std::shared_ptr<MerkleDagBridgeFake> dag_;
+  std::shared_ptr<RemoteRequests> remote_;
+  PeerId peer_ = makePeer(1);
+};
+
+/**
+ * @given 5 blocks of 4 bytes and chunks of 10 bytes
+ * @when request is served
+ * @then 3 blocks are sent in partial response and 2 blocks in final response
+ */
+TEST_F(RemoteRequestsTest, SendsChunks) {
+  RemoteRequests::Config config;
+  config.chunk_bytes = 10;
+  makeRemote(config);
+  request(1, dag_);
+
+  ASSERT_TRUE(runUntilResponse(RS_FULL_CONTENT));
+  const auto &events = sender_->events;
+  ASSERT_EQ(events.size(), 7);
+  for (size_t i : {0, 1, 2}) {
+    EXPECT_EQ(events[i].block, blocks_[i].first);
+  }
+  EXPECT_FALSE(events[3].block);
+  EXPECT_EQ(events[3].status, RS_PARTIAL_RESPONSE);
+  EXPECT_EQ(events[4].block, blocks_[3].first);
+  EXPECT_EQ(events[5].block, blocks_[4].first);
+}
+
+/**
+ * @given byte budget of two blocks and peer which doesn't read
+ * @when request is served
+ * @then worker waits on third block until peer reads, then all blocks are
+ * sent
+ */
+TEST_F(RemoteRequestsTest, WaitsForBudget) {
+  RemoteRequests::Config config;
+  config.peer_budget = 8;
+  config.total_budget = 8;
+  config.chunk_bytes = 8;
+  makeRemote(config);
+  sender_->pending = 8;
+  request(1, dag_);
+
+  ASSERT_TRUE(runUntil([&] { return dag_->entered == 3; }));
+  // worker keeps waiting while rounds skip the peer
+  io_->restart();
+  io_->run_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(dag_->entered, 3);
+  EXPECT_EQ(dag_->returned, 2);
+  EXPECT_TRUE(sender_->events.empty());
+
+  sender_->pending = 0;
+  ASSERT_TRUE(runUntilResponse(RS_FULL_CONTENT));
+  EXPECT_EQ(dag_->returned, 5);
+  EXPECT_EQ(sender_->events.size() - sender_->responses().size(), 5);
+}
+
+/**
+ * @given peer which closed its stream
+ * @when block cannot be added to response
+ * @then request is cancelled without response and selection stops
+ */
+TEST_F(RemoteRequestsTest, CancelsClosedPeer) {
+  RemoteRequests::Config config;
+  config.peer_budget = 8;
+  config.total_budget = 8;
+  config.chunk_bytes = 8;
+  makeRemote(config);
+  sender_->accept = false;
+  request(1, dag_);
+
+  ASSERT_TRUE(runUntil([&] { return dag_->finished.load(); }));
+  EXPECT_LT(dag_->returned, 5);
+  EXPECT_TRUE(sender_->events.empty());
+}
+
+/**
+ * @given worker waiting for budget
+ * @when all requests are cancelled
+ * @then worker resumes and selection stops
+ */
+TEST_F(RemoteRequestsTest, CancelAllReleasesWorker) {
+  RemoteRequests::Config config;
+  config.peer_budget = 8;
+  config.total_budget = 8;
+  config.chunk_bytes = 8;
+  makeRemote(config);
+  sender_->pending = 8;
+  request(1, dag_);
+
+  ASSERT_TRUE(runUntil([&] { return dag_->entered == 3; }));
+  remote_->cancelAll();
+  ASSERT_TRUE(runUntil([&] { return dag_->finished.load(); }));
+  EXPECT_EQ(dag_->returned, 2);
+  EXPECT_TRUE(sender_->events.empty());
+}
+
+/**
+ * @given peer whose write queue stays over budget
+ * @when stall deadline expires
+ * @then request is cancelled with slow stream status and worker resumes
+ */
+TEST_F(RemoteRequestsTest, CancelsSlowPeer) {
+  RemoteRequests::Config config;
+  config.peer_budget = 8;
+  config.total_budget = 8;
+  config.chunk_bytes = 8;
+  config.stall_msec = 20;
+  makeRemote(config);
+  sender_->pending = 8;
+  request(1, dag_);
+
+  ASSERT_TRUE(runUntilResponse(RS_SLOW_STREAM));
+  ASSERT_TRUE(runUntil([&] { return dag_->finished.load(); }));
+  EXPECT_EQ(dag_->returned, 2);
+  EXPECT_EQ(sender_->events.size(), 1);
+}
+
+/**
+ * @given two overlapping requests of the same peer
+ * @when both are served
+ * @then each block is written once, blocks written by the first request are
+ * listed in response metadata of the second one
+ */
+TEST_F(RemoteRequestsTest, SkipsWrittenBlocks) {
+  makeRemote(RemoteRequests::Config{});
+  auto overlap = std::make_shared<MerkleDagBridgeFake>(
+      std::vector<std::pair<CID, Buffer>>(blocks_.begin() + 2, blocks_.end()));
+  request(1, dag_);
+  request(2, overlap);
+
+  ASSERT_TRUE(runUntil([&] { return sender_->responses().size() == 2; }));
+  std::vector<CID> written;
+  boost::optional<Extension> metadata;
+  for (const auto &event : sender_->events) {
+    if (event.block) {
+      written.push_back(*event.block);
+    } else if (event.id == 2) {
+      EXPECT_EQ(event.status, RS_FULL_CONTENT);
+      for (const auto &extension : event.extensions) {
+        if (extension.name == kResponseMetadataProtocol) {
+          metadata = extension;
+        }
+      }
+    }
+  }
+  ASSERT_EQ(written.size(), blocks_.size());
+  for (size_t i = 0; i < blocks_.size(); ++i) {
+    EXPECT_EQ(written[i], blocks_[i].first);
+  }
+  ASSERT_TRUE(metadata);
+  EXPECT_OUTCOME_TRUE(skipped, decodeResponseMetadata(*metadata));
+  ResponseMetadata expected;
+  for (size_t i = 2; i < blocks_.size(); ++i) {
+    expected.emplace_back(blocks_[i].first, true);
+  }
+  EXPECT_EQ(skipped, expected);
+}
+
+/**
+ * @given two workers, peer which doesn't read with two requests and another
+ * peer with one request
+ * @when requests are served
+ * @then second request of slow peer waits for its first one, and request of
+ * another peer is served meanwhile
+ */
+TEST_F(RemoteRequestsTest, SlowPeerTakesOneWorker) {
+  RemoteRequests::Config config;
+  config.peer_budget = 8;
+  config.chunk_bytes = 8;
+  makeRemote(config);
+  sender_->pending = 8;
+  sender_->slow_peer = peer_;
+  auto second = std::make_shared<MerkleDagBridgeFake>(blocks_);
+  auto other = std::make_shared<MerkleDagBridgeFake>(blocks_);
+  request(1, dag_);
+  request(2, second);
+  request(3, other, makePeer(2));
+
+  ASSERT_TRUE(runUntil([&] {
+    return sender_->response(3).has_value() && dag_->entered == 3;
+  }));
+  EXPECT_EQ(sender_->response(3), RS_FULL_CONTENT);
+  EXPECT_EQ(other->returned, 5);
+  EXPECT_EQ(dag_->entered, 3);
+  EXPECT_EQ(second->entered, 0);
+}
+
+/**
+ * @given peer which doesn't read holding the whole total budget
+ * @when request of another peer waits for budget longer than allowed
+ * @then its worker gives up and request ends with try again status
+ */
+TEST_F(RemoteRequestsTest, GivesUpWaitingForTotalBudget) {
+  RemoteRequests::Config config;
+  config.peer_budget = 8;
+  config.total_budget = 8;
+  config.chunk_bytes = 8;
+  config.budget_wait_msec = 20;
+  makeRemote(config);
+  sender_->pending = 8;
+  sender_->slow_peer = peer_;
+  auto other = std::make_shared<MerkleDagBridgeFake>(blocks_);
+  request(1, dag_);
+  ASSERT_TRUE(runUntil([&] { return dag_->entered == 3; }));
+  request(2, other, makePeer(2));
+
+  ASSERT_TRUE(runUntil([&] { return sender_->response(2).has_value(); }));
+  EXPECT_EQ(sender_->response(2), RS_TRY_AGAIN);
+  EXPECT_EQ(other->returned, 0);
+  EXPECT_FALSE(sender_->response(1));
+}
@@ -9,14 +9,18 @@
 
 #include <gtest/gtest.h>
 #include "common/outcome.hpp"
+#include "storage/ipfs/impl/cid_bloom_filter.hpp"
 #include "storage/ipfs/impl/in_memory_datastore.hpp"
 #include "storage/ipld/ipld_block.hpp"
+#include "testutil/mocks/storage/ipfs/ipfs_datastore_mock.hpp"
 #include "testutil/outcome.hpp"
 
 using fc::CID;
 using fc::common::Buffer;
 using fc::common::getCidOf;
+using fc::storage::ipfs::CidBloomFilter;
 using fc::storage::ipfs::InMemoryDatastore;
+using fc::storage::ipfs::MockIpfsDatastore;
 using fc::storage::ipld::IPLDBlock;
 using fc::storage::ipfs::IpfsBlockService;
 
@@ -122,3 +126,127 @@ TEST_F(BlockServiceTest, GetInvalidCidFailure) {
   EXPECT_OUTCOME_FALSE(result, block_service_.get(cid))
   std::ignore = result;
 }
+
+/**
+ * @given Block stored through BlockService
+ * @when Storing same block again, alone and in batch
+ * @then Block is written to datastore once, existence is checked instead
+ */
+TEST(BlockServiceDedupTest, SkipsStoredBlocks) {
+  auto store = std::make_shared<MockIpfsDatastore>();
+  IpfsBlockService block_service{store};
+  BlockTestImpl block{{1, 2, 3}};
+  const auto &cid = block.getCID();
+  EXPECT_CALL(*store, set(cid, block.getRawBytes()))
+      .WillOnce(testing::Return(fc::outcome::success()));
+  EXPECT_CALL(*store, contains(cid)).WillRepeatedly(testing::Return(true));
+
+  EXPECT_OUTCOME_TRUE_1(block_service.set(cid, block.getRawBytes()));
+  EXPECT_OUTCOME_TRUE_1(block_service.set(cid, block.getRawBytes()));
+  EXPECT_OUTCOME_TRUE_1(block_service.setMany({{cid, block.getRawBytes()}}));
+}
+
+/**
+ * @given Filter seeded with CID of block stored before
+ * @when Storing block
+ * @then Existence is checked and block is not written again
+ */
+TEST(BlockServiceDedupTest, SeededFilter) {
+  auto store = std::make_shared<MockIpfsDatastore>();
+  IpfsBlockService block_service{store};
+  BlockTestImpl block{{1, 2, 3}};
+  const auto &cid = block.getCID();
+  EXPECT_CALL(*store, set(testing::_, testing::_)).Times(0);
+  EXPECT_CALL(*store, contains(cid)).WillOnce(testing::Return(true));
+
+  block_service.seedStored(cid);
+  EXPECT_OUTCOME_TRUE_1(block_service.set(cid, block.getRawBytes()));
+}
+
+/**
+ * @given Filter expecting one block, seeded with CIDs of three blocks
+ * @when Storing blocks
+ * @then Filter grows, existence is checked and blocks are not written again
+ */
+TEST(BlockServiceDedupTest, FilterGrows) {
+  auto store = std::make_shared<MockIpfsDatastore>();
+  IpfsBlockService block_service{store, 1};
+  std::vector<BlockTestImpl> blocks{{{1}}, {{2}}, {{3}}};
+  EXPECT_CALL(*store, set(testing::_, testing::_)).Times(0);
+  for (const auto &block : blocks) {
+    EXPECT_CALL(*store, contains(block.getCID()))
+        .WillOnce(testing::Return(true));
+    block_service.seedStored(block.getCID());
+  }
+  for (const auto &block : blocks) {
+    EXPECT_OUTCOME_TRUE_1(
+        block_service.set(block.getCID(), block.getRawBytes()));
+  }
+}
+
+/**
+ * @given Block service which marks one block at most
+ * @when Setting two blocks
+ * @then Only the first block is marked, it is re-marked when set again
+ */
+TEST(BlockServiceDedupTest, BoundedMarks) {
+  IpfsBlockService block_service{std::make_shared<InMemoryDatastore>(),
+                                 IpfsBlockService::kDefaultExpectedBlocks,
+                                 1};
+  BlockTestImpl first{{1}};
+  BlockTestImpl second{{2}};
+  block_service.nextGeneration();
+  EXPECT_OUTCOME_TRUE_1(block_service.set(first.getCID(), first.content));
+  EXPECT_OUTCOME_TRUE_1(block_service.set(second.getCID(), second.content));
+  auto generation = block_service.nextGeneration();
+  EXPECT_OUTCOME_TRUE_1(block_service.set(first.getCID(), first.content));
+
+  ASSERT_TRUE(block_service.takeMarkedBefore(generation).empty());
+  ASSERT_EQ(block_service.takeMarkedBefore(generation + 1),
+            std::vector<CID>{first.getCID()});
+}
+
+/**
+ * @given Blocks set in two generations
+ * @when Taking blocks marked before second generation
+ * @then Only blocks not set again in second generation are taken
+ */
+TEST_F(BlockServiceTest, GenerationMarks) {
+  BlockTestImpl other{{1, 2, 3}};
+  const auto &cid = sample_block_.getCID();
+  auto first = block_service_.nextGeneration();
+  EXPECT_OUTCOME_TRUE_1(block_service_.set(cid, sample_block_.getRawBytes()));
+  EXPECT_OUTCOME_TRUE_1(block_service_.set(other.getCID(), other.content));
+  auto second = block_service_.nextGeneration();
+  EXPECT_OUTCOME_TRUE_1(block_service_.set(cid, sample_block_.getRawBytes()));
+
+  ASSERT_TRUE(block_service_.takeMarkedBefore(first).empty());
+  ASSERT_EQ(block_service_.takeMarkedBefore(second),
+            std::vector<CID>{other.getCID()});
+  ASSERT_TRUE(block_service_.takeMarkedBefore(second).empty());
+}
+
+/**
+ * @given Bloom filter of CIDs
+ * @when CIDs are added
+ * @then Added CIDs are reported, most of other CIDs are not
+ */
+TEST(CidBloomFilterTest, MayContain) {
+  CidBloomFilter filter{100, 0.01};
+  std::vector<CID> cids;
+  for (uint8_t i = 0; i < 200; ++i) {
+    cids.push_back(getCidOf(std::vector<uint8_t>{i}).value());
+  }
+  for (size_t i = 0; i < 100; ++i) {
+    filter.insert(cids[i]);
+  }
+  size_t false_positives = 0;
+  for (size_t i = 0; i < cids.size(); ++i) {
+    if (i < 100) {
+      ASSERT_TRUE(filter.mayContain(cids[i]));
+    } else if (filter.mayContain(cids[i])) {
+      ++false_positives;
+    }
+  }
+  ASSERT_LT(false_positives, 10);
+}
@@ -7,6 +7,7 @@
 
 #include <gtest/gtest.h>
 #include <testutil/outcome.hpp>
+#include "codec/cbor/cbor_encode_stream.hpp"
 #include "core/storage/ipfs/merkledag/ipfs_merkledag_dataset.hpp"
 #include "storage/ipfs/impl/in_memory_datastore.hpp"
 #include "storage/ipfs/impl/ipfs_block_service.hpp"
@@ -14,6 +15,46 @@
 using namespace fc::storage::ipfs;
 using namespace fc::storage::ipld;
 using namespace fc::storage::ipfs::merkledag;
+using fc::codec::cbor::CborEncodeStream;
+
+/// Encodes selector of given kind and body
+CborEncodeStream encodeSelector(const std::string &kind,
+                                std::map<std::string, CborEncodeStream> body) {
+  auto selector = CborEncodeStream::map();
+  selector[kind] << body;
+  CborEncodeStream stream;
+  stream << selector;
+  return stream;
+}
+
+/// Encodes selector of DAG-PB nodes, which explores links by next selector
+CborEncodeStream encodeLinksSelector(const CborEncodeStream &next) {
+  auto hash = CborEncodeStream::map();
+  hash["Hash"] << next;
+  auto fields = CborEncodeStream::map();
+  fields["f>"] << hash;
+  auto all = CborEncodeStream::map();
+  all[">"] << encodeSelector("f", std::move(fields));
+  auto links = CborEncodeStream::map();
+  links["Links"] << encodeSelector("a", std::move(all));
+  auto root_fields = CborEncodeStream::map();
+  root_fields["f>"] << links;
+  return encodeSelector("f", std::move(root_fields));
+}
+
+/// Encodes recursive selector of DAG-PB links with optional depth limit
+std::vector<uint8_t> encodeRecursiveSelector(boost::optional<size_t> depth) {
+  auto limit = CborEncodeStream::map();
+  if (depth) {
+    limit["depth"] << *depth;
+  } else {
+    limit["none"] << CborEncodeStream::map();
+  }
+  auto body = CborEncodeStream::map();
+  body["l"] << limit;
+  body[":>"] << encodeLinksSelector(encodeSelector("@", {}));
+  return encodeSelector("R", std::move(body)).data();
+}
 
 /**
  * @struct Test case dataset
@@ -33,6 +74,9 @@ struct DataSample {
  * @struct Test fixture for MerkleDAG service
  */
 struct CommonFeaturesTest : public testing::TestWithParam<DataSample> {
+  // Block service
+  std::shared_ptr<IpfsDatastore> blockservice_{nullptr};
+
   // MerkleDAG service
   std::shared_ptr<MerkleDagService> merkledag_service_{nullptr};
 
@@ -44,9 +88,8 @@ struct CommonFeaturesTest : public testing::TestWithParam<DataSample> {
    */
   void SetUp() override {
     std::shared_ptr<IpfsDatastore> datastore{new InMemoryDatastore{}};
-    std::shared_ptr<IpfsDatastore> blockservice{
-        new IpfsBlockService{datastore}};
-    merkledag_service_ = std::make_shared<MerkleDagServiceImpl>(blockservice);
+    blockservice_ = std::make_shared<IpfsBlockService>(datastore);
+    merkledag_service_ = std::make_shared<MerkleDagServiceImpl>(blockservice_);
     data = GetParam();
     EXPECT_OUTCOME_TRUE_1(this->saveToBlockService(data.nodes));
   }
@@ -105,6 +148,47 @@ struct CommonFeaturesTest : public testing::TestWithParam<DataSample> {
     content.push_back('}');
     return content;
   }
+
+  /**
+   * @brief Count nodes reachable from node, once per path
+   * @param node - root node
+   * @param depth - max depth of counted nodes, root has depth 1
+   * @return nodes count
+   */
+  size_t countPaths(const IPLDNode &node, size_t depth) const {
+    if (depth == 0) {
+      return 0;
+    }
+    size_t count = 1;
+    for (const auto &link : node.getLinks()) {
+      EXPECT_OUTCOME_TRUE(child,
+                          merkledag_service_->getNode(link.get().getCID()))
+      count += countPaths(*child, depth - 1);
+    }
+    return count;
+  }
+
+  /**
+   * @brief Select blocks from root node
+   * @param selector - encoded selector
+   * @param limit - handler stops selection after this count of blocks
+   * @return selected blocks
+   */
+  fc::outcome::result<std::vector<std::shared_ptr<const IPLDBlock>>> select(
+      gsl::span<const uint8_t> selector, size_t limit = SIZE_MAX) const {
+    OUTCOME_TRY(root_cid, data.nodes.front()->getCID().toBytes());
+    std::vector<std::shared_ptr<const IPLDBlock>> blocks;
+    OUTCOME_TRY(count,
+                merkledag_service_->select(
+                    root_cid,
+                    selector,
+                    [&](std::shared_ptr<const IPLDBlock> block) {
+                      blocks.push_back(std::move(block));
+                      return blocks.size() < limit;
+                    }));
+    EXPECT_EQ(count, blocks.size());
+    return blocks;
+  }
 };
 
 /**
@@ -194,6 +278,92 @@ TEST_P(CommonFeaturesTest, FetchGraphSuccess) {
   ASSERT_EQ(fetched_structure, data.graph_structure);
 }
 
+/**
+ * @given Pre-generated nodes structure and service prefetching nodes
+ * @when Fetching node and all children recursively
+ * @then Serialized node structure and reference value must be equal
+ */
+TEST_P(CommonFeaturesTest, FetchGraphPrefetch) {
+  MerkleDagServiceImpl service{blockservice_, 4};
+  const auto &root_cid = data.nodes.front()->getCID();
+  EXPECT_OUTCOME_TRUE(root_leaf, service.fetchGraph(root_cid))
+  ASSERT_EQ(getGraphStructure(*root_leaf), data.graph_structure);
+}
+
+/**
+ * @given Pre-generated nodes structure
+ * @when Fetching graph limited by depth of one
+ * @then Root leaf has all children and children have no leaves
+ */
+TEST_P(CommonFeaturesTest, FetchGraphOnDepth) {
+  const auto &root = *data.nodes.front();
+  EXPECT_OUTCOME_TRUE(root_leaf,
+                      merkledag_service_->fetchGraphOnDepth(root.getCID(), 1))
+  ASSERT_EQ(root_leaf->count(), root.getLinks().size());
+  for (const auto &name : root_leaf->getSubLeafNames()) {
+    EXPECT_OUTCOME_TRUE(leaf, root_leaf->subLeaf(name))
+    ASSERT_EQ(leaf.get().count(), 0);
+  }
+}
+
+/**
+ * @given Pre-generated nodes structure
+ * @when Walking graph depth-first and breadth-first, with and without
+ * prefetch
+ * @then Every node is walked once per path, root first, and breadth-first
+ * walk visits nodes level by level
+ */
+TEST_P(CommonFeaturesTest, WalkGraph) {
+  const auto &root = *data.nodes.front();
+  for (size_t prefetch : {0, 4}) {
+    MerkleDagServiceImpl service{blockservice_, prefetch};
+    for (auto order : {MerkleDagService::WalkOrder::DEPTH_FIRST,
+                       MerkleDagService::WalkOrder::BREADTH_FIRST}) {
+      std::vector<std::pair<CID, uint64_t>> walked;
+      EXPECT_OUTCOME_TRUE(
+          count,
+          service.walkGraph(root.getCID(),
+                            boost::none,
+                            order,
+                            [&](std::shared_ptr<const IPLDNode> node,
+                                uint64_t depth) {
+                              walked.emplace_back(node->getCID(), depth);
+                              return true;
+                            }));
+      ASSERT_EQ(count, countPaths(root, SIZE_MAX));
+      ASSERT_EQ(walked.size(), count);
+      ASSERT_EQ(walked.front().first, root.getCID());
+      ASSERT_EQ(walked.front().second, 0);
+      if (order == MerkleDagService::WalkOrder::BREADTH_FIRST) {
+        for (size_t i = 1; i < walked.size(); ++i) {
+          ASSERT_LE(walked[i - 1].second, walked[i].second);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @given Pre-generated nodes structure
+ * @when Walking graph limited by depth and handler stopping walk
+ * @then Only nodes within depth are walked and walk stops
+ */
+TEST_P(CommonFeaturesTest, WalkGraphLimits) {
+  const auto &root = *data.nodes.front();
+  auto walk = [&](boost::optional<uint64_t> depth, size_t max_count) {
+    size_t received = 0;
+    return merkledag_service_->walkGraph(
+        root.getCID(),
+        depth,
+        MerkleDagService::WalkOrder::DEPTH_FIRST,
+        [&](std::shared_ptr<const IPLDNode>, uint64_t) {
+          return ++received < max_count;
+        });
+  };
+  EXPECT_OUTCOME_EQ(walk(1, SIZE_MAX), countPaths(root, 2));
+  EXPECT_OUTCOME_EQ(walk(boost::none, 1), 1);
+}
+
 /**
  * @given Pre-generated nodes structure
  * @when Selecting nodes from DAG service
@@ -203,9 +373,9 @@ TEST_P(CommonFeaturesTest, FetchGraphSuccess) {
 TEST_P(CommonFeaturesTest, GraphSyncSelect) {
   const size_t nodes_count = data.nodes.front()->getLinks().size() + 1;
   EXPECT_OUTCOME_TRUE(root_cid, data.nodes.front()->getCID().toBytes());
-  std::vector<std::shared_ptr<const IPLDNode>> selected_nodes;
-  std::function<bool(std::shared_ptr<const IPLDNode>)> handler =
-      [&selected_nodes](std::shared_ptr<const IPLDNode> node) -> bool {
+  std::vector<std::shared_ptr<const IPLDBlock>> selected_nodes;
+  std::function<bool(std::shared_ptr<const IPLDBlock>)> handler =
+      [&selected_nodes](std::shared_ptr<const IPLDBlock> node) -> bool {
     selected_nodes.emplace_back(std::move(node));
     return true;
   };
@@ -216,6 +386,168 @@ TEST_P(CommonFeaturesTest, GraphSyncSelect) {
   ASSERT_EQ(nodes_count, selected_count);
 }
 
+/**
+ * @given Pre-generated nodes structure
+ * @when Selecting nodes with recursive selector without limit
+ * @then Root is selected first and every node is selected once per path
+ */
+TEST_P(CommonFeaturesTest, SelectRecursive) {
+  const auto &root = *data.nodes.front();
+  auto selector = encodeRecursiveSelector(boost::none);
+  EXPECT_OUTCOME_TRUE(blocks, select(selector));
+  ASSERT_EQ(blocks.size(), countPaths(root, SIZE_MAX));
+  ASSERT_EQ(blocks.front()->getCID(), root.getCID());
+}
+
+/**
+ * @given Pre-generated nodes structure
+ * @when Selecting nodes with recursive selector limited by depth
+ * @then Only nodes within depth are selected
+ */
+TEST_P(CommonFeaturesTest, SelectRecursiveDepth) {
+  const auto &root = *data.nodes.front();
+  for (size_t depth : {1, 2}) {
+    auto selector = encodeRecursiveSelector(depth);
+    EXPECT_OUTCOME_TRUE(blocks, select(selector));
+    ASSERT_EQ(blocks.size(), countPaths(root, depth));
+  }
+}
+
+/**
+ * @given Pre-generated nodes structure selected once
+ * @when Nodes are removed from block service and selected again
+ * @then Nodes are served from cache of recently read blocks
+ */
+TEST_P(CommonFeaturesTest, SelectCachesBlocks) {
+  auto selector = encodeRecursiveSelector(boost::none);
+  EXPECT_OUTCOME_TRUE(blocks, select(selector));
+  for (const auto &node : data.nodes) {
+    EXPECT_OUTCOME_TRUE_1(blockservice_->remove(node->getCID()));
+  }
+  EXPECT_OUTCOME_TRUE(cached, select(selector));
+  ASSERT_EQ(cached.size(), blocks.size());
+}
+
+/**
+ * @given Pre-generated nodes structure
+ * @when Handler returns false on first block
+ * @then Selection stops after root
+ */
+TEST_P(CommonFeaturesTest, SelectStops) {
+  auto selector = encodeRecursiveSelector(boost::none);
+  EXPECT_OUTCOME_TRUE(blocks, select(selector, 1));
+  ASSERT_EQ(blocks.size(), 1);
+}
+
+/**
+ * @given DAG-CBOR block linking DAG-PB root
+ * @when Selecting list item of block and then links of root
+ * @then Block, root and its direct children are selected
+ */
+TEST_P(CommonFeaturesTest, SelectCborIndex) {
+  const auto &root = *data.nodes.front();
+  std::vector<CID> list{root.getCID()};
+  EXPECT_OUTCOME_TRUE(cbor_cid, blockservice_->setCbor(list));
+  EXPECT_OUTCOME_TRUE(cbor_cid_bytes, cbor_cid.toBytes());
+
+  auto body = CborEncodeStream::map();
+  body["i"] << 0;
+  body[">"] << encodeLinksSelector(encodeSelector(".", {}));
+  auto selector = encodeSelector("i", std::move(body)).data();
+
+  std::vector<CID> selected;
+  EXPECT_OUTCOME_TRUE(count,
+                      merkledag_service_->select(
+                          cbor_cid_bytes,
+                          selector,
+                          [&](std::shared_ptr<const IPLDBlock> block) {
+                            selected.push_back(block->getCID());
+                            return true;
+                          }));
+  ASSERT_EQ(count, root.getLinks().size() + 2);
+  ASSERT_EQ(selected[0], cbor_cid);
+  ASSERT_EQ(selected[1], root.getCID());
+}
+
+/**
+ * @given DAG-CBOR map with keys of different lengths
+ * @when Selecting all map values
+ * @then Values are selected in canonical key order, shorter keys first
+ */
+TEST_P(CommonFeaturesTest, SelectCborMapOrder) {
+  std::vector<CID> cids;
+  for (uint64_t i : {1, 2, 3}) {
+    EXPECT_OUTCOME_TRUE(cid, blockservice_->setCbor(i));
+    cids.push_back(cid);
+  }
+  auto map = CborEncodeStream::map();
+  map["bb"] << cids[0];
+  map["a"] << cids[1];
+  map["c"] << cids[2];
+  CborEncodeStream encoder;
+  encoder << map;
+  fc::common::Buffer bytes{encoder.data()};
+  EXPECT_OUTCOME_TRUE(map_cid, fc::common::getCidOf(bytes));
+  EXPECT_OUTCOME_TRUE_1(blockservice_->set(map_cid, bytes));
+  EXPECT_OUTCOME_TRUE(map_cid_bytes, map_cid.toBytes());
+
+  auto body = CborEncodeStream::map();
+  body[">"] << encodeSelector(".", {});
+  auto selector = encodeSelector("a", std::move(body)).data();
+
+  std::vector<CID> selected;
+  EXPECT_OUTCOME_TRUE_1(merkledag_service_->select(
+      map_cid_bytes, selector, [&](std::shared_ptr<const IPLDBlock> block) {
+        selected.push_back(block->getCID());
+        return true;
+      }));
+  std::vector<CID> expected{map_cid, cids[1], cids[2], cids[0]};
+  ASSERT_EQ(selected, expected);
+}
+
+/**
+ * @given Chain of DAG-CBOR blocks deeper than call stack would allow
+ * @when Selecting chain recursively
+ * @then Every block is selected
+ */
+TEST_P(CommonFeaturesTest, SelectDeepChain) {
+  constexpr size_t kLength = 100000;
+  EXPECT_OUTCOME_TRUE(head, blockservice_->setCbor(std::vector<CID>{}));
+  for (size_t i = 1; i < kLength; ++i) {
+    EXPECT_OUTCOME_TRUE(cid, blockservice_->setCbor(std::vector<CID>{head}));
+    head = cid;
+  }
+  EXPECT_OUTCOME_TRUE(head_bytes, head.toBytes());
+
+  auto limit = CborEncodeStream::map();
+  limit["none"] << CborEncodeStream::map();
+  auto all = CborEncodeStream::map();
+  all[">"] << encodeSelector("@", {});
+  auto body = CborEncodeStream::map();
+  body["l"] << limit;
+  body[":>"] << encodeSelector("a", std::move(all));
+  auto selector = encodeSelector("R", std::move(body)).data();
+
+  EXPECT_OUTCOME_TRUE(
+      count,
+      merkledag_service_->select(
+          head_bytes, selector, [](std::shared_ptr<const IPLDBlock>) {
+            return true;
+          }));
+  ASSERT_EQ(count, kLength);
+}
+
+/**
+ * @given Recursion edge outside of recursion
+ * @when Selecting nodes
+ * @then Selector is rejected
+ */
+TEST_P(CommonFeaturesTest, SelectInvalidSelector) {
+  auto selector = encodeSelector("@", {}).data();
+  EXPECT_OUTCOME_FALSE(error, select(selector));
+  ASSERT_EQ(error, SelectorError::EDGE_OUTSIDE_RECURSION);
+}
+
 /**
  * Pre-generated nodes, CIDs and serialized graph structures
  * Reference CIDs was generated by https://github.com/ipfs/go-merkledag
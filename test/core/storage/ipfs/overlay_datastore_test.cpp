@@ -0,0 +1,60 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "storage/ipfs/impl/overlay_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::CID;
+using fc::common::Buffer;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::storage::ipfs::IpfsDatastore;
+using fc::storage::ipfs::IpfsDatastoreError;
+using fc::storage::ipfs::OverlayDatastore;
+
+class OverlayDatastoreTest : public ::testing::Test {
+ public:
+  CID cid1{"010001020001"_cid};
+  CID cid2{"010001020002"_cid};
+  Buffer value1{"0123"_unhex};
+  Buffer value2{"4567"_unhex};
+
+  std::shared_ptr<IpfsDatastore> base{std::make_shared<InMemoryDatastore>()};
+  std::shared_ptr<IpfsDatastore> overlay{
+      std::make_shared<InMemoryDatastore>()};
+  std::shared_ptr<IpfsDatastore> datastore{
+      std::make_shared<OverlayDatastore>(base, overlay)};
+};
+
+/**
+ * @given base datastore with value
+ * @when get value through overlay
+ * @then value of base datastore is returned
+ */
+TEST_F(OverlayDatastoreTest, ReadsFallThrough) {
+  EXPECT_OUTCOME_TRUE_1(base->set(cid1, value1));
+  EXPECT_OUTCOME_EQ(datastore->contains(cid1), true);
+  EXPECT_OUTCOME_EQ(datastore->get(cid1), value1);
+  EXPECT_OUTCOME_EQ(datastore->contains(cid2), false);
+  EXPECT_OUTCOME_ERROR(IpfsDatastoreError::NOT_FOUND, datastore->get(cid2));
+}
+
+/**
+ * @given overlay datastore
+ * @when value is set and removed through overlay
+ * @then base datastore is not modified
+ */
+TEST_F(OverlayDatastoreTest, WritesDoNotReachBase) {
+  EXPECT_OUTCOME_TRUE_1(base->set(cid1, value1));
+  EXPECT_OUTCOME_TRUE_1(datastore->set(cid2, value2));
+  EXPECT_OUTCOME_EQ(datastore->get(cid2), value2);
+  EXPECT_OUTCOME_EQ(base->contains(cid2), false);
+
+  EXPECT_OUTCOME_TRUE_1(datastore->remove(cid1));
+  EXPECT_OUTCOME_EQ(base->get(cid1), value1);
+}
@@ -0,0 +1,100 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include "storage/ipld/impl/ipld_node_impl.hpp"
+#include "storage/ipld/impl/ipld_node_reader_pb.hpp"
+#include "storage/ipld/impl/ipld_node_writer_pb.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::common::Buffer;
+using fc::storage::ipld::IPLDNode;
+using fc::storage::ipld::IPLDNodeError;
+using fc::storage::ipld::IPLDNodeImpl;
+using fc::storage::ipld::PBLinkView;
+using fc::storage::ipld::PBNodeReader;
+using fc::storage::ipld::PBNodeWriter;
+
+/**
+ * @given link and content
+ * @when node is written
+ * @then canonical encoding is produced: link with all fields, then content
+ */
+TEST(IPLDNodePBTest, WriteCanonical) {
+  PBNodeWriter writer;
+  writer.addLink("0102"_unhex, "a", 3);
+  auto content = "78"_unhex;
+  ASSERT_EQ(Buffer{writer.finish(content)},
+            "12090a02010212016118030a0178"_unhex);
+  ASSERT_TRUE(writer.finish({}).empty());
+}
+
+/**
+ * @given encoded node with links around content and unknown field
+ * @when node is read
+ * @then content and links are read in encoding order, unknown field is
+ * skipped
+ */
+TEST(IPLDNodePBTest, ReadLinks) {
+  auto bytes = "12090a0201021201611803"
+               "0a0178"
+               "2805"
+               "12050a01041801"_unhex;
+  EXPECT_OUTCOME_TRUE(reader, PBNodeReader::read(bytes));
+  ASSERT_EQ(Buffer{reader.content()}, "78"_unhex);
+  ASSERT_EQ(reader.linksCount(), 2);
+  std::vector<PBLinkView> links{reader.begin(), reader.end()};
+  ASSERT_EQ(links.size(), 2);
+  ASSERT_EQ(Buffer{links[0].cid}, "0102"_unhex);
+  ASSERT_EQ(links[0].name, "a");
+  ASSERT_EQ(links[0].size, 3);
+  ASSERT_EQ(Buffer{links[1].cid}, "04"_unhex);
+  ASSERT_EQ(links[1].name, "");
+  ASSERT_EQ(links[1].size, 1);
+}
+
+/**
+ * @given truncated node and nodes with fields of wrong wire type
+ * @when nodes are read
+ * @then reading fails
+ */
+TEST(IPLDNodePBTest, ReadInvalid) {
+  for (auto bytes : {"12090a020102"_unhex, "0801"_unhex, "12020801"_unhex}) {
+    EXPECT_OUTCOME_ERROR(IPLDNodeError::INVALID_RAW_DATA,
+                         PBNodeReader::read(bytes));
+  }
+}
+
+/**
+ * @given node with content and children
+ * @when node is encoded and decoded
+ * @then decoded node has same links and encoding
+ */
+TEST(IPLDNodePBTest, NodeRoundTrip) {
+  auto node = IPLDNodeImpl::createFromString("root");
+  EXPECT_OUTCOME_TRUE_1(
+      node->addChild("b", IPLDNodeImpl::createFromString("child b")));
+  EXPECT_OUTCOME_TRUE_1(
+      node->addChild("a", IPLDNodeImpl::createFromString("child a")));
+  const auto &bytes = node->getRawBytes();
+
+  EXPECT_OUTCOME_TRUE(reader, PBNodeReader::read(bytes));
+  std::vector<PBLinkView> links{reader.begin(), reader.end()};
+  ASSERT_EQ(links.size(), 2);
+  ASSERT_EQ(links[0].name, "a");
+  ASSERT_EQ(links[1].name, "b");
+  EXPECT_OUTCOME_TRUE(link, node->getLink("a"));
+  EXPECT_OUTCOME_TRUE(link_cid, link.get().getCID().toBytes());
+  ASSERT_EQ(Buffer{links[0].cid}, Buffer{link_cid});
+  ASSERT_EQ(links[0].size, link.get().getSize());
+
+  EXPECT_OUTCOME_TRUE(decoded, IPLDNodeImpl::createFromRawBytes(bytes));
+  ASSERT_EQ(decoded->content(), node->content());
+  ASSERT_EQ(decoded->getLinks().size(), 2);
+  ASSERT_EQ(decoded->getRawBytes(), bytes);
+  ASSERT_EQ(decoded->getCID(), node->getCID());
+}
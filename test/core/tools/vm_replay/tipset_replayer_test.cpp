@@ -0,0 +1,146 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "tools/vm_replay/tipset_replayer.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/amt/amt.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/mocks/storage/chain/chain_store_mock.hpp"
+#include "testutil/mocks/vm/interpreter/interpreter_mock.hpp"
+#include "testutil/outcome.hpp"
+#include "vm/indices/impl/indices_impl.hpp"
+
+using fc::CID;
+using fc::common::Buffer;
+using fc::primitives::address::Address;
+using fc::primitives::block::BlockHeader;
+using fc::primitives::block::MsgMeta;
+using fc::primitives::tipset::Tipset;
+using fc::storage::amt::Amt;
+using fc::storage::blockchain::ChainStoreMock;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::storage::ipfs::IpfsDatastore;
+using fc::tools::vm_replay::ReplayError;
+using fc::tools::vm_replay::ReplayStats;
+using fc::tools::vm_replay::TipsetReplayer;
+using fc::vm::indices::Indices;
+using fc::vm::indices::IndicesImpl;
+using fc::vm::interpreter::InterpreterMock;
+using fc::vm::interpreter::Result;
+using testing::_;
+using testing::Return;
+
+class TipsetReplayerTest : public testing::Test {
+ public:
+  void SetUp() override {
+    EXPECT_OUTCOME_TRUE(empty, Amt(store).flush());
+    MsgMeta meta{};
+    meta.bls_messages = empty;
+    meta.secpk_messages = empty;
+    EXPECT_OUTCOME_TRUE(messages, store->setCbor(meta));
+    std::vector<CID> parents;
+    for (uint64_t height = 0; height < 3; ++height) {
+      BlockHeader header{
+          Address::makeFromId(height),
+          {},
+          {},
+          parents,
+          {},
+          height,
+          roots[height],
+          "010001020001"_cid,
+          messages,
+          {},
+          {},
+          {},
+          {},
+      };
+      std::vector<BlockHeader> headers{header};
+      EXPECT_OUTCOME_TRUE(tipset, Tipset::create(headers));
+      parents = tipset.cids;
+      chain.push_back(std::move(tipset));
+    }
+    for (auto &tipset : chain) {
+      EXPECT_CALL(*chain_store, loadTipset(tipset.makeKey().value()))
+          .WillRepeatedly(Return(tipset));
+    }
+  }
+
+  std::shared_ptr<InMemoryDatastore> store{
+      std::make_shared<InMemoryDatastore>()};
+  std::vector<CID> roots{"010001020001"_cid,
+                         "010001020002"_cid,
+                         "010001020003"_cid};
+  std::vector<Tipset> chain;
+  std::shared_ptr<ChainStoreMock> chain_store{
+      std::make_shared<ChainStoreMock>()};
+  std::shared_ptr<InterpreterMock> interpreter{
+      std::make_shared<InterpreterMock>()};
+  TipsetReplayer replayer{
+      store, chain_store, interpreter, std::make_shared<IndicesImpl>()};
+};
+
+/**
+ * @given chain of three tipsets
+ * @when tipsets at heights 1 and 2 are replayed
+ * @then tipsets are executed in ascending order with indices, state root of
+ * tipset 1 is verified against its child and store traffic is counted
+ */
+TEST_F(TipsetReplayerTest, ReplaysRange) {
+  Buffer block{1, 2, 3};
+  EXPECT_CALL(*interpreter, interpret(_, chain[1], testing::NotNull()))
+      .WillOnce(testing::Invoke(
+          [&](const std::shared_ptr<IpfsDatastore> &ipld,
+              const Tipset &,
+              const std::shared_ptr<Indices> &) -> fc::outcome::result<Result> {
+            EXPECT_OUTCOME_TRUE(cid, ipld->setCbor(block));
+            EXPECT_OUTCOME_TRUE_1(ipld->get(cid));
+            return Result{roots[2], roots[0]};
+          }));
+  EXPECT_CALL(*interpreter, interpret(_, chain[2], testing::NotNull()))
+      .WillOnce(Return(Result{roots[0], roots[0]}));
+  std::vector<uint64_t> heights;
+
+  EXPECT_OUTCOME_TRUE(result,
+                      replayer.replay(chain[2], 1, 2, [&](auto &stats) {
+                        heights.push_back(stats.height);
+                      }));
+  EXPECT_EQ(heights, (std::vector<uint64_t>{1, 2}));
+  ASSERT_EQ(result.size(), 2);
+  EXPECT_EQ(result[0].state_root_matches, true);
+  EXPECT_EQ(result[0].store.blocks_written, 1);
+  EXPECT_EQ(result[0].store.blocks_read, 1);
+  EXPECT_EQ(result[1].state_root_matches, boost::none);
+  EXPECT_EQ(result[1].store.blocks_written, 0);
+}
+
+/**
+ * @given chain of three tipsets
+ * @when tipset execution produces state root different from child
+ * @then mismatch is reported
+ */
+TEST_F(TipsetReplayerTest, StateRootMismatch) {
+  EXPECT_CALL(*interpreter, interpret(_, chain[0], _))
+      .WillOnce(Return(Result{roots[2], roots[0]}));
+
+  EXPECT_OUTCOME_TRUE(result, replayer.replay(chain[2], 0, 0, {}));
+  ASSERT_EQ(result.size(), 1);
+  EXPECT_EQ(result[0].state_root_matches, false);
+}
+
+/**
+ * @given chain of three tipsets
+ * @when range above head is replayed
+ * @then EMPTY_RANGE error is returned
+ */
+TEST_F(TipsetReplayerTest, EmptyRange) {
+  EXPECT_CALL(*interpreter, interpret(_, _, _)).Times(0);
+
+  EXPECT_OUTCOME_ERROR(ReplayError::EMPTY_RANGE,
+                       replayer.replay(chain[2], 5, 6, {}));
+}
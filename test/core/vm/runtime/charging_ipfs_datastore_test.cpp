@@ -0,0 +1,95 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/mocks/vm/runtime/runtime_mock.hpp"
+#include "testutil/outcome.hpp"
+#include "vm/runtime/gas_cost.hpp"
+#include "vm/runtime/impl/charging_ipfs_datastore.hpp"
+#include "vm/runtime/runtime_error.hpp"
+
+using fc::CID;
+using fc::common::Buffer;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::vm::runtime::ChargingIpfsDatastore;
+using fc::vm::runtime::IpldStats;
+using fc::vm::runtime::kIpldGetBaseGasCost;
+using fc::vm::runtime::kIpldGetPerByteGasCost;
+using fc::vm::runtime::kIpldPutBaseGasCost;
+using fc::vm::runtime::kIpldPutPerByteGasCost;
+using fc::vm::runtime::MockRuntime;
+using fc::vm::runtime::RuntimeError;
+using testing::Return;
+
+class ChargingIpfsDatastoreTest : public ::testing::Test {
+ public:
+  CID cid{"010001020001"_cid};
+  Buffer value{"0123"_unhex};
+
+  std::shared_ptr<InMemoryDatastore> store{
+      std::make_shared<InMemoryDatastore>()};
+  MockRuntime runtime;
+  IpldStats stats;
+  ChargingIpfsDatastore datastore{store, runtime, stats};
+};
+
+/**
+ * @given charging datastore
+ * @when same value is put twice and read
+ * @then every operation is charged, value is written once, traffic is counted
+ */
+TEST_F(ChargingIpfsDatastoreTest, ChargeAndCount) {
+  EXPECT_CALL(runtime,
+              chargeGas(kIpldPutBaseGasCost + 2 * kIpldPutPerByteGasCost))
+      .Times(2)
+      .WillRepeatedly(Return(fc::outcome::success()));
+  EXPECT_CALL(runtime,
+              chargeGas(kIpldGetBaseGasCost + 2 * kIpldGetPerByteGasCost))
+      .WillOnce(Return(fc::outcome::success()));
+
+  EXPECT_OUTCOME_TRUE_1(datastore.set(cid, value));
+  EXPECT_OUTCOME_TRUE_1(datastore.set(cid, value));
+  EXPECT_OUTCOME_EQ(datastore.get(cid), value);
+
+  EXPECT_EQ(stats.blocks_written, 1);
+  EXPECT_EQ(stats.bytes_written, 2);
+  EXPECT_EQ(stats.blocks_read, 1);
+  EXPECT_EQ(stats.bytes_read, 2);
+}
+
+/**
+ * @given charging datastore and runtime out of gas
+ * @when value is put
+ * @then error is returned and value is not written
+ */
+TEST_F(ChargingIpfsDatastoreTest, NotEnoughGas) {
+  EXPECT_CALL(runtime, chargeGas(testing::_))
+      .WillOnce(Return(fc::outcome::failure(RuntimeError::NOT_ENOUGH_GAS)));
+
+  EXPECT_OUTCOME_ERROR(RuntimeError::NOT_ENOUGH_GAS, datastore.set(cid, value));
+  EXPECT_OUTCOME_EQ(store->contains(cid), false);
+}
+
+/**
+ * @given datastore without runtime
+ * @when value is put and read
+ * @then traffic is counted and nothing is charged
+ */
+TEST_F(ChargingIpfsDatastoreTest, CountOnly) {
+  EXPECT_CALL(runtime, chargeGas(testing::_)).Times(0);
+  IpldStats counted;
+  ChargingIpfsDatastore counting{store, counted};
+
+  EXPECT_OUTCOME_TRUE_1(counting.set(cid, value));
+  EXPECT_OUTCOME_EQ(counting.get(cid), value);
+
+  EXPECT_EQ(counted.blocks_written, 1);
+  EXPECT_EQ(counted.bytes_written, 2);
+  EXPECT_EQ(counted.blocks_read, 1);
+  EXPECT_EQ(counted.bytes_read, 2);
+}
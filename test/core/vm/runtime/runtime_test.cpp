@@ -23,6 +23,7 @@ using fc::crypto::randomness::ChainEpoch;
 using fc::crypto::randomness::MockRandomnessProvider;
 using fc::crypto::randomness::RandomnessProvider;
 using fc::primitives::BigInt;
+using fc::primitives::GasAmount;
 using fc::primitives::address::Address;
 using fc::storage::hamt::HamtError;
 using fc::storage::ipfs::IpfsDatastore;
@@ -40,6 +41,11 @@ using fc::vm::indices::MockIndices;
 using fc::vm::message::UnsignedMessage;
 using fc::vm::runtime::Env;
 using fc::vm::runtime::InvocationOutput;
+using fc::vm::runtime::kCommitGasCost;
+using fc::vm::runtime::kIpldGetBaseGasCost;
+using fc::vm::runtime::kIpldGetPerByteGasCost;
+using fc::vm::runtime::kIpldPutBaseGasCost;
+using fc::vm::runtime::kIpldPutPerByteGasCost;
 using fc::vm::runtime::Runtime;
 using fc::vm::runtime::RuntimeError;
 using fc::vm::runtime::RuntimeImpl;
@@ -64,8 +70,8 @@ class RuntimeTest : public ::testing::Test {
   ChainEpoch chain_epoch_{0};
   Address immediate_caller_{fc::primitives::address::TESTNET, 1};
   Address block_miner_{};
-  BigInt gas_available_{100};
-  BigInt gas_used_{0};
+  GasAmount gas_available_{1000};
+  GasAmount gas_used_{0};
 
   std::shared_ptr<Runtime> runtime_ =
       std::make_shared<RuntimeImpl>(std::make_shared<Env>(randomness_provider_,
@@ -227,3 +233,65 @@ TEST_F(RuntimeTest, Commit) {
   EXPECT_OUTCOME_TRUE_1(runtime_->commit(new_state));
   EXPECT_EQ(runtime_->getCurrentActorState(), new_state);
 }
+
+/**
+ * @given Runtime with gas available
+ * @when gas is charged over the limit or with int64 overflow
+ * @then Error NOT_ENOUGH_GAS returned
+ */
+TEST_F(RuntimeTest, ChargeGas) {
+  EXPECT_OUTCOME_TRUE_1(runtime_->chargeGas(gas_available_));
+  EXPECT_OUTCOME_ERROR(RuntimeError::NOT_ENOUGH_GAS, runtime_->chargeGas(1));
+  EXPECT_OUTCOME_ERROR(
+      RuntimeError::NOT_ENOUGH_GAS,
+      runtime_->chargeGas(std::numeric_limits<GasAmount>::max()));
+  // overflowed total is not stored
+  EXPECT_EQ(std::static_pointer_cast<RuntimeImpl>(runtime_)->gasUsed(),
+            gas_available_ + 1);
+}
+
+/**
+ * @given Message with gas limit above int64 range
+ * @when message is applied
+ * @then Error INVALID_GAS_LIMIT returned before anything is charged
+ */
+TEST_F(RuntimeTest, ApplyMessageGasLimitOutOfRange) {
+  auto env = std::make_shared<Env>(randomness_provider_,
+                                   state_tree_,
+                                   indices_,
+                                   invoker_,
+                                   chain_epoch_,
+                                   block_miner_);
+  auto message = message_;
+  message.gasLimit = BigInt{std::numeric_limits<GasAmount>::max()} + 1;
+  EXPECT_CALL(*state_tree_, get(_)).Times(0);
+  EXPECT_CALL(*state_tree_, set(_, _)).Times(0);
+
+  EXPECT_OUTCOME_ERROR(RuntimeError::INVALID_GAS_LIMIT,
+                       env->applyMessage(message));
+}
+
+/**
+ * @given Runtime with actor state cache
+ * @when state is committed, read and committed again unchanged
+ * @then state is put to store once and read from cache, gas is charged as
+ * without cache
+ */
+TEST_F(RuntimeTest, CommitStateCached) {
+  std::string state{"state"};
+  auto size =
+      static_cast<GasAmount>(fc::codec::cbor::encode(state).value().size());
+  auto put = kIpldPutBaseGasCost + size * kIpldPutPerByteGasCost;
+  auto get = kIpldGetBaseGasCost + size * kIpldGetPerByteGasCost;
+  EXPECT_CALL(*state_tree_, getStore())
+      .WillRepeatedly(testing::Return(datastore_));
+  EXPECT_CALL(*datastore_, set(_, _))
+      .WillOnce(testing::Return(fc::outcome::success()));
+  EXPECT_CALL(*datastore_, get(_)).Times(0);
+
+  EXPECT_OUTCOME_TRUE_1(runtime_->commitState(state));
+  EXPECT_OUTCOME_EQ(runtime_->getCurrentActorStateCbor<std::string>(), state);
+  EXPECT_OUTCOME_TRUE_1(runtime_->commitState(state));
+  EXPECT_EQ(std::static_pointer_cast<RuntimeImpl>(runtime_)->gasUsed(),
+            gas_used_ + 2 * put + get + 2 * kCommitGasCost);
+}
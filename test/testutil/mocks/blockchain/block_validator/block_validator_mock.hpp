@@ -16,6 +16,10 @@ namespace fc::blockchain::block_validator {
     MOCK_CONST_METHOD2(validateBlock,
                        outcome::result<void>(const BlockHeader &block,
                                              scenarios::Scenario scenario));
+    MOCK_CONST_METHOD2(validateTipset,
+                       outcome::result<void>(
+                           const std::vector<BlockHeader> &headers,
+                           scenarios::Scenario scenario));
   };
 }  // namespace fc::blockchain::block_validator
 
@@ -0,0 +1,22 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_MOCKS_BLOCKCHAIN_HEADER_FETCHER
+#define CPP_FILECOIN_MOCKS_BLOCKCHAIN_HEADER_FETCHER
+
+#include <gmock/gmock.h>
+
+#include "blockchain/header_fetcher.hpp"
+
+namespace fc::blockchain {
+  class HeaderFetcherMock : public HeaderFetcher {
+   public:
+    MOCK_METHOD2(getTipsets,
+                 outcome::result<std::vector<Tipset>>(const TipsetKey &head,
+                                                      size_t count));
+  };
+}  // namespace fc::blockchain
+
+#endif
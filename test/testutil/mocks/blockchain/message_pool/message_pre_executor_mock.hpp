@@ -0,0 +1,22 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_MOCKS_BLOCKCHAIN_MESSAGE_POOL_PRE_EXECUTOR
+#define CPP_FILECOIN_MOCKS_BLOCKCHAIN_MESSAGE_POOL_PRE_EXECUTOR
+
+#include <gmock/gmock.h>
+
+#include "blockchain/message_pool/message_pre_executor.hpp"
+
+namespace fc::blockchain::message_pool {
+  class MessagePreExecutorMock : public MessagePreExecutor {
+   public:
+    MOCK_CONST_METHOD1(
+        preExecute,
+        outcome::result<PreExecutionResult>(const UnsignedMessage &message));
+  };
+}  // namespace fc::blockchain::message_pool
+
+#endif
@@ -18,6 +18,8 @@ namespace fc::blockchain::message_pool {
     MOCK_METHOD1(remove, void(const SignedMessage &message));
 
     MOCK_CONST_METHOD1(getTopScored, std::vector<SignedMessage>(size_t n));
+
+    MOCK_METHOD1(onHeadChange, outcome::result<void>(const HeadChange &change));
   };
 }  // namespace fc::blockchain::message_pool
 
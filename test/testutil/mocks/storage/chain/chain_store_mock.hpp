@@ -0,0 +1,38 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_TEST_TESTUTIL_MOCKS_STORAGE_CHAIN_CHAIN_STORE_MOCK_HPP
+#define CPP_FILECOIN_TEST_TESTUTIL_MOCKS_STORAGE_CHAIN_CHAIN_STORE_MOCK_HPP
+
+#include <gmock/gmock.h>
+
+#include "storage/chain/chain_store.hpp"
+
+namespace fc::storage::blockchain {
+  class ChainStoreMock : public ChainStore {
+   public:
+    MOCK_METHOD1(loadTipset, outcome::result<Tipset>(const TipsetKey &key));
+
+    MOCK_METHOD2(loadTipsetByHeight,
+                 outcome::result<Tipset>(const Tipset &tipset,
+                                         uint64_t height));
+
+    MOCK_METHOD0(createRandomnessProvider,
+                 std::shared_ptr<ChainRandomnessProvider>());
+
+    MOCK_METHOD1(addBlock, outcome::result<void>(const BlockHeader &block));
+
+    MOCK_METHOD1(addTipsets,
+                 outcome::result<void>(const std::vector<Tipset> &chain));
+
+    MOCK_CONST_METHOD1(getBlock, outcome::result<BlockHeader>(const CID &cid));
+
+    MOCK_CONST_METHOD0(heaviestTipset, outcome::result<Tipset>());
+
+    MOCK_METHOD1(subscribeHeadChanges, void(HeadChangeHandler handler));
+  };
+}  // namespace fc::storage::blockchain
+
+#endif  // CPP_FILECOIN_TEST_TESTUTIL_MOCKS_STORAGE_CHAIN_CHAIN_STORE_MOCK_HPP